@@ -0,0 +1,118 @@
+#include "sctp.h"
+
+/**
+ * @file arena.c
+ * @brief A bump arena that encoders and decoders can be placed in.
+ *
+ * An arena hands out memory from one block by advancing an offset, and
+ * releases everything it handed out in one step by rewinding that offset.
+ * Unlike `allocator_reset`, this only affects objects in that arena, so
+ * encoders and decoders in different arenas, or outside any arena, are
+ * left alone. Link this file into every module that uses it.
+ */
+
+// --- Internal Constants ---
+
+/** @brief Alignment of every arena allocation. */
+#define SCTP_ARENA_ALIGN 16
+
+// --- Internal Struct Definition ---
+
+/**
+ * @brief State of an arena. Stored at the start of its own block.
+ */
+struct sctp_arena
+{
+    uint8_t *base;   ///< First usable byte, after this header.
+    size_t capacity; ///< Number of usable bytes from `base`.
+    size_t used;     ///< Offset of the next free byte.
+    void *block;     ///< The block from `malloc`, or NULL for caller memory.
+};
+
+// --- Utility Functions ---
+
+/** @brief Rounds `value` up to a multiple of `SCTP_ARENA_ALIGN`. */
+static size_t _sctp_arena_align(size_t value)
+{
+    return (value + SCTP_ARENA_ALIGN - 1) & ~(size_t)(SCTP_ARENA_ALIGN - 1);
+}
+
+/**
+ * @brief Places an arena header at the aligned start of `memory`.
+ * @return The arena, or NULL if `size` cannot hold the header.
+ */
+static sctp_arena_t *_sctp_arena_place(void *memory, size_t size, void *block)
+{
+    const uintptr_t start = (uintptr_t)memory;
+    const size_t skip = (size_t)(-start & (SCTP_ARENA_ALIGN - 1));
+    const size_t header = _sctp_arena_align(sizeof(sctp_arena_t));
+    if (size < skip + header)
+        return NULL;
+
+    sctp_arena_t *arena = (sctp_arena_t *)((uint8_t *)memory + skip);
+    arena->base = (uint8_t *)arena + header;
+    arena->capacity = size - skip - header;
+    arena->used = 0;
+    arena->block = block;
+    return arena;
+}
+
+// --- Arena API Implementation ---
+
+SCTP_EXPORT(sctp_arena_create)
+sctp_arena_t *sctp_arena_create(size_t capacity)
+{
+    const size_t overhead = SCTP_ARENA_ALIGN + _sctp_arena_align(sizeof(sctp_arena_t));
+    if (capacity > SIZE_MAX - overhead)
+        LEA_ABORT();
+    void *memory = malloc(capacity + overhead);
+    if (!memory)
+        LEA_ABORT();
+    return _sctp_arena_place(memory, capacity + overhead, memory);
+}
+
+SCTP_EXPORT(sctp_arena_from_buffer)
+sctp_arena_t *sctp_arena_from_buffer(void *memory, size_t size)
+{
+    if (!memory)
+        return NULL;
+    return _sctp_arena_place(memory, size, NULL);
+}
+
+SCTP_EXPORT(sctp_arena_alloc)
+void *sctp_arena_alloc(sctp_arena_t *arena, size_t size)
+{
+    if (!arena)
+        LEA_ABORT();
+    if (size > arena->capacity - arena->used)
+        return NULL;
+    void *ptr = arena->base + arena->used;
+    const size_t advance = _sctp_arena_align(size);
+    // The last allocation may end in the final, partial alignment unit.
+    arena->used += advance < arena->capacity - arena->used ? advance : arena->capacity - arena->used;
+    return ptr;
+}
+
+SCTP_EXPORT(sctp_arena_reset)
+void sctp_arena_reset(sctp_arena_t *arena)
+{
+    if (!arena)
+        LEA_ABORT();
+    arena->used = 0;
+}
+
+SCTP_EXPORT(sctp_arena_used)
+size_t sctp_arena_used(const sctp_arena_t *arena)
+{
+    if (!arena)
+        LEA_ABORT();
+    return arena->used;
+}
+
+SCTP_EXPORT(sctp_arena_free)
+void sctp_arena_free(sctp_arena_t *arena)
+{
+    if (!arena || !arena->block)
+        return;
+    free(arena->block);
+}
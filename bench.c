@@ -0,0 +1,324 @@
+#include "sctp.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <stdlea.h>
+
+/**
+ * @file bench.c
+ * @brief Deterministic throughput benchmarks for the SCTP encoder and decoder.
+ *
+ * Each workload is generated from a fixed seed, so every run and every
+ * runtime measures the same bytes. In the wasm build the host (bench.js)
+ * drives the exported `bench_*` functions and does the timing. The native
+ * build has its own `main` that times with `clock_gettime`. Both print one
+ * JSON object per workload and operation.
+ *
+ * `mb_per_s` is computed over the bytes an operation actually touches. The
+ * encoder writes the whole buffer, but the decoder returns vector and packed
+ * payloads as pointers into the buffer without reading them, so the decode
+ * figures count only headers, length prefixes and scalar values.
+ */
+
+// --- Workloads ---
+
+/** @brief Workload identifiers accepted by `bench_setup`. */
+enum
+{
+    BENCH_SMALL = 0,   ///< Transactions made of small fixed-width fields.
+    BENCH_VECTORS = 1, ///< A block of large vectors.
+    BENCH_LEB128 = 2,  ///< A ledger of ULEB128 and SLEB128 values.
+    BENCH_MIXED = 3,   ///< A mix of all of the above.
+    BENCH_WORKLOAD_COUNT = 4,
+};
+
+static const char *const bench_workload_names[BENCH_WORKLOAD_COUNT] = {"small", "vectors", "leb128", "mixed"};
+
+/** @brief Seed used for every workload. */
+#define BENCH_SEED 0x5C7B5EEDULL
+
+static sctp_encoder_t *g_bench_encoder = NULL;
+static sctp_decoder_t *g_bench_decoder = NULL;
+static int g_bench_workload = BENCH_SMALL;
+static size_t g_bench_fields = 0;
+static size_t g_bench_decoded_bytes = 0;
+static size_t g_bench_handled = 0;
+static uint8_t g_bench_blob[16384];
+
+/** @brief xorshift64, used to generate reproducible field values. */
+static uint64_t bench_next_random(uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+/** @brief Returns a value with a random number of significant bits. */
+static uint64_t bench_random_magnitude(uint64_t *state)
+{
+    uint64_t value = bench_next_random(state);
+    return value >> (bench_next_random(state) % 64);
+}
+
+static void bench_encode_small(sctp_encoder_t *enc, uint64_t *state, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        uint64_t r = bench_next_random(state);
+        sctp_encoder_add_uint8_to(enc, (uint8_t)r);
+        sctp_encoder_add_uint16_to(enc, (uint16_t)(r >> 8));
+        sctp_encoder_add_uint32_to(enc, (uint32_t)(r >> 16));
+        sctp_encoder_add_uint64_to(enc, r);
+        sctp_encoder_add_int32_to(enc, (int32_t)(r >> 24));
+        sctp_encoder_add_float64_to(enc, (double)(r >> 11));
+        sctp_encoder_add_short_to(enc, (uint8_t)(r & 0x0F));
+        sctp_encoder_add_vector_data_to(enc, g_bench_blob, 8);
+    }
+}
+
+static void bench_encode_vectors(sctp_encoder_t *enc, uint64_t *state, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t length = 4096 + bench_next_random(state) % (sizeof(g_bench_blob) - 4096);
+        sctp_encoder_add_vector_data_to(enc, g_bench_blob, length);
+    }
+}
+
+static void bench_encode_leb128(sctp_encoder_t *enc, uint64_t *state, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        uint64_t magnitude = bench_random_magnitude(state);
+        if (i & 1)
+            sctp_encoder_add_sleb128_to(enc, (magnitude & 1) ? -(int64_t)(magnitude >> 1) : (int64_t)(magnitude >> 1));
+        else
+            sctp_encoder_add_uleb128_to(enc, magnitude);
+    }
+}
+
+/**
+ * @brief Encodes the current workload into `enc`.
+ *
+ * Each workload is sized at roughly 1 MiB of output.
+ */
+static void bench_encode_workload(sctp_encoder_t *enc)
+{
+    uint64_t state = BENCH_SEED;
+    switch (g_bench_workload)
+    {
+    case BENCH_SMALL:
+        bench_encode_small(enc, &state, 24000);
+        break;
+    case BENCH_VECTORS:
+        bench_encode_vectors(enc, &state, 100);
+        break;
+    case BENCH_LEB128:
+        bench_encode_leb128(enc, &state, 160000);
+        break;
+    default:
+        for (int round = 0; round < 8; round++)
+        {
+            bench_encode_small(enc, &state, 1500);
+            bench_encode_vectors(enc, &state, 6);
+            bench_encode_leb128(enc, &state, 10000);
+        }
+        break;
+    }
+    sctp_encoder_add_eof_to(enc);
+}
+
+// This module provides the handlers for the callback benchmarks.
+void __sctp_data_handler(sctp_type_t type, const void *data, size_t size)
+{
+    (void)type;
+    (void)data;
+    (void)size;
+    g_bench_handled++;
+}
+
+void __sctp_data_handler_batch(const sctp_field_t *fields, size_t count)
+{
+    (void)fields;
+    g_bench_handled += count;
+}
+
+// --- Exported Benchmark Entry Points ---
+
+/**
+ * @brief Builds the buffer for a workload and prepares the decoder.
+ *
+ * The encoder and decoder of the previous workload are freed first.
+ *
+ * @param workload One of the `BENCH_*` identifiers.
+ * @return The size of the encoded workload in bytes.
+ */
+LEA_EXPORT(bench_setup)
+size_t bench_setup(int workload)
+{
+    if (workload < 0 || workload >= BENCH_WORKLOAD_COUNT)
+        LEA_ABORT();
+    sctp_decoder_free(g_bench_decoder);
+    sctp_encoder_free(g_bench_encoder);
+    g_bench_decoder = NULL;
+    g_bench_encoder = NULL;
+    allocator_reset();
+    for (size_t i = 0; i < sizeof(g_bench_blob); i++)
+        g_bench_blob[i] = (uint8_t)(i * 31 + 7);
+
+    g_bench_workload = workload;
+    g_bench_encoder = sctp_encoder_create(1 << 20);
+    sctp_encoder_set_growth(g_bench_encoder, SCTP_GROWTH_GEOMETRIC, 0);
+    bench_encode_workload(g_bench_encoder);
+
+    g_bench_decoder = sctp_decoder_from_buffer(sctp_encoder_get_data(g_bench_encoder),
+                                               sctp_encoder_get_size(g_bench_encoder));
+    g_bench_fields = 0;
+    g_bench_decoded_bytes = sctp_encoder_get_size(g_bench_encoder);
+    sctp_type_t type;
+    while ((type = sctp_decoder_next(g_bench_decoder)) != SCTP_TYPE_EOF)
+    {
+        g_bench_fields++;
+        if (type == SCTP_TYPE_VECTOR || type == SCTP_TYPE_PACKED)
+            g_bench_decoded_bytes -= g_bench_decoder->last_size;
+    }
+    return sctp_encoder_get_size(g_bench_encoder);
+}
+
+/** @brief Returns the number of fields in the current workload, excluding EOF. */
+LEA_EXPORT(bench_fields)
+size_t bench_fields(void)
+{
+    return g_bench_fields;
+}
+
+/**
+ * @brief Returns the number of bytes a decode pass reads: the workload size
+ *        minus the vector and packed payloads, which are not read.
+ */
+LEA_EXPORT(bench_decoded_bytes)
+size_t bench_decoded_bytes(void)
+{
+    return g_bench_decoded_bytes;
+}
+
+/** @brief Decodes the workload `iterations` times with `sctp_decoder_next`. */
+LEA_EXPORT(bench_decode_next)
+size_t bench_decode_next(size_t iterations)
+{
+    size_t fields = 0;
+    for (size_t i = 0; i < iterations; i++)
+    {
+        sctp_decoder_seek(g_bench_decoder, 0);
+        while (sctp_decoder_next(g_bench_decoder) != SCTP_TYPE_EOF)
+            fields++;
+    }
+    return fields;
+}
+
+/** @brief Decodes the workload `iterations` times with `sctp_decoder_run`. */
+LEA_EXPORT(bench_decode_run)
+size_t bench_decode_run(size_t iterations)
+{
+    g_bench_handled = 0;
+    for (size_t i = 0; i < iterations; i++)
+    {
+        sctp_decoder_seek(g_bench_decoder, 0);
+        sctp_decoder_run(g_bench_decoder);
+    }
+    return g_bench_handled;
+}
+
+/** @brief Decodes the workload `iterations` times with `sctp_decoder_run_batch`. */
+LEA_EXPORT(bench_decode_run_batch)
+size_t bench_decode_run_batch(size_t iterations)
+{
+    g_bench_handled = 0;
+    for (size_t i = 0; i < iterations; i++)
+    {
+        sctp_decoder_seek(g_bench_decoder, 0);
+        sctp_decoder_run_batch(g_bench_decoder);
+    }
+    return g_bench_handled;
+}
+
+/**
+ * @brief Encodes the workload `iterations` times into a reused encoder.
+ *
+ * Field values are regenerated from the seed on every iteration, so the
+ * timing includes the (small) cost of the generator.
+ */
+LEA_EXPORT(bench_encode)
+size_t bench_encode(size_t iterations)
+{
+    size_t bytes = 0;
+    for (size_t i = 0; i < iterations; i++)
+    {
+        sctp_encoder_reset(g_bench_encoder);
+        bench_encode_workload(g_bench_encoder);
+        bytes += sctp_encoder_get_size(g_bench_encoder);
+    }
+    return bytes;
+}
+
+// --- Native Driver ---
+
+#ifndef __wasm__
+#include <time.h>
+
+/** @brief Minimum measured time per operation, in seconds. */
+#define BENCH_MIN_SECONDS 0.5
+
+typedef size_t (*bench_op_t)(size_t iterations);
+
+static double bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Times an operation, doubling the iteration count until the run
+ *        takes at least `BENCH_MIN_SECONDS`, and prints one JSON line.
+ * @param processed The bytes one iteration touches, the basis of `mb_per_s`.
+ */
+static void bench_measure(const char *op, bench_op_t fn, size_t bytes, size_t processed, size_t fields)
+{
+    fn(1); // warm-up
+    size_t iterations = 1;
+    double elapsed;
+    while (1)
+    {
+        double start = bench_now();
+        fn(iterations);
+        elapsed = bench_now() - start;
+        if (elapsed >= BENCH_MIN_SECONDS)
+            break;
+        iterations *= 2;
+    }
+    printf("{\"runtime\":\"native\",\"workload\":\"%s\",\"op\":\"%s\",\"bytes\":%zu,\"processed_bytes\":%zu,"
+           "\"fields\":%zu,\"iterations\":%zu,\"seconds\":%.6f,\"mb_per_s\":%.2f,\"fields_per_s\":%.0f}\n",
+           bench_workload_names[g_bench_workload], op, bytes, processed, fields, iterations, elapsed,
+           (double)processed * (double)iterations / elapsed / 1e6, (double)fields * (double)iterations / elapsed);
+}
+
+int main(void)
+{
+    for (int workload = 0; workload < BENCH_WORKLOAD_COUNT; workload++)
+    {
+        size_t bytes = bench_setup(workload);
+        size_t decoded = bench_decoded_bytes();
+        size_t fields = bench_fields();
+        bench_measure("next", bench_decode_next, bytes, decoded, fields);
+        bench_measure("run", bench_decode_run, bytes, decoded, fields);
+        bench_measure("run_batch", bench_decode_run_batch, bytes, decoded, fields);
+        bench_measure("encode", bench_encode, bytes, bytes, fields);
+    }
+    return 0;
+}
+#endif
@@ -0,0 +1,90 @@
+const fs = require('fs').promises;
+
+// Workloads and operations, in the same order as bench.c.
+const WORKLOADS = ['small', 'vectors', 'leb128', 'mixed'];
+// The decode operations do not read vector and packed payloads, so their
+// throughput is computed over bench_decoded_bytes rather than the buffer size.
+const OPS = [
+    ['next', 'bench_decode_next', true],
+    ['run', 'bench_decode_run', true],
+    ['run_batch', 'bench_decode_run_batch', true],
+    ['encode', 'bench_encode', false],
+];
+const MIN_SECONDS = 0.5;
+
+function seconds(start) {
+    return Number(process.hrtime.bigint() - start) / 1e9;
+}
+
+// Doubles the iteration count until one timed call takes MIN_SECONDS.
+function measure(fn) {
+    fn(1); // warm-up, also triggers tier-up in the wasm engine
+    let iterations = 1;
+    while (true) {
+        const start = process.hrtime.bigint();
+        fn(iterations);
+        const elapsed = seconds(start);
+        if (elapsed >= MIN_SECONDS) {
+            return { iterations, elapsed };
+        }
+        iterations *= 2;
+    }
+}
+
+async function main() {
+    const wasmPath = process.argv[2];
+    if (!wasmPath) {
+        console.error('Usage: node bench.js <path/to/bench.wasm>');
+        process.exit(1);
+    }
+
+    let memory;
+    const importObject = {
+        env: {
+            __lea_log: (ptr) => {
+                if (!memory) return;
+                const mem = new Uint8Array(memory.buffer);
+                const end = mem.indexOf(0, ptr);
+                console.error(new TextDecoder('utf-8').decode(mem.subarray(ptr, end)));
+            },
+            __lea_log2: (ptr, len) => {
+                if (!memory) return;
+                const mem = new Uint8Array(memory.buffer, ptr, Number(len));
+                process.stderr.write(new TextDecoder('utf-8').decode(mem));
+            },
+        },
+    };
+
+    const wasmBytes = await fs.readFile(wasmPath);
+    const { instance } = await WebAssembly.instantiate(wasmBytes, importObject);
+    memory = instance.exports.memory;
+    const exports = instance.exports;
+
+    for (let workload = 0; workload < WORKLOADS.length; workload++) {
+        const bytes = Number(exports.bench_setup(workload));
+        const decodedBytes = Number(exports.bench_decoded_bytes());
+        const fields = Number(exports.bench_fields());
+        for (const [op, name, decodes] of OPS) {
+            const processed = decodes ? decodedBytes : bytes;
+            const { iterations, elapsed } = measure(exports[name]);
+            // One JSON object per line, matching the native driver in bench.c.
+            console.log(JSON.stringify({
+                runtime: 'wasm-node',
+                workload: WORKLOADS[workload],
+                op,
+                bytes,
+                processed_bytes: processed,
+                fields,
+                iterations,
+                seconds: Number(elapsed.toFixed(6)),
+                mb_per_s: Number((processed * iterations / elapsed / 1e6).toFixed(2)),
+                fields_per_s: Math.round(fields * iterations / elapsed),
+            }));
+        }
+    }
+}
+
+main().catch(e => {
+    console.error(e);
+    process.exit(1);
+});
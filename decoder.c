@@ -18,6 +18,33 @@
 #define SCTP_META_MASK 0xF0
 #define SCTP_META_SHIFT 4
 #define SCTP_VECTOR_LARGE_FLAG 0x0F
+#define SCTP_LEB128_MAX_BYTES 10
+#define SCTP_STREAM_MIN_CARRY 64
+/** @brief Header byte of a vector back-reference: PACKED with element type VECTOR. */
+#define SCTP_VECTOR_REF_HEADER ((SCTP_TYPE_VECTOR << SCTP_META_SHIFT) | SCTP_TYPE_PACKED)
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define SCTP_BIG_ENDIAN 1
+#endif
+
+/**
+ * @brief Payload width in bytes of each fixed-width type, by type identifier.
+ *
+ * Zero marks types whose payload is variable-length or embedded in the
+ * header (LEB128, SHORT, VECTOR, PACKED and EOF). The fixed-width types are
+ * also the valid element types of a packed array.
+ */
+static const uint8_t sctp_fixed_width[16] = {
+    1, 1, 2, 2, 4, 4, 8, 8, 0, 0, 4, 8, 0, 0, 0, 0,
+};
+
+/**
+ * @brief Mask selecting the payload bytes of an 8-byte load, by type identifier.
+ */
+static const uint64_t sctp_fixed_mask[16] = {
+    0xFFULL, 0xFFULL, 0xFFFFULL, 0xFFFFULL, 0xFFFFFFFFULL, 0xFFFFFFFFULL, ~0ULL, ~0ULL,
+    0, 0, 0xFFFFFFFFULL, ~0ULL, 0, 0, 0, 0,
+};
 
 // --- LEB128 Decoding ---
 
@@ -41,32 +68,121 @@ static int _sctp_decoder_read_byte(sctp_decoder_t *dec, uint8_t *byte)
  * @brief Reads a block of raw data from the decoder's stream.
  *
  * If the requested read would go past the end of the buffer, this function
- * will trigger an abort.
+ * will trigger an abort. The size is compared against the remaining bytes,
+ * so a hostile length cannot wrap the position, and lengths that do not fit
+ * in `size_t` are rejected as well.
  *
  * @param dec A pointer to the decoder context.
  * @param size The number of bytes to read.
  * @return A const pointer to the start of the read data within the stream.
  */
-static const void *_sctp_decoder_read_data(sctp_decoder_t *dec, size_t size)
+static const void *_sctp_decoder_read_data(sctp_decoder_t *dec, uint64_t size)
 {
-    if (dec->position + size > dec->size)
+    if (size > dec->size - dec->position)
     {
         LEA_ABORT();
         return NULL;
     }
     const void *ptr = dec->data + dec->position;
-    dec->position += size;
+    dec->position += (size_t)size;
     return ptr;
 }
 
+/**
+ * @brief Loads 8 bytes from an unaligned address as a little-endian word.
+ * @param ptr The address to load from. At least 8 bytes must be readable.
+ * @return The loaded word.
+ */
+static uint64_t _sctp_decoder_load_le64(const uint8_t *ptr)
+{
+    uint64_t word;
+    memcpy(&word, ptr, sizeof(word));
+#ifdef SCTP_BIG_ENDIAN
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+}
+
+/**
+ * @brief Packs the 7-bit payload groups of up to 8 LEB128 bytes together.
+ *
+ * The input is a little-endian word holding a complete LEB128 sequence whose
+ * bytes past the terminator have been cleared. The continuation bits are
+ * dropped and the groups are merged pairwise in three steps, which is the
+ * branch-free equivalent of the byte loop for values below 2^56.
+ *
+ * @param word The masked LEB128 bytes.
+ * @return The concatenated 7-bit groups.
+ */
+static uint64_t _sctp_decoder_leb128_compact(uint64_t word)
+{
+    word &= 0x7F7F7F7F7F7F7F7FULL;
+    word = (word & 0x007F007F007F007FULL) | ((word & 0x7F007F007F007F00ULL) >> 1);
+    word = (word & 0x00003FFF00003FFFULL) | ((word & 0x3FFF00003FFF0000ULL) >> 2);
+    word = (word & 0x000000000FFFFFFFULL) | ((word & 0x0FFFFFFF00000000ULL) >> 4);
+    return word;
+}
+
+/**
+ * @brief Locates a LEB128 terminator within the next 8 bytes of the stream.
+ *
+ * Performs a single bounds check and a single unaligned load, then finds the
+ * first byte without a continuation bit with a count-trailing-zeros.
+ *
+ * @param dec A pointer to the decoder context.
+ * @param word Receives the LEB128 bytes, with bytes past the terminator cleared.
+ * @return The length of the sequence (1-8), or 0 if fewer than 8 bytes remain
+ *         or the sequence is longer than 8 bytes.
+ */
+static unsigned _sctp_decoder_scan_leb128(const sctp_decoder_t *dec, uint64_t *word)
+{
+    if (dec->size - dec->position < sizeof(uint64_t))
+        return 0;
+    uint64_t bytes = _sctp_decoder_load_le64(dec->data + dec->position);
+    uint64_t stops = ~bytes & 0x8080808080808080ULL;
+    if (stops == 0)
+        return 0;
+    unsigned bits = (unsigned)__builtin_ctzll(stops) + 1;
+    *word = bits == 64 ? bytes : bytes & ((1ULL << bits) - 1);
+    return bits >> 3;
+}
+
+/**
+ * @brief Checks the tenth byte of a LEB128 value, which only holds bit 63.
+ *
+ * For ULEB128 the byte must be 0x00 or 0x01. For SLEB128 its upper six bits
+ * extend the sign in bit 63, so it must be 0x00 or 0x7F. A continuation bit
+ * fails both checks.
+ *
+ * @param byte The tenth byte of the value.
+ * @param is_signed True for SLEB128.
+ * @return true if the value fits in 64 bits.
+ */
+static inline bool _sctp_decoder_leb128_last_fits(uint8_t byte, bool is_signed)
+{
+    return is_signed ? (byte == 0x00 || byte == 0x7F) : byte <= 0x01;
+}
+
 /**
  * @brief Decodes a 64-bit unsigned integer from the stream using ULEB128 format.
+ *
+ * Values of up to 8 bytes are decoded with a word-at-a-time fast path. Longer
+ * values and values near the end of the buffer use the byte loop.
+ *
  * @param dec A pointer to the decoder context.
  * @return The decoded uint64_t value.
  * @note Aborts if the stream ends unexpectedly or if an overflow occurs.
  */
 static uint64_t _sctp_decoder_read_uleb128(sctp_decoder_t *dec)
 {
+    uint64_t word;
+    unsigned length = _sctp_decoder_scan_leb128(dec, &word);
+    if (length)
+    {
+        dec->position += length;
+        return _sctp_decoder_leb128_compact(word);
+    }
+
     uint64_t result = 0;
     uint8_t shift = 0;
     uint8_t byte;
@@ -74,47 +190,323 @@ static uint64_t _sctp_decoder_read_uleb128(sctp_decoder_t *dec)
     {
         if (_sctp_decoder_read_byte(dec, &byte) != 0)
             LEA_ABORT();
+        if (shift == 63 && !_sctp_decoder_leb128_last_fits(byte, false))
+            LEA_ABORT();
         result |= (uint64_t)(byte & 0x7F) << shift;
         if ((byte & 0x80) == 0)
         {
             break;
         }
         shift += 7;
-        if (shift >= 64)
-            LEA_ABORT();
     }
     return result;
 }
 
 /**
  * @brief Decodes a 64-bit signed integer from the stream using SLEB128 format.
+ *
+ * Uses the same word-at-a-time fast path as `_sctp_decoder_read_uleb128`.
+ *
  * @param dec A pointer to the decoder context.
  * @return The decoded int64_t value.
  * @note Aborts if the stream ends unexpectedly or if an overflow occurs.
  */
 static int64_t _sctp_decoder_read_sleb128(sctp_decoder_t *dec)
 {
-    int64_t result = 0;
+    uint64_t word;
+    unsigned length = _sctp_decoder_scan_leb128(dec, &word);
+    if (length)
+    {
+        // At most 56 payload bits, so the sign can be extended with a shift pair.
+        unsigned unused = 64 - 7 * length;
+        dec->position += length;
+        return (int64_t)(_sctp_decoder_leb128_compact(word) << unused) >> unused;
+    }
+
+    // Accumulate unsigned so shifting into the sign bit is well defined.
+    uint64_t result = 0;
     uint8_t shift = 0;
     uint8_t byte;
     while (1)
     {
         if (_sctp_decoder_read_byte(dec, &byte) != 0)
             LEA_ABORT();
-        result |= (int64_t)(byte & 0x7F) << shift;
+        if (shift == 63 && !_sctp_decoder_leb128_last_fits(byte, true))
+            LEA_ABORT();
+        result |= (uint64_t)(byte & 0x7F) << shift;
         shift += 7;
         if ((byte & 0x80) == 0)
         {
             if ((shift < 64) && (byte & 0x40))
             {
-                result |= -((int64_t)1 << shift);
+                result |= ~0ULL << shift;
             }
             break;
         }
-        if (shift >= 64)
+    }
+    return (int64_t)result;
+}
+
+// --- Field Skipping ---
+
+/**
+ * @brief Advances past a LEB128 value without assembling it.
+ *
+ * Uses the same terminator scan as the readers, falling back to a byte loop
+ * near the end of the buffer or for sequences longer than 8 bytes.
+ *
+ * @param dec A pointer to the decoder context.
+ * @param is_signed True to check the value as SLEB128 rather than ULEB128.
+ * @note Aborts if the stream ends unexpectedly or the value exceeds 64 bits.
+ */
+static void _sctp_decoder_skip_leb128(sctp_decoder_t *dec, bool is_signed)
+{
+    uint64_t word;
+    unsigned length = _sctp_decoder_scan_leb128(dec, &word);
+    if (length)
+    {
+        dec->position += length;
+        return;
+    }
+
+    uint8_t shift = 0;
+    uint8_t byte;
+    do
+    {
+        if (_sctp_decoder_read_byte(dec, &byte) != 0)
+            LEA_ABORT();
+        if (shift == 63 && !_sctp_decoder_leb128_last_fits(byte, is_signed))
+            LEA_ABORT();
+        shift += 7;
+    } while (byte & 0x80);
+}
+
+/**
+ * @brief Advances past the field at the current position.
+ * @param dec A pointer to the decoder context.
+ * @return false if the decoder is at the end of the buffer or at an EOF
+ *         field, which is not consumed; true otherwise.
+ * @note Aborts on malformed input.
+ */
+static bool _sctp_decoder_skip_field(sctp_decoder_t *dec)
+{
+    if (dec->position >= dec->size)
+        return false;
+
+    const uint8_t header = dec->data[dec->position];
+    const sctp_type_t type = (sctp_type_t)(header & SCTP_TYPE_MASK);
+    const uint8_t meta = (header & SCTP_META_MASK) >> SCTP_META_SHIFT;
+    const size_t width = sctp_fixed_width[type];
+
+    if (width)
+    {
+        if (width >= dec->size - dec->position)
+            LEA_ABORT();
+        dec->position += 1 + width;
+        return true;
+    }
+
+    switch (type)
+    {
+    case SCTP_TYPE_ULEB128:
+    case SCTP_TYPE_SLEB128:
+        dec->position++;
+        _sctp_decoder_skip_leb128(dec, type == SCTP_TYPE_SLEB128);
+        break;
+    case SCTP_TYPE_SHORT:
+        dec->position++;
+        break;
+    case SCTP_TYPE_VECTOR:
+    {
+        dec->position++;
+        uint64_t length = meta;
+        if (meta == SCTP_VECTOR_LARGE_FLAG)
+            length = _sctp_decoder_read_uleb128(dec);
+        _sctp_decoder_read_data(dec, length);
+        break;
+    }
+    case SCTP_TYPE_PACKED:
+    {
+        dec->position++;
+        if (meta == SCTP_TYPE_VECTOR)
+        {
+            // A back-reference; its target is only checked when decoded.
+            _sctp_decoder_skip_leb128(dec, false);
+            break;
+        }
+        const size_t elem_width = sctp_fixed_width[meta];
+        if (!elem_width)
+            LEA_ABORT();
+        const uint64_t count = _sctp_decoder_read_uleb128(dec);
+        if (count > (dec->size - dec->position) / elem_width)
             LEA_ABORT();
+        dec->position += (size_t)count * elem_width;
+        break;
     }
-    return result;
+    case SCTP_TYPE_EOF:
+        return false;
+    default:
+        LEA_ABORT();
+    }
+    return true;
+}
+
+// --- Field Measurement ---
+
+/**
+ * @brief Measures a LEB128 value in a possibly incomplete buffer.
+ * @param ptr The first byte of the value.
+ * @param avail The number of bytes available at `ptr`.
+ * @param length Receives the length of the value, or on `SCTP_NEED_MORE` the
+ *        minimum number of bytes needed to continue.
+ * @param value Receives the decoded value.
+ * @param is_signed True to check the value as SLEB128 rather than ULEB128.
+ * @return `SCTP_OK`, `SCTP_NEED_MORE`, or `SCTP_ERR_OVERFLOW` if the value
+ *         does not fit in 64 bits.
+ */
+static int _sctp_decoder_leb128_extent(const uint8_t *ptr, size_t avail, size_t *length, uint64_t *value,
+                                       bool is_signed)
+{
+    uint64_t result = 0;
+    for (size_t i = 0; i < SCTP_LEB128_MAX_BYTES; i++)
+    {
+        if (i == avail)
+        {
+            *length = i + 1;
+            return SCTP_NEED_MORE;
+        }
+        if (i == SCTP_LEB128_MAX_BYTES - 1 && !_sctp_decoder_leb128_last_fits(ptr[i], is_signed))
+            return SCTP_ERR_OVERFLOW;
+        result |= (uint64_t)(ptr[i] & 0x7F) << (7 * i);
+        if ((ptr[i] & 0x80) == 0)
+        {
+            *length = i + 1;
+            *value = result;
+            return SCTP_OK;
+        }
+    }
+    return SCTP_ERR_OVERFLOW;
+}
+
+/**
+ * @brief Measures the field at the start of a possibly incomplete buffer.
+ *
+ * Never reads past `avail` and never aborts, so it can be used on partial
+ * input.
+ *
+ * @param ptr The header byte of the field.
+ * @param avail The number of bytes available at `ptr`.
+ * @param length Receives the total size of the field, or on `SCTP_NEED_MORE`
+ *        the minimum number of bytes needed to continue.
+ * @return `SCTP_OK`, `SCTP_NEED_MORE`, `SCTP_ERR_OVERFLOW` for overlong LEB128
+ *         values and sizes, or `SCTP_ERR_RESERVED_TYPE` for a packed array
+ *         with an invalid element type.
+ */
+static int _sctp_decoder_field_extent(const uint8_t *ptr, size_t avail, size_t *length)
+{
+    if (avail == 0)
+    {
+        *length = 1;
+        return SCTP_NEED_MORE;
+    }
+
+    sctp_type_t type = (sctp_type_t)(ptr[0] & SCTP_TYPE_MASK);
+    const uint8_t meta = (ptr[0] & SCTP_META_MASK) >> SCTP_META_SHIFT;
+    size_t width = sctp_fixed_width[type];
+    size_t prefix = 1;
+    uint64_t count = 1;
+
+    // A vector back-reference is a header and a ULEB128 distance.
+    if (ptr[0] == SCTP_VECTOR_REF_HEADER)
+        type = SCTP_TYPE_ULEB128;
+
+    if (!width)
+    {
+        switch (type)
+        {
+        case SCTP_TYPE_ULEB128:
+        case SCTP_TYPE_SLEB128:
+        {
+            uint64_t unused;
+            *length = 0;
+            int status = _sctp_decoder_leb128_extent(ptr + 1, avail - 1, length, &unused, type == SCTP_TYPE_SLEB128);
+            *length += 1;
+            return status;
+        }
+        case SCTP_TYPE_SHORT:
+        case SCTP_TYPE_EOF:
+            *length = 1;
+            return SCTP_OK;
+        case SCTP_TYPE_VECTOR:
+        case SCTP_TYPE_PACKED:
+        {
+            width = type == SCTP_TYPE_VECTOR ? 1 : sctp_fixed_width[meta];
+            if (!width)
+                return SCTP_ERR_RESERVED_TYPE;
+            if (type == SCTP_TYPE_VECTOR && meta != SCTP_VECTOR_LARGE_FLAG)
+            {
+                count = meta;
+                break;
+            }
+            size_t leb_length = 0;
+            int status = _sctp_decoder_leb128_extent(ptr + 1, avail - 1, &leb_length, &count, false);
+            prefix += leb_length;
+            if (status != SCTP_OK)
+            {
+                *length = prefix;
+                return status;
+            }
+            break;
+        }
+        default:
+            return SCTP_ERR_RESERVED_TYPE;
+        }
+    }
+
+    if (count > (SIZE_MAX - prefix) / width)
+        return SCTP_ERR_OVERFLOW;
+    *length = prefix + (size_t)count * width;
+    return *length <= avail ? SCTP_OK : SCTP_NEED_MORE;
+}
+
+/**
+ * @brief Finds the vector a back-reference points at.
+ *
+ * The target must be a complete VECTOR field (not another back-reference)
+ * that starts at or after `origin` and ends at or before `field`. Never
+ * aborts.
+ *
+ * @param origin The start of the stream.
+ * @param field The header byte of the back-reference, a complete field.
+ * @param ptr Receives the vector contents.
+ * @param size Receives the vector length.
+ * @return `SCTP_OK` or `SCTP_ERR_BAD_REFERENCE`.
+ */
+static int _sctp_decoder_resolve_ref(const uint8_t *origin, const uint8_t *field, const void **ptr, size_t *size)
+{
+    size_t leb_length;
+    uint64_t distance;
+    if (_sctp_decoder_leb128_extent(field + 1, SCTP_LEB128_MAX_BYTES, &leb_length, &distance, false) != SCTP_OK)
+        return SCTP_ERR_BAD_REFERENCE;
+    if (!origin || field < origin || distance == 0 || distance > (uint64_t)(field - origin))
+        return SCTP_ERR_BAD_REFERENCE;
+
+    const uint8_t *target = field - distance;
+    size_t length;
+    if ((target[0] & SCTP_TYPE_MASK) != SCTP_TYPE_VECTOR ||
+        _sctp_decoder_field_extent(target, (size_t)distance, &length) != SCTP_OK)
+        return SCTP_ERR_BAD_REFERENCE;
+
+    size_t prefix = 1;
+    if ((target[0] & SCTP_META_MASK) >> SCTP_META_SHIFT == SCTP_VECTOR_LARGE_FLAG)
+    {
+        uint64_t unused;
+        _sctp_decoder_leb128_extent(target + 1, length - 1, &leb_length, &unused, false);
+        prefix += leb_length;
+    }
+    *ptr = target + prefix;
+    *size = length - prefix;
+    return SCTP_OK;
 }
 
 /**
@@ -128,9 +520,93 @@ LEA_IMPORT(env, __sctp_data_handler)
 void __sctp_data_handler(sctp_type_t type, const void *data, size_t size);
 #endif
 
+/**
+ * @brief Declaration of the imported host function for batched delivery.
+ * @see sctp_decoder_run_batch
+ */
+#ifdef SCTP_CALLBACK_BATCH
+#ifndef SCTP_HANDLER_PROVIDED
+LEA_IMPORT(env, __sctp_data_handler_batch)
+#endif
+void __sctp_data_handler_batch(const sctp_field_t *fields, size_t count);
+
+/** @brief Staging area in linear memory that batched callbacks read from. */
+static sctp_field_t g_batch_ring[SCTP_CALLBACK_BATCH_SIZE];
+#endif
+
+// --- Checksum Verification ---
+//
+// A verifying decoder keeps the CRC one field behind the fields it reads:
+// the last one read may turn out to be the trailer, which is not covered by
+// its own checksum. Each field is folded in when the next one is read, while
+// its bytes are still in cache.
+
+/**
+ * @brief Advances checksum verification to the field at the current position.
+ *
+ * Folds the bytes before the previously read field into the CRC. At EOF or
+ * the end of the buffer, also checks that the previous field is a UINT32
+ * trailer holding that CRC, and ends verification if it is. Calling this
+ * twice at the same position has no further effect.
+ *
+ * @param dec A pointer to a decoder with verification on.
+ * @return `SCTP_OK`, or `SCTP_ERR_CHECKSUM` at the end of a stream without a
+ *         matching trailer.
+ */
+static int _sctp_decoder_checksum_step(sctp_decoder_t *dec)
+{
+    const bool at_end =
+        dec->position >= dec->size || (dec->data[dec->position] & SCTP_TYPE_MASK) == SCTP_TYPE_EOF;
+    if (!at_end && dec->position == dec->checksum_field)
+        return SCTP_OK;
+
+    dec->checksum = sctp_crc32c(dec->checksum, dec->data + dec->checksum_position,
+                                dec->checksum_field - dec->checksum_position);
+    dec->checksum_position = dec->checksum_field;
+    if (!at_end)
+    {
+        dec->checksum_field = dec->position;
+        return SCTP_OK;
+    }
+
+    const uint8_t *trailer = dec->data + dec->checksum_field;
+    if (dec->position - dec->checksum_field != 1 + sizeof(uint32_t) || trailer[0] != SCTP_TYPE_UINT32)
+        return SCTP_ERR_CHECKSUM;
+    uint32_t expected = (uint32_t)trailer[1] | (uint32_t)trailer[2] << 8 | (uint32_t)trailer[3] << 16 |
+                        (uint32_t)trailer[4] << 24;
+    if (expected != dec->checksum)
+        return SCTP_ERR_CHECKSUM;
+    dec->verify_checksum = false;
+    return SCTP_OK;
+}
+
 // --- Decoder Public API Implementation ---
 
-LEA_EXPORT(sctp_decoder_init)
+/**
+ * @brief Sets every member of a decoder for reading `size` bytes at `data`.
+ * @param dec The decoder storage.
+ * @param data The buffer to read.
+ * @param size The size of the buffer.
+ * @param is_external True if the buffer is not owned by the decoder.
+ */
+static void _sctp_decoder_setup(sctp_decoder_t *dec, const void *data, size_t size, bool is_external)
+{
+    dec->data = data;
+    dec->size = size;
+    dec->position = 0;
+    dec->last_type = SCTP_TYPE_EOF;
+    dec->last_size = 0;
+    memset(&dec->last_value, 0, sizeof(sctp_value_t));
+    dec->is_external_buffer = is_external;
+    dec->last_elem_type = SCTP_TYPE_EOF;
+    dec->origin = data;
+    dec->verify_checksum = false;
+    dec->checksum = 0;
+    dec->checksum_position = 0;
+    dec->checksum_field = 0;
+}
+
+SCTP_EXPORT(sctp_decoder_init)
 sctp_decoder_t *sctp_decoder_init(size_t size)
 {
     allocator_reset();
@@ -142,36 +618,51 @@ sctp_decoder_t *sctp_decoder_init(size_t size)
     if (!buffer)
         LEA_ABORT();
 
-    dec->data = buffer;
-    dec->size = size;
-    dec->position = 0;
-    dec->last_type = SCTP_TYPE_EOF;
-    dec->last_size = 0;
-    memset(&dec->last_value, 0, sizeof(sctp_value_t));
-    dec->is_external_buffer = false;
-
+    _sctp_decoder_setup(dec, buffer, size, false);
     return dec;
 }
 
-LEA_EXPORT(sctp_decoder_from_buffer)
+SCTP_EXPORT(sctp_decoder_from_buffer)
 sctp_decoder_t *sctp_decoder_from_buffer(const void *buffer, size_t size)
 {
     sctp_decoder_t *dec = malloc(sizeof(sctp_decoder_t));
     if (!dec)
         LEA_ABORT();
 
-    dec->data = buffer;
-    dec->size = size;
-    dec->position = 0;
-    dec->last_type = SCTP_TYPE_EOF;
-    dec->last_size = 0;
-    memset(&dec->last_value, 0, sizeof(sctp_value_t));
-    dec->is_external_buffer = true;
+    _sctp_decoder_setup(dec, buffer, size, true);
+    return dec;
+}
+
+SCTP_EXPORT(sctp_decoder_from_buffer_in)
+sctp_decoder_t *sctp_decoder_from_buffer_in(sctp_arena_t *arena, const void *buffer, size_t size)
+{
+    sctp_decoder_t *dec = sctp_arena_alloc(arena, sizeof(sctp_decoder_t));
+    if (!dec)
+        LEA_ABORT();
 
+    _sctp_decoder_setup(dec, buffer, size, true);
     return dec;
 }
 
-LEA_EXPORT(sctp_decoder_get_buffer)
+SCTP_EXPORT(sctp_decoder_bind)
+void sctp_decoder_bind(sctp_decoder_t *dec, const void *buffer, size_t size)
+{
+    if (!dec || (!buffer && size))
+        LEA_ABORT();
+    _sctp_decoder_setup(dec, buffer, size, true);
+}
+
+SCTP_EXPORT(sctp_decoder_free)
+void sctp_decoder_free(sctp_decoder_t *dec)
+{
+    if (!dec)
+        return;
+    if (!dec->is_external_buffer)
+        free((void *)dec->data);
+    free(dec);
+}
+
+SCTP_EXPORT(sctp_decoder_get_buffer)
 void *sctp_decoder_get_buffer(sctp_decoder_t *dec)
 {
     if (!dec || dec->is_external_buffer)
@@ -183,74 +674,175 @@ void *sctp_decoder_get_buffer(sctp_decoder_t *dec)
     return (void *)dec->data;
 }
 
-LEA_EXPORT(sctp_decoder_next)
-sctp_type_t sctp_decoder_next(sctp_decoder_t *dec)
+SCTP_EXPORT(sctp_type_width)
+size_t sctp_type_width(sctp_type_t type)
 {
-    if (!dec)
-        LEA_ABORT();
-
-    if (dec->position >= dec->size)
-    {
-        dec->last_type = SCTP_TYPE_EOF;
-        dec->last_size = 0;
-        return SCTP_TYPE_EOF;
-    }
-
-    uint8_t header;
-    if (_sctp_decoder_read_byte(dec, &header) != 0)
-    {
-        dec->last_type = SCTP_TYPE_EOF;
-        dec->last_size = 0;
-        return SCTP_TYPE_EOF; // Clean EOF
-    }
-
-    sctp_type_t type = (sctp_type_t)(header & SCTP_TYPE_MASK);
-    uint8_t meta = (header & SCTP_META_MASK) >> SCTP_META_SHIFT;
-
-    dec->last_type = type;
+    if ((unsigned)type > SCTP_TYPE_MASK)
+        return 0;
+    return sctp_fixed_width[type];
+}
 
+/**
+ * @brief Reads an integer field as a signed value or as an unsigned value.
+ *
+ * Signed types set `*negative` when the value is below zero, in which case
+ * `*bits` holds the two's complement value; otherwise `*bits` is the value.
+ */
+static int _sctp_decoder_integer(sctp_type_t type, const sctp_value_t *value, uint64_t *bits, bool *negative)
+{
+    int64_t signed_value;
     switch (type)
     {
-    case SCTP_TYPE_INT8:
-        dec->last_size = 1;
-        dec->last_value.as_int8 = *(int8_t *)_sctp_decoder_read_data(dec, 1);
-        break;
+    case SCTP_TYPE_SHORT:
+        *bits = value->as_short;
+        *negative = false;
+        return SCTP_OK;
     case SCTP_TYPE_UINT8:
-        dec->last_size = 1;
-        dec->last_value.as_uint8 = *(uint8_t *)_sctp_decoder_read_data(dec, 1);
+        *bits = value->as_uint8;
+        *negative = false;
+        return SCTP_OK;
+    case SCTP_TYPE_UINT16:
+        *bits = value->as_uint16;
+        *negative = false;
+        return SCTP_OK;
+    case SCTP_TYPE_UINT32:
+        *bits = value->as_uint32;
+        *negative = false;
+        return SCTP_OK;
+    case SCTP_TYPE_UINT64:
+    case SCTP_TYPE_ULEB128:
+        *bits = value->as_uint64;
+        *negative = false;
+        return SCTP_OK;
+    case SCTP_TYPE_INT8:
+        signed_value = value->as_int8;
         break;
     case SCTP_TYPE_INT16:
-        dec->last_size = 2;
-        dec->last_value.as_int16 = *(int16_t *)_sctp_decoder_read_data(dec, 2);
-        break;
-    case SCTP_TYPE_UINT16:
-        dec->last_size = 2;
-        dec->last_value.as_uint16 = *(uint16_t *)_sctp_decoder_read_data(dec, 2);
+        signed_value = value->as_int16;
         break;
     case SCTP_TYPE_INT32:
-        dec->last_size = 4;
-        dec->last_value.as_int32 = *(int32_t *)_sctp_decoder_read_data(dec, 4);
-        break;
-    case SCTP_TYPE_UINT32:
-        dec->last_size = 4;
-        dec->last_value.as_uint32 = *(uint32_t *)_sctp_decoder_read_data(dec, 4);
+        signed_value = value->as_int32;
         break;
     case SCTP_TYPE_INT64:
-        dec->last_size = 8;
-        dec->last_value.as_int64 = *(int64_t *)_sctp_decoder_read_data(dec, 8);
-        break;
-    case SCTP_TYPE_UINT64:
-        dec->last_size = 8;
-        dec->last_value.as_uint64 = *(uint64_t *)_sctp_decoder_read_data(dec, 8);
-        break;
-    case SCTP_TYPE_FLOAT32:
-        dec->last_size = 4;
-        dec->last_value.as_float32 = *(float *)_sctp_decoder_read_data(dec, 4);
-        break;
-    case SCTP_TYPE_FLOAT64:
-        dec->last_size = 8;
-        dec->last_value.as_float64 = *(double *)_sctp_decoder_read_data(dec, 8);
+    case SCTP_TYPE_SLEB128:
+        signed_value = value->as_int64;
         break;
+    default:
+        return SCTP_ERR_TYPE_MISMATCH;
+    }
+    *bits = (uint64_t)signed_value;
+    *negative = signed_value < 0;
+    return SCTP_OK;
+}
+
+static int _sctp_decoder_as_uint(sctp_type_t type, const sctp_value_t *value, uint64_t *out)
+{
+    uint64_t bits;
+    bool negative;
+    int status = _sctp_decoder_integer(type, value, &bits, &negative);
+    if (status != SCTP_OK)
+        return status;
+    if (negative)
+        return SCTP_ERR_OVERFLOW;
+    *out = bits;
+    return SCTP_OK;
+}
+
+static int _sctp_decoder_as_int(sctp_type_t type, const sctp_value_t *value, int64_t *out)
+{
+    uint64_t bits;
+    bool negative;
+    int status = _sctp_decoder_integer(type, value, &bits, &negative);
+    if (status != SCTP_OK)
+        return status;
+    if (!negative && bits > INT64_MAX)
+        return SCTP_ERR_OVERFLOW;
+    *out = (int64_t)bits;
+    return SCTP_OK;
+}
+
+SCTP_EXPORT(sctp_decoder_as_uint)
+int sctp_decoder_as_uint(const sctp_decoder_t *dec, uint64_t *out)
+{
+    if (!dec || !out)
+        return SCTP_ERR_INVALID_ARG;
+    return _sctp_decoder_as_uint(dec->last_type, &dec->last_value, out);
+}
+
+SCTP_EXPORT(sctp_decoder_as_int)
+int sctp_decoder_as_int(const sctp_decoder_t *dec, int64_t *out)
+{
+    if (!dec || !out)
+        return SCTP_ERR_INVALID_ARG;
+    return _sctp_decoder_as_int(dec->last_type, &dec->last_value, out);
+}
+
+SCTP_EXPORT(sctp_field_as_uint)
+int sctp_field_as_uint(const sctp_field_t *field, uint64_t *out)
+{
+    if (!field || !out)
+        return SCTP_ERR_INVALID_ARG;
+    return _sctp_decoder_as_uint(field->type, &field->value, out);
+}
+
+SCTP_EXPORT(sctp_field_as_int)
+int sctp_field_as_int(const sctp_field_t *field, int64_t *out)
+{
+    if (!field || !out)
+        return SCTP_ERR_INVALID_ARG;
+    return _sctp_decoder_as_int(field->type, &field->value, out);
+}
+
+SCTP_EXPORT(sctp_decoder_next)
+sctp_type_t sctp_decoder_next(sctp_decoder_t *dec)
+{
+    if (!dec)
+        LEA_ABORT();
+    if (dec->verify_checksum && _sctp_decoder_checksum_step(dec) != SCTP_OK)
+        LEA_ABORT();
+
+    if (dec->position >= dec->size)
+    {
+        dec->last_type = SCTP_TYPE_EOF;
+        dec->last_size = 0;
+        return SCTP_TYPE_EOF;
+    }
+
+    const size_t remaining = dec->size - dec->position;
+    const uint8_t *field = dec->data + dec->position;
+    const uint8_t header = field[0];
+    sctp_type_t type = (sctp_type_t)(header & SCTP_TYPE_MASK);
+    const size_t width = sctp_fixed_width[type];
+
+    dec->last_type = type;
+
+    // Fixed-width fast path: one bounds check for header plus payload.
+    if (width)
+    {
+        if (width >= remaining)
+            LEA_ABORT();
+#ifndef SCTP_BIG_ENDIAN
+        if (remaining > sizeof(uint64_t))
+        {
+            dec->last_value.as_uint64 = _sctp_decoder_load_le64(field + 1) & sctp_fixed_mask[type];
+        }
+        else
+#endif
+        {
+            dec->last_value.as_uint64 = 0;
+            memcpy(&dec->last_value, field + 1, width);
+        }
+        dec->last_size = width;
+        dec->position += 1 + width;
+        SCTP_STATS_DECODED(type, 1 + width, width);
+        return type;
+    }
+
+    uint8_t meta = (header & SCTP_META_MASK) >> SCTP_META_SHIFT;
+    dec->position++;
+
+    switch (type)
+    {
     case SCTP_TYPE_ULEB128:
         dec->last_value.as_uleb128 = _sctp_decoder_read_uleb128(dec);
         dec->last_size = sizeof(uint64_t);
@@ -264,27 +856,760 @@ sctp_type_t sctp_decoder_next(sctp_decoder_t *dec)
         dec->last_size = 1;
         break;
     case SCTP_TYPE_VECTOR:
+    {
+        uint64_t length = meta;
         if (meta == SCTP_VECTOR_LARGE_FLAG)
         {
-            dec->last_size = (size_t)_sctp_decoder_read_uleb128(dec);
+            length = _sctp_decoder_read_uleb128(dec);
         }
-        else
+        dec->last_value.as_ptr = _sctp_decoder_read_data(dec, length);
+        dec->last_size = (size_t)length;
+        break;
+    }
+    case SCTP_TYPE_PACKED:
+    {
+        if (meta == SCTP_TYPE_VECTOR)
         {
-            dec->last_size = meta;
+            _sctp_decoder_skip_leb128(dec, false);
+            if (_sctp_decoder_resolve_ref(dec->origin, field, &dec->last_value.as_ptr, &dec->last_size) != SCTP_OK)
+                LEA_ABORT();
+            dec->last_type = SCTP_TYPE_VECTOR;
+            SCTP_STATS_DECODED(SCTP_TYPE_PACKED, (size_t)(dec->data + dec->position - field), 0);
+            return SCTP_TYPE_VECTOR;
         }
+        const size_t elem_width = sctp_fixed_width[meta];
+        if (!elem_width)
+            LEA_ABORT();
+        const uint64_t count = _sctp_decoder_read_uleb128(dec);
+        if (count > (dec->size - dec->position) / elem_width)
+            LEA_ABORT();
+        dec->last_elem_type = (sctp_type_t)meta;
+        dec->last_size = (size_t)count * elem_width;
         dec->last_value.as_ptr = _sctp_decoder_read_data(dec, dec->last_size);
         break;
+    }
     case SCTP_TYPE_EOF:
         dec->last_size = 0;
         break;
     default:
         LEA_ABORT();
     }
+    SCTP_STATS_DECODED(type, (size_t)(dec->data + dec->position - field), dec->last_size);
     return type;
 }
 
+SCTP_EXPORT(sctp_decoder_next_batch)
+size_t sctp_decoder_next_batch(sctp_decoder_t *dec, sctp_field_t *out, size_t max)
+{
+    if (!dec || (!out && max))
+        LEA_ABORT();
+
+    size_t count = 0;
+    while (count < max)
+    {
+        sctp_type_t type = sctp_decoder_next(dec);
+        out[count].type = type;
+        out[count].size = dec->last_size;
+        out[count].value = dec->last_value;
+        out[count].elem_type = dec->last_elem_type;
+        count++;
+        if (type == SCTP_TYPE_EOF)
+            break;
+    }
+    return count;
+}
+
+SCTP_EXPORT(sctp_decoder_skip)
+size_t sctp_decoder_skip(sctp_decoder_t *dec, size_t n)
+{
+    if (!dec)
+        LEA_ABORT();
+
+    size_t skipped = 0;
+    while (skipped < n)
+    {
+        // A failed check at EOF is reported by the next sctp_decoder_next.
+        if (dec->verify_checksum)
+            (void)_sctp_decoder_checksum_step(dec);
+        if (!_sctp_decoder_skip_field(dec))
+            break;
+        skipped++;
+    }
+    return skipped;
+}
+
+SCTP_EXPORT(sctp_decoder_seek)
+int sctp_decoder_seek(sctp_decoder_t *dec, size_t position)
+{
+    if (!dec || position > dec->size)
+        return SCTP_ERR_INVALID_ARG;
+    dec->position = position;
+    dec->verify_checksum = false;
+    return SCTP_OK;
+}
+
+SCTP_EXPORT(sctp_decoder_save)
+void sctp_decoder_save(const sctp_decoder_t *dec, sctp_decoder_state_t *state)
+{
+    if (!dec || !state)
+        LEA_ABORT();
+
+    state->position = dec->position;
+    state->last_type = dec->last_type;
+    state->last_value = dec->last_value;
+    state->last_size = dec->last_size;
+    state->last_elem_type = dec->last_elem_type;
+}
+
+SCTP_EXPORT(sctp_decoder_restore)
+void sctp_decoder_restore(sctp_decoder_t *dec, const sctp_decoder_state_t *state)
+{
+    if (!dec || !state || state->position > dec->size)
+        LEA_ABORT();
+
+    dec->position = state->position;
+    dec->last_type = state->last_type;
+    dec->last_value = state->last_value;
+    dec->last_size = state->last_size;
+    dec->last_elem_type = state->last_elem_type;
+    dec->verify_checksum = false;
+}
+
+// --- Validating Decoder ---
+
+SCTP_EXPORT(sctp_decoder_set_checksum)
+void sctp_decoder_set_checksum(sctp_decoder_t *dec, bool enabled)
+{
+    if (!dec)
+        LEA_ABORT();
+    dec->verify_checksum = enabled;
+    dec->checksum = 0;
+    dec->checksum_position = dec->position;
+    dec->checksum_field = dec->position;
+}
+
+SCTP_EXPORT(sctp_decoder_try_next)
+int sctp_decoder_try_next(sctp_decoder_t *dec)
+{
+    if (!dec)
+        return SCTP_ERR_INVALID_ARG;
+
+    if (dec->position < dec->size)
+    {
+        size_t length;
+        int status = _sctp_decoder_field_extent(dec->data + dec->position, dec->size - dec->position, &length);
+        if (status == SCTP_NEED_MORE)
+            return SCTP_ERR_TRUNCATED;
+        if (status != SCTP_OK)
+            return status;
+        const uint8_t *field = dec->data + dec->position;
+        const void *unused_ptr;
+        size_t unused_size;
+        if (field[0] == SCTP_VECTOR_REF_HEADER &&
+            _sctp_decoder_resolve_ref(dec->origin, field, &unused_ptr, &unused_size) != SCTP_OK)
+            return SCTP_ERR_BAD_REFERENCE;
+    }
+    if (dec->verify_checksum)
+    {
+        int status = _sctp_decoder_checksum_step(dec);
+        if (status != SCTP_OK)
+            return status;
+    }
+
+    // The field is known to be complete and well-formed, so this cannot abort.
+    if (sctp_decoder_next(dec) == SCTP_TYPE_EOF && dec->position < dec->size)
+        return SCTP_ERR_TRAILING_DATA;
+    return SCTP_OK;
+}
+
+SCTP_EXPORT(sctp_validate)
+int sctp_validate(const void *buffer, size_t size, size_t *error_position)
+{
+    if (!buffer && size)
+        return SCTP_ERR_INVALID_ARG;
+
+    const uint8_t *data = buffer;
+    size_t position = 0;
+    int status = SCTP_OK;
+    while (position < size)
+    {
+        size_t length;
+        status = _sctp_decoder_field_extent(data + position, size - position, &length);
+        if (status == SCTP_NEED_MORE)
+            status = SCTP_ERR_TRUNCATED;
+        if (status != SCTP_OK)
+            break;
+        if (data[position] == SCTP_VECTOR_REF_HEADER)
+        {
+            const void *unused_ptr;
+            size_t unused_size;
+            status = _sctp_decoder_resolve_ref(data, data + position, &unused_ptr, &unused_size);
+            if (status != SCTP_OK)
+                break;
+        }
+        if ((data[position] & SCTP_TYPE_MASK) == SCTP_TYPE_EOF)
+        {
+            if (position + 1 < size)
+            {
+                position++;
+                status = SCTP_ERR_TRAILING_DATA;
+            }
+            break;
+        }
+        position += length;
+    }
+
+    if (status != SCTP_OK && error_position)
+        *error_position = position;
+    return status;
+}
+
+// --- Canonical Form ---
+
+/** @brief FNV-1a 64-bit offset basis. */
+#define SCTP_FNV_OFFSET 0xCBF29CE484222325ULL
+/** @brief FNV-1a 64-bit prime. */
+#define SCTP_FNV_PRIME 0x100000001B3ULL
+
+/**
+ * @brief Where the canonical form goes: a buffer, or only a hash.
+ */
+typedef struct
+{
+    uint8_t *out;    ///< Output buffer, or NULL to only count or hash.
+    size_t capacity; ///< Size of `out`.
+    size_t size;     ///< Bytes produced so far, saturating at `SIZE_MAX`.
+    bool hashing;    ///< True to fold bytes into `hash` instead of writing them.
+    uint64_t hash;   ///< FNV-1a of the bytes produced so far.
+} sctp_canonical_sink_t;
+
+/** @brief Appends bytes of the canonical form to a sink. */
+static void _sctp_decoder_canonical_put(sctp_canonical_sink_t *sink, const void *data, size_t size)
+{
+    if (sink->hashing)
+    {
+        const uint8_t *bytes = data;
+        uint64_t hash = sink->hash;
+        for (size_t i = 0; i < size; i++)
+            hash = (hash ^ bytes[i]) * SCTP_FNV_PRIME;
+        sink->hash = hash;
+        return;
+    }
+    // Once a piece does not fit, later pieces are only counted.
+    if (sink->out && sink->size <= sink->capacity && size <= sink->capacity - sink->size)
+        memcpy(sink->out + sink->size, data, size);
+    sink->size = size <= SIZE_MAX - sink->size ? sink->size + size : SIZE_MAX;
+}
+
+/**
+ * @brief Writes the minimal ULEB128 encoding of a value.
+ * @return The number of bytes written (1-10).
+ */
+static size_t _sctp_decoder_canonical_uleb128(uint8_t *out, uint64_t value)
+{
+    size_t length = 0;
+    while (value >= 0x80)
+    {
+        out[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = (uint8_t)value;
+    return length;
+}
+
+/**
+ * @brief Writes the minimal SLEB128 encoding of a value.
+ * @return The number of bytes written (1-10).
+ */
+static size_t _sctp_decoder_canonical_sleb128(uint8_t *out, int64_t value)
+{
+    size_t length = 0;
+    while (1)
+    {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        if ((value == 0 && !(byte & 0x40)) || (value == -1 && (byte & 0x40)))
+        {
+            out[length++] = byte;
+            return length;
+        }
+        out[length++] = byte | 0x80;
+    }
+}
+
+/**
+ * @brief Validates a message and produces its canonical form in a sink.
+ *
+ * Each field is read with `sctp_decoder_try_next`, which resolves
+ * back-references, and written back out with a minimal header and prefix.
+ * Payloads are passed through from the input unchanged.
+ */
+static int _sctp_decoder_canonical_walk(const void *buffer, size_t size, sctp_canonical_sink_t *sink)
+{
+    sctp_decoder_t dec;
+    _sctp_decoder_setup(&dec, buffer, size, true);
+    while (1)
+    {
+        int status = sctp_decoder_try_next(&dec);
+        if (status != SCTP_OK)
+            return status;
+
+        const sctp_type_t type = dec.last_type;
+        uint8_t prefix[1 + SCTP_LEB128_MAX_BYTES];
+        size_t length = 1;
+        const void *payload = NULL;
+        size_t payload_size = 0;
+        prefix[0] = (uint8_t)type;
+        switch (type)
+        {
+        case SCTP_TYPE_ULEB128:
+            length += _sctp_decoder_canonical_uleb128(prefix + 1, dec.last_value.as_uleb128);
+            break;
+        case SCTP_TYPE_SLEB128:
+            length += _sctp_decoder_canonical_sleb128(prefix + 1, dec.last_value.as_sleb128);
+            break;
+        case SCTP_TYPE_SHORT:
+            prefix[0] |= (uint8_t)(dec.last_value.as_short << SCTP_META_SHIFT);
+            break;
+        case SCTP_TYPE_VECTOR:
+            if (dec.last_size < SCTP_VECTOR_LARGE_FLAG)
+            {
+                prefix[0] |= (uint8_t)(dec.last_size << SCTP_META_SHIFT);
+            }
+            else
+            {
+                prefix[0] |= SCTP_VECTOR_LARGE_FLAG << SCTP_META_SHIFT;
+                length += _sctp_decoder_canonical_uleb128(prefix + 1, dec.last_size);
+            }
+            payload = dec.last_value.as_ptr;
+            payload_size = dec.last_size;
+            break;
+        case SCTP_TYPE_PACKED:
+            prefix[0] |= (uint8_t)(dec.last_elem_type << SCTP_META_SHIFT);
+            length += _sctp_decoder_canonical_uleb128(prefix + 1, dec.last_size / sctp_fixed_width[dec.last_elem_type]);
+            payload = dec.last_value.as_ptr;
+            payload_size = dec.last_size;
+            break;
+        case SCTP_TYPE_EOF:
+            break;
+        default:
+            // A fixed-width type: the payload bytes precede the position.
+            payload_size = sctp_fixed_width[type];
+            payload = dec.data + dec.position - payload_size;
+            break;
+        }
+        _sctp_decoder_canonical_put(sink, prefix, length);
+        if (payload_size)
+            _sctp_decoder_canonical_put(sink, payload, payload_size);
+        if (type == SCTP_TYPE_EOF)
+            return SCTP_OK;
+    }
+}
+
+SCTP_EXPORT(sctp_canonicalize)
+int sctp_canonicalize(const void *buffer, size_t size, void *out, size_t capacity, size_t *out_size)
+{
+    if ((!buffer && size) || !out_size)
+        return SCTP_ERR_INVALID_ARG;
+    sctp_canonical_sink_t sink = {out, capacity, 0, false, 0};
+    int status = _sctp_decoder_canonical_walk(buffer, size, &sink);
+    *out_size = sink.size;
+    if (status != SCTP_OK)
+        return status;
+    return out && sink.size > capacity ? SCTP_ERR_NO_SPACE : SCTP_OK;
+}
+
+SCTP_EXPORT(sctp_canonical_hash)
+int sctp_canonical_hash(const void *buffer, size_t size, uint64_t *hash)
+{
+    if ((!buffer && size) || !hash)
+        return SCTP_ERR_INVALID_ARG;
+    sctp_canonical_sink_t sink = {NULL, 0, 0, true, SCTP_FNV_OFFSET};
+    int status = _sctp_decoder_canonical_walk(buffer, size, &sink);
+    if (status != SCTP_OK)
+        return status;
+    *hash = sink.hash;
+    return SCTP_OK;
+}
+
+// --- Field Index ---
+
+/** @brief Number of entries the offset table starts with before growing. */
+#define SCTP_INDEX_MIN_ENTRIES 16
+
+/**
+ * @brief Reallocates an index with room for `entries` offsets.
+ *
+ * Uses malloc and copy rather than realloc, since the bump allocator cannot
+ * resize in place.
+ */
+static sctp_index_t *_sctp_decoder_index_grow(sctp_index_t *index, size_t entries)
+{
+    sctp_index_t *grown = malloc(sizeof(sctp_index_t) + entries * sizeof(uint32_t));
+    if (!grown)
+        LEA_ABORT();
+    if (index)
+    {
+        memcpy(grown, index, sizeof(sctp_index_t) + index->count * sizeof(uint32_t));
+        free(index);
+    }
+    return grown;
+}
+
+SCTP_EXPORT(sctp_index_build)
+sctp_index_t *sctp_index_build(const void *buffer, size_t size, size_t stride)
+{
+    if ((!buffer && size) || stride == 0 || stride > UINT32_MAX || size > UINT32_MAX)
+        LEA_ABORT();
+
+    sctp_decoder_t dec = {0};
+    dec.data = buffer;
+    dec.size = size;
+
+    size_t capacity = SCTP_INDEX_MIN_ENTRIES;
+    sctp_index_t *index = _sctp_decoder_index_grow(NULL, capacity);
+    index->stride = (uint32_t)stride;
+    index->count = 0;
+
+    size_t fields = 0;
+    while (1)
+    {
+        if (fields % stride == 0)
+        {
+            if (index->count == capacity)
+            {
+                capacity *= 2;
+                index = _sctp_decoder_index_grow(index, capacity);
+            }
+            index->offsets[index->count++] = (uint32_t)dec.position;
+        }
+        // Every field takes at least one byte; anything else would loop forever.
+        const size_t start = dec.position;
+        if (!_sctp_decoder_skip_field(&dec))
+            break;
+        if (dec.position <= start)
+            LEA_ABORT();
+        fields++;
+    }
+    index->fields = (uint32_t)fields;
+    return index;
+}
+
+SCTP_EXPORT(sctp_index_size)
+size_t sctp_index_size(const sctp_index_t *index)
+{
+    if (!index)
+        LEA_ABORT();
+    return sizeof(sctp_index_t) + index->count * sizeof(uint32_t);
+}
+
+SCTP_EXPORT(sctp_decoder_from_index)
+sctp_decoder_t *sctp_decoder_from_index(const void *buffer, size_t size, const sctp_index_t *index, size_t field)
+{
+    if (!index || index->stride == 0 || field > index->fields)
+        LEA_ABORT();
+    const size_t entry = field / index->stride;
+    if (entry >= index->count)
+        LEA_ABORT();
+
+    sctp_decoder_t *dec = sctp_decoder_from_buffer(buffer, size);
+    if (sctp_decoder_seek(dec, index->offsets[entry]) != SCTP_OK)
+        LEA_ABORT();
+    if (sctp_decoder_skip(dec, field % index->stride) != field % index->stride)
+        LEA_ABORT();
+    return dec;
+}
+
+// --- Batch Container ---
+
+/** @brief Reads a little-endian entry of a batch offset table. */
+static size_t _sctp_decoder_batch_table_entry(const uint8_t *table, size_t index)
+{
+    const uint8_t *entry = table + 4 * index;
+    return (size_t)entry[0] | (size_t)entry[1] << 8 | (size_t)entry[2] << 16 | (size_t)entry[3] << 24;
+}
+
+/**
+ * @brief Binds `dec` to the message whose length prefix is at `position`.
+ *
+ * The container has passed `sctp_batch_open`, so the prefix is complete.
+ *
+ * @return The offset just past the message.
+ */
+static size_t _sctp_decoder_batch_bind(const sctp_batch_reader_t *reader, size_t position, sctp_decoder_t *dec)
+{
+    size_t prefix = 0;
+    uint64_t length = 0;
+    _sctp_decoder_leb128_extent(reader->data + position, reader->size - position, &prefix, &length, false);
+    sctp_decoder_bind(dec, reader->data + position + prefix, (size_t)length);
+    return position + prefix + (size_t)length;
+}
+
+SCTP_EXPORT(sctp_batch_open)
+int sctp_batch_open(sctp_batch_reader_t *reader, const void *buffer, size_t size)
+{
+    if (!reader || (!buffer && size))
+        return SCTP_ERR_INVALID_ARG;
+
+    const uint8_t *data = buffer;
+    size_t position;
+    uint64_t header;
+    int status = _sctp_decoder_leb128_extent(data, size, &position, &header, false);
+    if (status != SCTP_OK)
+        return status == SCTP_NEED_MORE ? SCTP_ERR_TRUNCATED : status;
+    const size_t first = position;
+
+    // Every message takes at least a one-byte prefix, and every table entry four bytes.
+    const uint64_t count = header >> 1;
+    const uint8_t *table = NULL;
+    size_t end = size;
+    if (header & 1)
+    {
+        if (count > (size - position) / 5)
+            return SCTP_ERR_TRUNCATED;
+        end = size - 4 * (size_t)count;
+        table = data + end;
+    }
+    else if (count > size - position)
+    {
+        return SCTP_ERR_TRUNCATED;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (table && _sctp_decoder_batch_table_entry(table, i) != position)
+            return SCTP_ERR_BAD_FRAME;
+        size_t prefix;
+        uint64_t length;
+        status = _sctp_decoder_leb128_extent(data + position, end - position, &prefix, &length, false);
+        if (status != SCTP_OK)
+            return status == SCTP_NEED_MORE ? SCTP_ERR_TRUNCATED : status;
+        if (length > end - position - prefix)
+            return SCTP_ERR_TRUNCATED;
+        position += prefix + (size_t)length;
+    }
+    if (position != end)
+        return SCTP_ERR_TRAILING_DATA;
+
+    reader->data = data;
+    reader->size = size;
+    reader->count = (size_t)count;
+    reader->index = 0;
+    reader->position = first;
+    reader->table = table;
+    return SCTP_OK;
+}
+
+SCTP_EXPORT(sctp_batch_next)
+bool sctp_batch_next(sctp_batch_reader_t *reader, sctp_decoder_t *dec)
+{
+    if (!reader || !dec)
+        LEA_ABORT();
+    if (reader->index == reader->count)
+        return false;
+    reader->position = _sctp_decoder_batch_bind(reader, reader->position, dec);
+    reader->index++;
+    return true;
+}
+
+SCTP_EXPORT(sctp_batch_message)
+int sctp_batch_message(const sctp_batch_reader_t *reader, size_t index, sctp_decoder_t *dec)
+{
+    if (!reader || !dec || index >= reader->count)
+        return SCTP_ERR_INVALID_ARG;
+    size_t position;
+    if (reader->table)
+    {
+        position = _sctp_decoder_batch_table_entry(reader->table, index);
+    }
+    else
+    {
+        uint64_t header;
+        position = 0;
+        _sctp_decoder_leb128_extent(reader->data, reader->size, &position, &header, false);
+        for (size_t i = 0; i < index; i++)
+        {
+            size_t prefix = 0;
+            uint64_t length = 0;
+            _sctp_decoder_leb128_extent(reader->data + position, reader->size - position, &prefix, &length, false);
+            position += prefix + (size_t)length;
+        }
+    }
+    _sctp_decoder_batch_bind(reader, position, dec);
+    return SCTP_OK;
+}
+
+// --- Streaming Decoder ---
+
+/**
+ * @brief State of a streaming decoder.
+ */
+struct sctp_stream_decoder
+{
+    const uint8_t *chunk;  ///< Current input chunk, owned by the caller.
+    size_t chunk_size;     ///< Size of the current chunk.
+    size_t chunk_position; ///< Read offset in the current chunk.
+    uint8_t *carry;        ///< Partial field that crossed a chunk boundary.
+    size_t carry_size;     ///< Number of bytes in `carry`.
+    size_t carry_capacity; ///< Allocated size of `carry`.
+    bool done;             ///< True once the EOF field has been decoded.
+};
+
+/**
+ * @brief Makes room for at least `needed` bytes in the carry buffer.
+ */
+static void _sctp_decoder_carry_reserve(sctp_stream_decoder_t *sdec, size_t needed)
+{
+    if (needed <= sdec->carry_capacity)
+        return;
+    size_t capacity = sdec->carry_capacity ? sdec->carry_capacity : SCTP_STREAM_MIN_CARRY;
+    while (capacity < needed)
+        capacity = capacity > SIZE_MAX / 2 ? needed : capacity * 2;
+    uint8_t *carry = malloc(capacity);
+    if (!carry)
+        LEA_ABORT();
+    if (sdec->carry_size)
+        memcpy(carry, sdec->carry, sdec->carry_size);
+    free(sdec->carry);
+    sdec->carry = carry;
+    sdec->carry_capacity = capacity;
+}
+
+/**
+ * @brief Decodes one complete field and copies it into `out`.
+ *
+ * The field is decoded by `sctp_decoder_next`, which also records it in the
+ * statistics, so callers must not count it again.
+ *
+ * @param ptr The header byte of the field.
+ * @param length The total size of the field, as measured by `_sctp_decoder_field_extent`.
+ * @param out Receives the decoded field.
+ */
+static void _sctp_decoder_decode_field(const uint8_t *ptr, size_t length, sctp_field_t *out)
+{
+    sctp_decoder_t dec = {0};
+    dec.data = ptr;
+    dec.size = length;
+    dec.is_external_buffer = true;
+    dec.last_elem_type = SCTP_TYPE_EOF;
+
+    out->type = sctp_decoder_next(&dec);
+    out->size = dec.last_size;
+    out->value = dec.last_value;
+    out->elem_type = dec.last_elem_type;
+}
+
+SCTP_EXPORT(sctp_stream_decoder_create)
+sctp_stream_decoder_t *sctp_stream_decoder_create(void)
+{
+    sctp_stream_decoder_t *sdec = malloc(sizeof(sctp_stream_decoder_t));
+    if (!sdec)
+        LEA_ABORT();
+    memset(sdec, 0, sizeof(sctp_stream_decoder_t));
+    return sdec;
+}
+
+SCTP_EXPORT(sctp_stream_decoder_feed)
+int sctp_stream_decoder_feed(sctp_stream_decoder_t *sdec, const void *chunk, size_t size)
+{
+    if (!sdec || (!chunk && size) || sdec->chunk_position < sdec->chunk_size)
+        return SCTP_ERR_INVALID_ARG;
+    sdec->chunk = chunk;
+    sdec->chunk_size = size;
+    sdec->chunk_position = 0;
+    return SCTP_OK;
+}
+
+SCTP_EXPORT(sctp_stream_decoder_next)
+int sctp_stream_decoder_next(sctp_stream_decoder_t *sdec, sctp_field_t *out)
+{
+    if (!sdec || !out)
+        return SCTP_ERR_INVALID_ARG;
+
+    if (sdec->done)
+    {
+        memset(out, 0, sizeof(sctp_field_t));
+        out->type = SCTP_TYPE_EOF;
+        out->elem_type = SCTP_TYPE_EOF;
+        return SCTP_OK;
+    }
+
+    const uint8_t *field;
+    size_t length;
+    int status;
+
+    if (sdec->carry_size)
+    {
+        // Complete the carried field a piece at a time; the extent is only
+        // fully known once its length prefix has arrived.
+        while ((status = _sctp_decoder_field_extent(sdec->carry, sdec->carry_size, &length)) == SCTP_NEED_MORE)
+        {
+            const size_t avail = sdec->chunk_size - sdec->chunk_position;
+            if (avail == 0)
+                return SCTP_NEED_MORE;
+            size_t take = length - sdec->carry_size;
+            if (take > avail)
+                take = avail;
+            _sctp_decoder_carry_reserve(sdec, sdec->carry_size + take);
+            memcpy(sdec->carry + sdec->carry_size, sdec->chunk + sdec->chunk_position, take);
+            sdec->carry_size += take;
+            sdec->chunk_position += take;
+        }
+        if (status != SCTP_OK)
+            return status;
+        if (sdec->carry[0] == SCTP_VECTOR_REF_HEADER)
+            return SCTP_ERR_RESERVED_TYPE;
+        field = sdec->carry;
+        sdec->carry_size = 0;
+    }
+    else
+    {
+        const size_t avail = sdec->chunk_size - sdec->chunk_position;
+        if (avail == 0)
+            return SCTP_NEED_MORE;
+        field = sdec->chunk + sdec->chunk_position;
+        status = _sctp_decoder_field_extent(field, avail, &length);
+        if (status == SCTP_NEED_MORE)
+        {
+            // Keep only the partial field; it is completed from later chunks.
+            _sctp_decoder_carry_reserve(sdec, avail);
+            memcpy(sdec->carry, field, avail);
+            sdec->carry_size = avail;
+            sdec->chunk_position = sdec->chunk_size;
+            return SCTP_NEED_MORE;
+        }
+        if (status != SCTP_OK)
+            return status;
+        if (field[0] == SCTP_VECTOR_REF_HEADER)
+            return SCTP_ERR_RESERVED_TYPE;
+        sdec->chunk_position += length;
+    }
+
+    _sctp_decoder_decode_field(field, length, out);
+    if (out->type == SCTP_TYPE_EOF)
+        sdec->done = true;
+    return SCTP_OK;
+}
+
+SCTP_EXPORT(sctp_stream_decoder_buffered)
+size_t sctp_stream_decoder_buffered(const sctp_stream_decoder_t *sdec)
+{
+    if (!sdec)
+        LEA_ABORT();
+    return sdec->carry_size;
+}
+
+SCTP_EXPORT(sctp_stream_decoder_free)
+void sctp_stream_decoder_free(sctp_stream_decoder_t *sdec)
+{
+    if (!sdec)
+        return;
+    free(sdec->carry);
+    free(sdec);
+}
+
 #ifdef SCTP_CALLBACK_ENABLE
-LEA_EXPORT(sctp_decoder_run)
+SCTP_EXPORT(sctp_decoder_run)
 int sctp_decoder_run(sctp_decoder_t *dec)
 {
     if (!dec)
@@ -298,6 +1623,7 @@ int sctp_decoder_run(sctp_decoder_t *dec)
         switch (dec->last_type)
         {
         case SCTP_TYPE_VECTOR:
+        case SCTP_TYPE_PACKED:
             data_ptr = dec->last_value.as_ptr;
             break;
         case SCTP_TYPE_ULEB128:
@@ -320,3 +1646,22 @@ int sctp_decoder_run(sctp_decoder_t *dec)
 }
 #endif
 
+#ifdef SCTP_CALLBACK_BATCH
+SCTP_EXPORT(sctp_decoder_run_batch)
+int sctp_decoder_run_batch(sctp_decoder_t *dec)
+{
+    if (!dec)
+        LEA_ABORT();
+
+    // The ring is handed to the host whenever it fills, and once more with
+    // the remaining fields (ending in EOF) at the end of the stream.
+    size_t count;
+    do
+    {
+        count = sctp_decoder_next_batch(dec, g_batch_ring, SCTP_CALLBACK_BATCH_SIZE);
+        __sctp_data_handler_batch(g_batch_ring, count);
+    } while (g_batch_ring[count - 1].type != SCTP_TYPE_EOF);
+
+    return 0; // Success
+}
+#endif
@@ -9,7 +9,12 @@
  * This file contains the internal data structures and logic for serializing
  * various data types into a compact byte stream according to the SCTP format.
  * It is designed for use in WebAssembly environments and relies on a
- * pre-allocated buffer provided during initialization.
+ * pre-allocated buffer provided during initialization. An encoder can
+ * optionally be configured to grow its buffer on demand instead.
+ *
+ * Every operation is implemented against an explicit `sctp_encoder_t`
+ * instance (the `*_to` functions). The original singleton API is kept as a
+ * set of thin wrappers around a global instance.
  */
 
 // --- Internal Constants ---
@@ -19,8 +24,41 @@
 #define SCTP_META_SHIFT 4
 #define SCTP_VECTOR_LARGE_FLAG 0x0F
 
+/**
+ * @brief Payload width in bytes of each fixed-width type, by type identifier.
+ *
+ * Zero marks types that cannot be used as packed array elements.
+ */
+static const uint8_t sctp_encoder_fixed_width[16] = {
+    1, 1, 2, 2, 4, 4, 8, 8, 0, 0, 4, 8, 0, 0, 0, 0,
+};
+
+/** @brief Capacity used when a geometric-growth encoder starts out empty. */
+#define SCTP_GROWTH_MIN_CAPACITY 64
+/** @brief Increment used by `SCTP_GROWTH_CHUNKED` when no chunk size is given. */
+#define SCTP_GROWTH_DEFAULT_CHUNK 4096
+/** @brief Smallest streaming window; it must hold a header and a 10-byte LEB128. */
+#define SCTP_STREAM_MIN_WINDOW 16
+/** @brief Initial length of the segment list of an encoder with external vectors. */
+#define SCTP_SEGMENT_MIN_ENTRIES 8
+/** @brief Shortest vector the dictionary considers; shorter ones never pay for a back-reference. */
+#define SCTP_DICTIONARY_MIN_LENGTH 4
+/** @brief Largest dictionary accepted by `sctp_encoder_set_dictionary`. */
+#define SCTP_DICTIONARY_MAX_ENTRIES 65536
+
 // --- Internal Struct Definition ---
 
+/**
+ * @brief A vector remembered by an encoder's dictionary.
+ */
+typedef struct
+{
+    uint64_t hash; ///< Hash of the vector contents.
+    size_t offset; ///< Buffer offset of the vector field.
+    size_t stream; ///< Stream offset of the field, counting external payloads before it.
+    size_t length; ///< Length of the contents, or 0 for an empty slot.
+} sctp_dictionary_entry_t;
+
 /**
  * @brief Holds the state of the SCTP encoder.
  *
@@ -29,38 +67,242 @@
  */
 struct sctp_encoder
 {
-    uint8_t *buffer; ///< Pointer to the allocated memory buffer.
-    size_t capacity; ///< Total size of the buffer in bytes.
-    size_t position; ///< Current write offset in the buffer.
+    uint8_t *buffer;                     ///< Pointer to the allocated memory buffer.
+    size_t capacity;                     ///< Total size of the buffer in bytes.
+    size_t position;                     ///< Current write offset in the buffer.
+    sctp_growth_t growth;                ///< Strategy used when the buffer is full.
+    size_t growth_chunk;                 ///< Increment for `SCTP_GROWTH_CHUNKED`.
+    bool measuring;                      ///< True if bytes are only counted, not written.
+    bool streaming;                      ///< True if full windows are flushed to the host.
+    sctp_segment_t *segments;            ///< External vector payloads, in stream order.
+    size_t segment_count;                ///< Number of entries in `segments`.
+    size_t segment_capacity;             ///< Allocated length of `segments`.
+    sctp_arena_t *arena;                 ///< Arena the encoder lives in, or NULL for the heap.
+    size_t external_size;                ///< Total length of the external payloads in `segments`.
+    sctp_dictionary_entry_t *dictionary; ///< Recently written vectors, or NULL.
+    size_t dictionary_mask;              ///< Number of dictionary entries minus one.
+    bool checksum_enabled;               ///< True if written bytes are folded into `checksum`.
+    uint32_t checksum;                   ///< CRC32C of the bytes before `checksum_position`.
+    size_t checksum_position;            ///< Buffer offset up to which `checksum` is computed.
 };
 
+/** @brief The global instance used by the singleton API. */
 static sctp_encoder_t *g_encoder = NULL;
 
+/**
+ * @brief Declaration of the imported host function that receives flushed output.
+ * @see sctp_encoder_create_streaming
+ */
+#ifdef SCTP_FLUSH_ENABLE
+#ifndef SCTP_HANDLER_PROVIDED
+LEA_IMPORT(env, __sctp_flush)
+#endif
+void __sctp_flush(const void *data, size_t size);
+#endif
+
 // --- Utility Functions ---
 
+/**
+ * @brief Folds the bytes written since the last call into the checksum.
+ *
+ * Only called when the checksum is read or the output is handed out, so
+ * payloads the caller fills in through a returned pointer are covered even
+ * if later fields were added before they were filled.
+ *
+ * @param enc A pointer to an encoder with checksumming on.
+ */
+static void _sctp_encoder_checksum_update(sctp_encoder_t *enc)
+{
+    enc->checksum = sctp_crc32c(enc->checksum, enc->buffer + enc->checksum_position,
+                                enc->position - enc->checksum_position);
+    enc->checksum_position = enc->position;
+}
+
+#ifdef SCTP_FLUSH_ENABLE
+/**
+ * @brief Hands the bytes written so far to the host and empties the window.
+ * @param enc A pointer to the encoder context.
+ */
+static void _sctp_encoder_flush(sctp_encoder_t *enc)
+{
+    if (enc->checksum_enabled)
+        _sctp_encoder_checksum_update(enc);
+    if (enc->position)
+        __sctp_flush(enc->buffer, enc->position);
+    enc->position = 0;
+    enc->checksum_position = 0;
+}
+#endif
+
+/**
+ * @brief Allocates memory for an encoder, from its arena if it has one.
+ * @return The memory, or NULL if the allocation fails.
+ */
+static void *_sctp_encoder_alloc(sctp_encoder_t *enc, size_t size)
+{
+    return enc->arena ? sctp_arena_alloc(enc->arena, size) : malloc(size);
+}
+
+/** @brief Releases memory from `_sctp_encoder_alloc`. Arena memory is kept until the arena is reset. */
+static void _sctp_encoder_release(sctp_encoder_t *enc, void *ptr)
+{
+    if (!enc->arena)
+        free(ptr);
+}
+
+/**
+ * @brief Moves the encoder's data into a larger buffer.
+ *
+ * The bump allocator cannot resize in place, so the data is copied into a
+ * fresh allocation and the old buffer is released.
+ *
+ * @param enc A pointer to the encoder context.
+ * @param required The minimum capacity the new buffer must have.
+ * @return `SCTP_OK` on success, `SCTP_ERR_NO_SPACE` if growth is disabled or
+ *         the allocation fails.
+ */
+static int _sctp_encoder_grow(sctp_encoder_t *enc, size_t required)
+{
+    size_t new_capacity;
+    switch (enc->growth)
+    {
+    case SCTP_GROWTH_GEOMETRIC:
+        new_capacity = enc->capacity ? enc->capacity : SCTP_GROWTH_MIN_CAPACITY;
+        while (new_capacity < required)
+        {
+            if (new_capacity > SIZE_MAX / 2)
+            {
+                new_capacity = required;
+                break;
+            }
+            new_capacity *= 2;
+        }
+        break;
+    case SCTP_GROWTH_CHUNKED:
+    {
+        size_t missing = required - enc->capacity;
+        size_t chunks = (missing + enc->growth_chunk - 1) / enc->growth_chunk;
+        if (chunks > (SIZE_MAX - enc->capacity) / enc->growth_chunk)
+            return SCTP_ERR_NO_SPACE;
+        new_capacity = enc->capacity + chunks * enc->growth_chunk;
+        break;
+    }
+    default:
+        return SCTP_ERR_NO_SPACE;
+    }
+
+    uint8_t *buffer = _sctp_encoder_alloc(enc, new_capacity);
+    if (!buffer)
+        return SCTP_ERR_NO_SPACE;
+    if (enc->position)
+        memcpy(buffer, enc->buffer, enc->position);
+    _sctp_encoder_release(enc, enc->buffer);
+    enc->buffer = buffer;
+    enc->capacity = new_capacity;
+    SCTP_STATS_CAPACITY(new_capacity);
+    return SCTP_OK;
+}
+
 /**
  * @brief Ensures there is enough space in the buffer for additional data.
  *
- * If the requested capacity exceeds the buffer's limits, this function will
- * trigger an abort.
+ * If the encoder has a growth strategy the buffer is enlarged, and a
+ * streaming encoder flushes its window; otherwise the request fails. Nothing
+ * is written, so a failed reservation leaves the stream untouched.
  *
  * @param enc A pointer to the encoder context.
  * @param additional_bytes The number of additional bytes required.
+ * @return `SCTP_OK` on success, `SCTP_ERR_NO_SPACE` otherwise.
  */
-static void _sctp_encoder_ensure_capacity(sctp_encoder_t *enc, size_t additional_bytes)
+static int _sctp_encoder_reserve(sctp_encoder_t *enc, size_t additional_bytes)
 {
-    if (enc->position + additional_bytes > enc->capacity)
-        LEA_ABORT();
+    if (additional_bytes <= enc->capacity - enc->position)
+        return SCTP_OK;
+#ifdef SCTP_FLUSH_ENABLE
+    if (enc->streaming)
+    {
+        if (additional_bytes > enc->capacity)
+            return SCTP_ERR_NO_SPACE;
+        _sctp_encoder_flush(enc);
+        return SCTP_OK;
+    }
+#endif
+    if (additional_bytes > SIZE_MAX - enc->position)
+        return SCTP_ERR_NO_SPACE;
+    return _sctp_encoder_grow(enc, enc->position + additional_bytes);
+}
+
+/**
+ * @brief Advances a measuring encoder past a field without writing it.
+ * @param enc A pointer to the encoder context.
+ * @param size The size of the field in bytes.
+ * @return `SCTP_OK` on success, `SCTP_ERR_NO_SPACE` if the count overflows.
+ */
+static int _sctp_encoder_count(sctp_encoder_t *enc, size_t size)
+{
+    if (size > SIZE_MAX - enc->position)
+        return SCTP_ERR_NO_SPACE;
+    enc->position += size;
+    return SCTP_OK;
+}
+
+/**
+ * @brief Returns the number of bytes needed to ULEB128-encode a value.
+ * @param value The value to measure.
+ * @return The encoded length (1-10 bytes).
+ */
+static size_t _sctp_encoder_uleb128_size(uint64_t value)
+{
+    // Number of significant bits, rounded up to whole 7-bit groups.
+    return (size_t)(64 - __builtin_clzll(value | 1) + 6) / 7;
+}
+
+/**
+ * @brief Returns the number of bytes needed to SLEB128-encode a value.
+ * @param value The value to measure.
+ * @return The encoded length (1-10 bytes).
+ */
+static size_t _sctp_encoder_sleb128_size(int64_t value)
+{
+    // Fold negative values onto their magnitude and reserve one sign bit.
+    uint64_t magnitude = (uint64_t)(value ^ (value >> 63));
+    return (size_t)(64 - __builtin_clzll((magnitude << 1) | 1) + 6) / 7;
+}
+
+/**
+ * @brief Returns the size of the header and length prefix of a vector.
+ * @param length The length of the vector payload.
+ * @return The number of bytes preceding the vector payload.
+ */
+static size_t _sctp_encoder_vector_prefix_size(size_t length)
+{
+    if (length < SCTP_VECTOR_LARGE_FLAG)
+        return 1;
+    return 1 + _sctp_encoder_uleb128_size(length);
+}
+
+/**
+ * @brief Returns the size of the header and count prefix of a packed array.
+ * @param count The number of elements.
+ * @return The number of bytes preceding the packed elements.
+ */
+static size_t _sctp_encoder_packed_prefix_size(size_t count)
+{
+    return 1 + _sctp_encoder_uleb128_size(count);
 }
 
+// --- Unchecked Writers ---
+//
+// These helpers assume the caller has already reserved enough space with
+// `_sctp_encoder_reserve`, so each field only performs a single capacity check.
+
 /**
  * @brief Writes a single byte to the encoder's buffer.
  * @param enc A pointer to the encoder context.
  * @param byte The byte to write.
  */
-static void _sctp_encoder_write_byte(sctp_encoder_t *enc, uint8_t byte)
+static void _sctp_encoder_put_byte(sctp_encoder_t *enc, uint8_t byte)
 {
-    _sctp_encoder_ensure_capacity(enc, 1);
     enc->buffer[enc->position++] = byte;
 }
 
@@ -70,10 +312,10 @@ static void _sctp_encoder_write_byte(sctp_encoder_t *enc, uint8_t byte)
  * @param type The SCTP data type.
  * @param meta The 4-bit metadata value.
  */
-static void _sctp_encoder_write_header(sctp_encoder_t *enc, sctp_type_t type, uint8_t meta)
+static void _sctp_encoder_put_header(sctp_encoder_t *enc, sctp_type_t type, uint8_t meta)
 {
     uint8_t header = (uint8_t)type | (meta << SCTP_META_SHIFT);
-    _sctp_encoder_write_byte(enc, header);
+    _sctp_encoder_put_byte(enc, header);
 }
 
 /**
@@ -82,22 +324,71 @@ static void _sctp_encoder_write_header(sctp_encoder_t *enc, sctp_type_t type, ui
  * @param data A pointer to the data to write.
  * @param size The size of the data in bytes.
  */
-static void _sctp_encoder_write_data(sctp_encoder_t *enc, const void *data, size_t size)
+static void _sctp_encoder_put_data(sctp_encoder_t *enc, const void *data, size_t size)
 {
-    _sctp_encoder_ensure_capacity(enc, size);
     memcpy(enc->buffer + enc->position, data, size);
     enc->position += size;
 }
 
 // --- LEB128 Encoding ---
 
+/**
+ * @brief Spreads a value below 2^56 into 7-bit groups, one per byte.
+ *
+ * This is the inverse of the decoder's compaction step: the value is split
+ * pairwise in three steps so each byte of the result holds 7 payload bits.
+ * Continuation bits are not set.
+ *
+ * @param value The value to spread. Must be below 2^56.
+ * @return The spread groups as a little-endian word.
+ */
+static uint64_t _sctp_encoder_leb128_spread(uint64_t value)
+{
+    value = (value & 0x000000000FFFFFFFULL) | ((value << 4) & 0x0FFFFFFF00000000ULL);
+    value = (value & 0x00003FFF00003FFFULL) | ((value << 2) & 0x3FFF00003FFF0000ULL);
+    value = (value & 0x007F007F007F007FULL) | ((value << 1) & 0x7F007F007F007F00ULL);
+    return value;
+}
+
+/**
+ * @brief Writes a LEB128 sequence of up to 8 bytes with one store.
+ *
+ * When at least 8 bytes of capacity remain, a full word is stored and the
+ * position only advances by `length`; the extra bytes are scratch space that
+ * later writes overwrite. Otherwise only `length` bytes are copied.
+ *
+ * @param enc A pointer to the encoder context.
+ * @param groups The 7-bit groups of the value (see `_sctp_encoder_leb128_spread`).
+ * @param length The encoded length in bytes (1-8).
+ */
+static void _sctp_encoder_put_leb128_word(sctp_encoder_t *enc, uint64_t groups, size_t length)
+{
+    // Continuation bits on every byte except the last.
+    uint64_t word = groups | (0x8080808080808080ULL & ((1ULL << (8 * (length - 1))) - 1));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    if (enc->capacity - enc->position >= sizeof(word))
+        memcpy(enc->buffer + enc->position, &word, sizeof(word));
+    else
+        memcpy(enc->buffer + enc->position, &word, length);
+    enc->position += length;
+}
+
 /**
  * @brief Encodes a 64-bit unsigned integer using ULEB128 format.
  * @param enc A pointer to the encoder context.
  * @param value The value to encode.
  */
-static void _sctp_encoder_write_uleb128(sctp_encoder_t *enc, uint64_t value)
+static void _sctp_encoder_put_uleb128(sctp_encoder_t *enc, uint64_t value)
 {
+    size_t length = _sctp_encoder_uleb128_size(value);
+    if (length <= sizeof(uint64_t))
+    {
+        _sctp_encoder_put_leb128_word(enc, _sctp_encoder_leb128_spread(value), length);
+        return;
+    }
+
     do
     {
         uint8_t byte = value & 0x7F;
@@ -106,7 +397,7 @@ static void _sctp_encoder_write_uleb128(sctp_encoder_t *enc, uint64_t value)
         {
             byte |= 0x80;
         }
-        _sctp_encoder_write_byte(enc, byte);
+        _sctp_encoder_put_byte(enc, byte);
     } while (value != 0);
 }
 
@@ -115,8 +406,17 @@ static void _sctp_encoder_write_uleb128(sctp_encoder_t *enc, uint64_t value)
  * @param enc A pointer to the encoder context.
  * @param value The value to encode.
  */
-static void _sctp_encoder_write_sleb128(sctp_encoder_t *enc, int64_t value)
+static void _sctp_encoder_put_sleb128(sctp_encoder_t *enc, int64_t value)
 {
+    size_t length = _sctp_encoder_sleb128_size(value);
+    if (length <= sizeof(uint64_t))
+    {
+        // Truncate the two's complement value to its 7 * length payload bits.
+        uint64_t bits = (uint64_t)value & ((1ULL << (7 * length)) - 1);
+        _sctp_encoder_put_leb128_word(enc, _sctp_encoder_leb128_spread(bits), length);
+        return;
+    }
+
     bool more;
     do
     {
@@ -127,142 +427,1641 @@ static void _sctp_encoder_write_sleb128(sctp_encoder_t *enc, int64_t value)
         {
             byte |= 0x80;
         }
-        _sctp_encoder_write_byte(enc, byte);
+        _sctp_encoder_put_byte(enc, byte);
     } while (more);
 }
 
-// --- Encoder Public API Implementation ---
+// --- Field Emitters ---
+//
+// Each emitter reserves the exact size of one field and then writes it. They
+// either write the whole field or nothing, which lets the `try_add` variants
+// report an error without leaving a partial field in the stream. A measuring
+// encoder only advances its position by the size of the field.
 
-LEA_EXPORT(sctp_encoder_init)
-void sctp_encoder_init(size_t capacity)
+static int _sctp_encoder_emit_vector(sctp_encoder_t *enc, size_t length, void **out_ptr)
 {
-    allocator_reset();
-    g_encoder = malloc(sizeof(sctp_encoder_t));
-    if (!g_encoder)
-        LEA_ABORT();
+    size_t prefix = _sctp_encoder_vector_prefix_size(length);
+    if (length > SIZE_MAX - prefix)
+        return SCTP_ERR_NO_SPACE;
+    if (enc->measuring)
+    {
+        *out_ptr = NULL;
+        return _sctp_encoder_count(enc, prefix + length);
+    }
+    int status = _sctp_encoder_reserve(enc, prefix + length);
+    if (status != SCTP_OK)
+        return status;
 
-    g_encoder->buffer = malloc(capacity);
-    if (!g_encoder->buffer)
-        LEA_ABORT();
-    g_encoder->capacity = capacity;
-    g_encoder->position = 0;
+    if (length < SCTP_VECTOR_LARGE_FLAG)
+    {
+        _sctp_encoder_put_header(enc, SCTP_TYPE_VECTOR, (uint8_t)length);
+    }
+    else
+    {
+        _sctp_encoder_put_header(enc, SCTP_TYPE_VECTOR, SCTP_VECTOR_LARGE_FLAG);
+        _sctp_encoder_put_uleb128(enc, length);
+    }
+    *out_ptr = enc->buffer + enc->position;
+    enc->position += length;
+    SCTP_STATS_ENCODED(SCTP_TYPE_VECTOR, prefix + length, length);
+    return SCTP_OK;
 }
 
-LEA_EXPORT(sctp_encoder_data)
-const uint8_t *sctp_encoder_data(void)
+static int _sctp_encoder_emit_packed(sctp_encoder_t *enc, sctp_type_t elem_type, size_t count,
+                                     void **out_ptr)
 {
-    if (!g_encoder)
-        LEA_ABORT();
-    return g_encoder->buffer;
+    if ((unsigned)elem_type > SCTP_TYPE_MASK || !sctp_encoder_fixed_width[elem_type])
+        return SCTP_ERR_INVALID_ARG;
+    size_t width = sctp_encoder_fixed_width[elem_type];
+    size_t prefix = _sctp_encoder_packed_prefix_size(count);
+    if (count > (SIZE_MAX - prefix) / width)
+        return SCTP_ERR_NO_SPACE;
+    if (enc->measuring)
+    {
+        *out_ptr = NULL;
+        return _sctp_encoder_count(enc, prefix + count * width);
+    }
+    int status = _sctp_encoder_reserve(enc, prefix + count * width);
+    if (status != SCTP_OK)
+        return status;
+
+    _sctp_encoder_put_header(enc, SCTP_TYPE_PACKED, (uint8_t)elem_type);
+    _sctp_encoder_put_uleb128(enc, count);
+    *out_ptr = enc->buffer + enc->position;
+    enc->position += count * width;
+    SCTP_STATS_ENCODED(SCTP_TYPE_PACKED, prefix + count * width, count * width);
+    return SCTP_OK;
 }
 
-LEA_EXPORT(sctp_encoder_size)
-size_t sctp_encoder_size(void)
+static int _sctp_encoder_emit_raw(sctp_encoder_t *enc, size_t length, void **out_ptr)
 {
-    if (!g_encoder)
-        LEA_ABORT();
-    return g_encoder->position;
+    if (enc->measuring)
+    {
+        *out_ptr = NULL;
+        return _sctp_encoder_count(enc, length);
+    }
+    int status = _sctp_encoder_reserve(enc, length);
+    if (status != SCTP_OK)
+        return status;
+    *out_ptr = enc->buffer + enc->position;
+    enc->position += length;
+    return SCTP_OK;
 }
 
-LEA_EXPORT(sctp_encoder_add_vector)
-void *sctp_encoder_add_vector(size_t length)
+static int _sctp_encoder_emit_short(sctp_encoder_t *enc, uint8_t value)
 {
-    sctp_encoder_t *enc = g_encoder;
-    if (!enc)
-        LEA_ABORT();
-    if (length < SCTP_VECTOR_LARGE_FLAG)
+    if (value > 15)
+        return SCTP_ERR_INVALID_ARG;
+    if (enc->measuring)
+        return _sctp_encoder_count(enc, 1);
+    int status = _sctp_encoder_reserve(enc, 1);
+    if (status != SCTP_OK)
+        return status;
+    _sctp_encoder_put_header(enc, SCTP_TYPE_SHORT, value);
+    SCTP_STATS_ENCODED(SCTP_TYPE_SHORT, 1, 0);
+    return SCTP_OK;
+}
+
+static int _sctp_encoder_emit_uleb128(sctp_encoder_t *enc, uint64_t value)
+{
+    if (enc->measuring)
+        return _sctp_encoder_count(enc, 1 + _sctp_encoder_uleb128_size(value));
+    int status = _sctp_encoder_reserve(enc, 1 + _sctp_encoder_uleb128_size(value));
+    if (status != SCTP_OK)
+        return status;
+    _sctp_encoder_put_header(enc, SCTP_TYPE_ULEB128, 0);
+    _sctp_encoder_put_uleb128(enc, value);
+    SCTP_STATS_ENCODED(SCTP_TYPE_ULEB128, 1 + _sctp_encoder_uleb128_size(value), 0);
+    return SCTP_OK;
+}
+
+static int _sctp_encoder_emit_sleb128(sctp_encoder_t *enc, int64_t value)
+{
+    if (enc->measuring)
+        return _sctp_encoder_count(enc, 1 + _sctp_encoder_sleb128_size(value));
+    int status = _sctp_encoder_reserve(enc, 1 + _sctp_encoder_sleb128_size(value));
+    if (status != SCTP_OK)
+        return status;
+    _sctp_encoder_put_header(enc, SCTP_TYPE_SLEB128, 0);
+    _sctp_encoder_put_sleb128(enc, value);
+    SCTP_STATS_ENCODED(SCTP_TYPE_SLEB128, 1 + _sctp_encoder_sleb128_size(value), 0);
+    return SCTP_OK;
+}
+
+static int _sctp_encoder_emit_eof(sctp_encoder_t *enc)
+{
+    if (enc->measuring)
+        return _sctp_encoder_count(enc, 1);
+    int status = _sctp_encoder_reserve(enc, 1);
+    if (status != SCTP_OK)
+        return status;
+    _sctp_encoder_put_header(enc, SCTP_TYPE_EOF, 0);
+    SCTP_STATS_ENCODED(SCTP_TYPE_EOF, 1, 0);
+    return SCTP_OK;
+}
+
+#ifdef SCTP_FLUSH_ENABLE
+/**
+ * @brief Writes a field header and payload through a streaming window.
+ *
+ * The prefix is written in one piece and the payload is copied in as many
+ * window-sized pieces as needed, flushing each full window, so the payload
+ * can be larger than the window.
+ *
+ * @param enc A pointer to a streaming encoder.
+ * @param type The field type (`SCTP_TYPE_VECTOR` or `SCTP_TYPE_PACKED`).
+ * @param meta The header metadata.
+ * @param has_count True if a ULEB128 length or count follows the header.
+ * @param count The length or count to write.
+ * @param data The payload.
+ * @param size The payload size in bytes.
+ */
+static int _sctp_encoder_emit_streamed(sctp_encoder_t *enc, sctp_type_t type, uint8_t meta, bool has_count,
+                                       uint64_t count, const void *data, size_t size)
+{
+    int status = _sctp_encoder_reserve(enc, 1 + (has_count ? _sctp_encoder_uleb128_size(count) : 0));
+    if (status != SCTP_OK)
+        return status;
+    _sctp_encoder_put_header(enc, type, meta);
+    if (has_count)
+        _sctp_encoder_put_uleb128(enc, count);
+    SCTP_STATS_ENCODED(type, 1 + (has_count ? _sctp_encoder_uleb128_size(count) : 0) + size, size);
+
+    const uint8_t *bytes = data;
+    while (size)
     {
-        _sctp_encoder_write_header(enc, SCTP_TYPE_VECTOR, (uint8_t)length);
+        if (enc->position == enc->capacity)
+            _sctp_encoder_flush(enc);
+        size_t piece = enc->capacity - enc->position;
+        if (piece > size)
+            piece = size;
+        _sctp_encoder_put_data(enc, bytes, piece);
+        bytes += piece;
+        size -= piece;
     }
-    else
+    return SCTP_OK;
+}
+#endif
+
+// --- Vector Dictionary ---
+//
+// An encoder with a dictionary remembers where it wrote recent vectors, in a
+// direct-mapped table indexed by a hash of their contents. A repeated vector
+// is written as a back-reference: a PACKED header with element type VECTOR,
+// then the ULEB128 distance in bytes from the start of the earlier vector
+// field to the start of the back-reference. Distances are measured in the
+// gathered stream, so external payloads in between are counted.
+
+/** @brief Hashes vector contents eight bytes at a time. */
+static uint64_t _sctp_encoder_hash_bytes(const uint8_t *data, size_t length)
+{
+    uint64_t hash = (uint64_t)length * 0x9E3779B97F4A7C15ULL;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t))
     {
-        _sctp_encoder_write_header(enc, SCTP_TYPE_VECTOR, SCTP_VECTOR_LARGE_FLAG);
-        _sctp_encoder_write_uleb128(enc, length);
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * 0xFF51AFD7ED558CCDULL;
+        hash ^= hash >> 32;
     }
-    _sctp_encoder_ensure_capacity(enc, length);
-    void *ptr = enc->buffer + enc->position;
-    enc->position += length;
-    return ptr;
+    uint64_t tail = 0;
+    memcpy(&tail, data + i, length - i);
+    hash = (hash ^ tail) * 0xFF51AFD7ED558CCDULL;
+    return hash ^ (hash >> 29);
 }
 
-LEA_EXPORT(sctp_encoder_add_raw)
-void* sctp_encoder_add_raw(size_t length)
+/**
+ * @brief Writes a vector through the dictionary.
+ *
+ * Emits a back-reference if the same contents were written earlier and the
+ * reference is shorter than the vector. Otherwise writes the vector and
+ * makes it the entry for its hash, replacing any older one.
+ */
+static int _sctp_encoder_emit_vector_dedup(sctp_encoder_t *enc, const void *data, size_t length)
 {
-    sctp_encoder_t *enc = g_encoder;
-    if (!enc)
-        LEA_ABORT();
-    _sctp_encoder_ensure_capacity(enc, length);
-    void *ptr = enc->buffer + enc->position;
-    enc->position += length;
-    return ptr;
+    const uint64_t hash = _sctp_encoder_hash_bytes(data, length);
+    sctp_dictionary_entry_t *entry = &enc->dictionary[hash & enc->dictionary_mask];
+    const size_t prefix = _sctp_encoder_vector_prefix_size(length);
+    const size_t stream = enc->position + enc->external_size;
+
+    if (entry->length == length && entry->hash == hash &&
+        memcmp(enc->buffer + entry->offset + prefix, data, length) == 0)
+    {
+        const uint64_t distance = stream - entry->stream;
+        const size_t size = 1 + _sctp_encoder_uleb128_size(distance);
+        if (size < prefix + length)
+        {
+            int status = _sctp_encoder_reserve(enc, size);
+            if (status != SCTP_OK)
+                return status;
+            _sctp_encoder_put_header(enc, SCTP_TYPE_PACKED, SCTP_TYPE_VECTOR);
+            _sctp_encoder_put_uleb128(enc, distance);
+            SCTP_STATS_ENCODED(SCTP_TYPE_PACKED, size, 0);
+            return SCTP_OK;
+        }
+    }
+
+    const size_t offset = enc->position;
+    void *ptr;
+    int status = _sctp_encoder_emit_vector(enc, length, &ptr);
+    if (status != SCTP_OK)
+        return status;
+    memcpy(ptr, data, length);
+    entry->hash = hash;
+    entry->offset = offset;
+    entry->stream = stream;
+    entry->length = length;
+    return SCTP_OK;
 }
 
-LEA_EXPORT(sctp_encoder_add_short)
-void sctp_encoder_add_short(uint8_t value)
+static int _sctp_encoder_emit_vector_data(sctp_encoder_t *enc, const void *data, size_t length)
 {
-    if (!g_encoder)
-        LEA_ABORT();
-    if (value > 15)
+#ifdef SCTP_FLUSH_ENABLE
+    if (enc->streaming)
     {
-        LEA_ABORT();
+        if (length < SCTP_VECTOR_LARGE_FLAG)
+            return _sctp_encoder_emit_streamed(enc, SCTP_TYPE_VECTOR, (uint8_t)length, false, 0, data, length);
+        return _sctp_encoder_emit_streamed(enc, SCTP_TYPE_VECTOR, SCTP_VECTOR_LARGE_FLAG, true, length, data, length);
+    }
+#endif
+    if (enc->dictionary && length >= SCTP_DICTIONARY_MIN_LENGTH)
+        return _sctp_encoder_emit_vector_dedup(enc, data, length);
+    void *ptr;
+    int status = _sctp_encoder_emit_vector(enc, length, &ptr);
+    if (status == SCTP_OK && ptr && length)
+        memcpy(ptr, data, length);
+    return status;
+}
+
+static int _sctp_encoder_emit_packed_data(sctp_encoder_t *enc, sctp_type_t elem_type, const void *values,
+                                          size_t count)
+{
+#ifdef SCTP_FLUSH_ENABLE
+    if (enc->streaming && (unsigned)elem_type <= SCTP_TYPE_MASK && sctp_encoder_fixed_width[elem_type])
+    {
+        const size_t width = sctp_encoder_fixed_width[elem_type];
+        if (count > SIZE_MAX / width)
+            return SCTP_ERR_NO_SPACE;
+        return _sctp_encoder_emit_streamed(enc, SCTP_TYPE_PACKED, (uint8_t)elem_type, true, count, values,
+                                           count * width);
     }
-    _sctp_encoder_write_header(g_encoder, SCTP_TYPE_SHORT, value);
+#endif
+    void *ptr;
+    int status = _sctp_encoder_emit_packed(enc, elem_type, count, &ptr);
+    if (status == SCTP_OK && ptr && count)
+        memcpy(ptr, values, count * sctp_encoder_fixed_width[elem_type]);
+    return status;
 }
 
+// --- Scatter/Gather Output ---
+
 /**
- * @def DEFINE_ENCODER_ADD_TYPE
- * @brief A macro to generate functions for adding fixed-size numeric types.
- *
- * This macro creates an exported function `sctp_encoder_add_NAME` that writes
- * the appropriate SCTP header and the binary representation of the value.
- *
+ * @brief Appends an entry to the encoder's segment list, growing it as needed.
+ * @return `SCTP_OK` on success, `SCTP_ERR_NO_SPACE` if the allocation fails.
+ */
+static int _sctp_encoder_push_segment(sctp_encoder_t *enc, size_t offset, size_t length, uint32_t tag)
+{
+    if (enc->segment_count == enc->segment_capacity)
+    {
+        size_t capacity = enc->segment_capacity ? enc->segment_capacity * 2 : SCTP_SEGMENT_MIN_ENTRIES;
+        sctp_segment_t *segments = _sctp_encoder_alloc(enc, capacity * sizeof(sctp_segment_t));
+        if (!segments)
+            return SCTP_ERR_NO_SPACE;
+        if (enc->segment_count)
+            memcpy(segments, enc->segments, enc->segment_count * sizeof(sctp_segment_t));
+        _sctp_encoder_release(enc, enc->segments);
+        enc->segments = segments;
+        enc->segment_capacity = capacity;
+    }
+    sctp_segment_t *segment = &enc->segments[enc->segment_count++];
+    segment->offset = (uint32_t)offset;
+    segment->length = (uint32_t)length;
+    segment->tag = tag;
+    return SCTP_OK;
+}
+
+static int _sctp_encoder_emit_vector_external(sctp_encoder_t *enc, size_t length, uint32_t tag)
+{
+    if (enc->streaming || enc->checksum_enabled || length > UINT32_MAX)
+        return SCTP_ERR_INVALID_ARG;
+    size_t prefix = _sctp_encoder_vector_prefix_size(length);
+    if (enc->measuring)
+    {
+        if (length > SIZE_MAX - prefix)
+            return SCTP_ERR_NO_SPACE;
+        return _sctp_encoder_count(enc, prefix + length);
+    }
+    int status = _sctp_encoder_reserve(enc, prefix);
+    if (status != SCTP_OK)
+        return status;
+    if (enc->position + prefix > UINT32_MAX)
+        return SCTP_ERR_NO_SPACE;
+    // Record the segment first, so a failed allocation leaves no header behind.
+    status = _sctp_encoder_push_segment(enc, enc->position + prefix, length, tag);
+    if (status != SCTP_OK)
+        return status;
+
+    if (length < SCTP_VECTOR_LARGE_FLAG)
+    {
+        _sctp_encoder_put_header(enc, SCTP_TYPE_VECTOR, (uint8_t)length);
+    }
+    else
+    {
+        _sctp_encoder_put_header(enc, SCTP_TYPE_VECTOR, SCTP_VECTOR_LARGE_FLAG);
+        _sctp_encoder_put_uleb128(enc, length);
+    }
+    enc->external_size += length;
+    SCTP_STATS_ENCODED(SCTP_TYPE_VECTOR, prefix + length, length);
+    return SCTP_OK;
+}
+
+// --- Size Helpers Implementation ---
+
+SCTP_EXPORT(sctp_size_uleb128)
+size_t sctp_size_uleb128(uint64_t value)
+{
+    return 1 + _sctp_encoder_uleb128_size(value);
+}
+
+SCTP_EXPORT(sctp_size_sleb128)
+size_t sctp_size_sleb128(int64_t value)
+{
+    return 1 + _sctp_encoder_sleb128_size(value);
+}
+
+SCTP_EXPORT(sctp_size_vector)
+size_t sctp_size_vector(size_t length)
+{
+    return _sctp_encoder_vector_prefix_size(length) + length;
+}
+
+SCTP_EXPORT(sctp_size_packed)
+size_t sctp_size_packed(sctp_type_t elem_type, size_t count)
+{
+    if ((unsigned)elem_type > SCTP_TYPE_MASK || !sctp_encoder_fixed_width[elem_type])
+        return 0;
+    return _sctp_encoder_packed_prefix_size(count) + count * sctp_encoder_fixed_width[elem_type];
+}
+
+SCTP_EXPORT(sctp_size_short)
+size_t sctp_size_short(void)
+{
+    return 1;
+}
+
+SCTP_EXPORT(sctp_size_eof)
+size_t sctp_size_eof(void)
+{
+    return 1;
+}
+
+/**
+ * @def DEFINE_SIZE_TYPE
+ * @brief A macro to generate size helpers for fixed-size numeric types.
  * @param name The suffix for the function name (e.g., int8, uint32).
  * @param type The C data type (e.g., int8_t, uint32_t).
- * @param sctp_type The corresponding `sctp_type_t` enum value.
  */
-#define DEFINE_ENCODER_ADD_TYPE(name, type, sctp_type)             \
-    LEA_EXPORT(sctp_encoder_add_##name)                            \
-    void sctp_encoder_add_##name(type value)                       \
-    {                                                              \
-        if (!g_encoder)                                            \
-            LEA_ABORT();                                           \
-        _sctp_encoder_write_header(g_encoder, sctp_type, 0);       \
-        _sctp_encoder_write_data(g_encoder, &value, sizeof(type)); \
+#define DEFINE_SIZE_TYPE(name, type) \
+    SCTP_EXPORT(sctp_size_##name)     \
+    size_t sctp_size_##name(void)    \
+    {                                \
+        return 1 + sizeof(type);     \
     }
 
-DEFINE_ENCODER_ADD_TYPE(int8, int8_t, SCTP_TYPE_INT8)
-DEFINE_ENCODER_ADD_TYPE(uint8, uint8_t, SCTP_TYPE_UINT8)
-DEFINE_ENCODER_ADD_TYPE(int16, int16_t, SCTP_TYPE_INT16)
-DEFINE_ENCODER_ADD_TYPE(uint16, uint16_t, SCTP_TYPE_UINT16)
-DEFINE_ENCODER_ADD_TYPE(int32, int32_t, SCTP_TYPE_INT32)
-DEFINE_ENCODER_ADD_TYPE(uint32, uint32_t, SCTP_TYPE_UINT32)
-DEFINE_ENCODER_ADD_TYPE(int64, int64_t, SCTP_TYPE_INT64)
-DEFINE_ENCODER_ADD_TYPE(uint64, uint64_t, SCTP_TYPE_UINT64)
-DEFINE_ENCODER_ADD_TYPE(float32, float, SCTP_TYPE_FLOAT32)
-DEFINE_ENCODER_ADD_TYPE(float64, double, SCTP_TYPE_FLOAT64)
+DEFINE_SIZE_TYPE(int8, int8_t)
+DEFINE_SIZE_TYPE(uint8, uint8_t)
+DEFINE_SIZE_TYPE(int16, int16_t)
+DEFINE_SIZE_TYPE(uint16, uint16_t)
+DEFINE_SIZE_TYPE(int32, int32_t)
+DEFINE_SIZE_TYPE(uint32, uint32_t)
+DEFINE_SIZE_TYPE(int64, int64_t)
+DEFINE_SIZE_TYPE(uint64, uint64_t)
+DEFINE_SIZE_TYPE(float32, float)
+DEFINE_SIZE_TYPE(float64, double)
 
-LEA_EXPORT(sctp_encoder_add_uleb128)
-void sctp_encoder_add_uleb128(uint64_t value)
+// --- Encoder Instance API Implementation ---
+
+/**
+ * @brief Sets every member of an encoder for writing into `buffer`.
+ * @param enc The encoder storage.
+ * @param buffer The output buffer, or NULL for a measuring encoder.
+ * @param capacity The size of the buffer.
+ * @param arena The arena the encoder and buffer come from, or NULL.
+ * @param measuring True if bytes are only counted, not written.
+ */
+static void _sctp_encoder_setup(sctp_encoder_t *enc, uint8_t *buffer, size_t capacity, sctp_arena_t *arena,
+                                bool measuring)
+{
+    enc->buffer = buffer;
+    enc->capacity = capacity;
+    enc->position = 0;
+    enc->growth = SCTP_GROWTH_NONE;
+    enc->growth_chunk = SCTP_GROWTH_DEFAULT_CHUNK;
+    enc->measuring = measuring;
+    enc->streaming = false;
+    enc->segments = NULL;
+    enc->segment_count = 0;
+    enc->segment_capacity = 0;
+    enc->arena = arena;
+    enc->external_size = 0;
+    enc->dictionary = NULL;
+    enc->dictionary_mask = 0;
+    enc->checksum_enabled = false;
+    enc->checksum = 0;
+    enc->checksum_position = 0;
+}
+
+SCTP_EXPORT(sctp_encoder_create)
+sctp_encoder_t *sctp_encoder_create(size_t capacity)
 {
-    if (!g_encoder)
+    sctp_encoder_t *enc = malloc(sizeof(sctp_encoder_t));
+    if (!enc)
+        LEA_ABORT();
+
+    uint8_t *buffer = malloc(capacity);
+    if (!buffer)
         LEA_ABORT();
-    _sctp_encoder_write_header(g_encoder, SCTP_TYPE_ULEB128, 0);
-    _sctp_encoder_write_uleb128(g_encoder, value);
+    _sctp_encoder_setup(enc, buffer, capacity, NULL, false);
+    SCTP_STATS_CAPACITY(capacity);
+
+    return enc;
 }
 
-LEA_EXPORT(sctp_encoder_add_sleb128)
-void sctp_encoder_add_sleb128(int64_t value)
+SCTP_EXPORT(sctp_encoder_create_in)
+sctp_encoder_t *sctp_encoder_create_in(sctp_arena_t *arena, size_t capacity)
 {
-    if (!g_encoder)
+    sctp_encoder_t *enc = sctp_arena_alloc(arena, sizeof(sctp_encoder_t));
+    if (!enc)
+        LEA_ABORT();
+
+    uint8_t *buffer = sctp_arena_alloc(arena, capacity);
+    if (!buffer)
         LEA_ABORT();
-    _sctp_encoder_write_header(g_encoder, SCTP_TYPE_SLEB128, 0);
-    _sctp_encoder_write_sleb128(g_encoder, value);
+    _sctp_encoder_setup(enc, buffer, capacity, arena, false);
+    SCTP_STATS_CAPACITY(capacity);
+
+    return enc;
 }
 
-LEA_EXPORT(sctp_encoder_add_eof)
-void sctp_encoder_add_eof(void)
+SCTP_EXPORT(sctp_encoder_create_measuring)
+sctp_encoder_t *sctp_encoder_create_measuring(void)
 {
-    if (!g_encoder)
+    sctp_encoder_t *enc = malloc(sizeof(sctp_encoder_t));
+    if (!enc)
         LEA_ABORT();
-    _sctp_encoder_write_header(g_encoder, SCTP_TYPE_EOF, 0);
+
+    _sctp_encoder_setup(enc, NULL, SIZE_MAX, NULL, true);
+    return enc;
+}
+
+#ifdef SCTP_FLUSH_ENABLE
+SCTP_EXPORT(sctp_encoder_create_streaming)
+sctp_encoder_t *sctp_encoder_create_streaming(size_t window)
+{
+    if (window < SCTP_STREAM_MIN_WINDOW)
+        LEA_ABORT();
+    sctp_encoder_t *enc = sctp_encoder_create(window);
+    enc->streaming = true;
+    return enc;
+}
+
+SCTP_EXPORT(sctp_encoder_flush_to)
+void sctp_encoder_flush_to(sctp_encoder_t *enc)
+{
+    if (!enc || !enc->streaming)
+        LEA_ABORT();
+    _sctp_encoder_flush(enc);
+}
+#endif
+
+SCTP_EXPORT(sctp_encoder_set_growth)
+void sctp_encoder_set_growth(sctp_encoder_t *enc, sctp_growth_t growth, size_t chunk_size)
+{
+    if (!enc)
+        LEA_ABORT();
+    if (growth != SCTP_GROWTH_NONE && growth != SCTP_GROWTH_GEOMETRIC && growth != SCTP_GROWTH_CHUNKED)
+        LEA_ABORT();
+    enc->growth = growth;
+    enc->growth_chunk = chunk_size ? chunk_size : SCTP_GROWTH_DEFAULT_CHUNK;
+}
+
+SCTP_EXPORT(sctp_encoder_set_dictionary)
+int sctp_encoder_set_dictionary(sctp_encoder_t *enc, size_t entries)
+{
+    if (!enc || enc->streaming || enc->measuring || entries > SCTP_DICTIONARY_MAX_ENTRIES)
+        return SCTP_ERR_INVALID_ARG;
+    sctp_dictionary_entry_t *dictionary = NULL;
+    size_t count = 0;
+    if (entries)
+    {
+        count = 1;
+        while (count < entries)
+            count *= 2;
+        dictionary = _sctp_encoder_alloc(enc, count * sizeof(sctp_dictionary_entry_t));
+        if (!dictionary)
+            return SCTP_ERR_NO_SPACE;
+        memset(dictionary, 0, count * sizeof(sctp_dictionary_entry_t));
+    }
+    _sctp_encoder_release(enc, enc->dictionary);
+    enc->dictionary = dictionary;
+    enc->dictionary_mask = count ? count - 1 : 0;
+    return SCTP_OK;
+}
+
+SCTP_EXPORT(sctp_encoder_reset)
+void sctp_encoder_reset(sctp_encoder_t *enc)
+{
+    if (!enc)
+        LEA_ABORT();
+    enc->position = 0;
+    enc->segment_count = 0;
+    enc->external_size = 0;
+    enc->checksum = 0;
+    enc->checksum_position = 0;
+    if (enc->dictionary)
+        memset(enc->dictionary, 0, (enc->dictionary_mask + 1) * sizeof(sctp_dictionary_entry_t));
+}
+
+SCTP_EXPORT(sctp_encoder_mark)
+void sctp_encoder_mark(const sctp_encoder_t *enc, sctp_encoder_mark_t *mark)
+{
+    if (!enc || !mark || enc->streaming)
+        LEA_ABORT();
+    mark->position = enc->position;
+    mark->segment_count = enc->segment_count;
+    mark->external_size = enc->external_size;
+    mark->checksum = enc->checksum;
+    mark->checksum_position = enc->checksum_position;
+}
+
+SCTP_EXPORT(sctp_encoder_rollback)
+void sctp_encoder_rollback(sctp_encoder_t *enc, const sctp_encoder_mark_t *mark)
+{
+    if (!enc || !mark || enc->streaming || mark->position > enc->position ||
+        mark->segment_count > enc->segment_count || mark->checksum_position > mark->position)
+        LEA_ABORT();
+    enc->position = mark->position;
+    enc->segment_count = mark->segment_count;
+    enc->external_size = mark->external_size;
+    enc->checksum = mark->checksum;
+    enc->checksum_position = mark->checksum_position;
+    // Forget vectors written after the mark, so no back-reference points into
+    // bytes that are about to be overwritten.
+    if (enc->dictionary)
+    {
+        for (size_t i = 0; i <= enc->dictionary_mask; i++)
+        {
+            if (enc->dictionary[i].offset >= mark->position)
+                enc->dictionary[i].length = 0;
+        }
+    }
+}
+
+SCTP_EXPORT(sctp_encoder_get_remaining)
+size_t sctp_encoder_get_remaining(const sctp_encoder_t *enc)
+{
+    if (!enc)
+        LEA_ABORT();
+    return enc->capacity - enc->position;
+}
+
+SCTP_EXPORT(sctp_encoder_free)
+void sctp_encoder_free(sctp_encoder_t *enc)
+{
+    if (!enc || enc->arena)
+        return;
+    free(enc->dictionary);
+    free(enc->segments);
+    free(enc->buffer);
+    free(enc);
+}
+
+SCTP_EXPORT(sctp_encoder_get_data)
+const uint8_t *sctp_encoder_get_data(const sctp_encoder_t *enc)
+{
+    if (!enc)
+        LEA_ABORT();
+    return enc->buffer;
+}
+
+SCTP_EXPORT(sctp_encoder_get_size)
+size_t sctp_encoder_get_size(const sctp_encoder_t *enc)
+{
+    if (!enc)
+        LEA_ABORT();
+    return enc->position;
+}
+
+SCTP_EXPORT(sctp_encoder_add_vector_to)
+void *sctp_encoder_add_vector_to(sctp_encoder_t *enc, size_t length)
+{
+    void *ptr;
+    if (!enc)
+        LEA_ABORT();
+    if (_sctp_encoder_emit_vector(enc, length, &ptr) != SCTP_OK)
+        LEA_ABORT();
+    return ptr;
+}
+
+SCTP_EXPORT(sctp_encoder_add_vector_data_to)
+void sctp_encoder_add_vector_data_to(sctp_encoder_t *enc, const void *data, size_t length)
+{
+    if (!enc || (!data && length))
+        LEA_ABORT();
+    if (_sctp_encoder_emit_vector_data(enc, data, length) != SCTP_OK)
+        LEA_ABORT();
+}
+
+SCTP_EXPORT(sctp_encoder_add_packed_to)
+void *sctp_encoder_add_packed_to(sctp_encoder_t *enc, sctp_type_t elem_type, size_t count)
+{
+    void *ptr;
+    if (!enc)
+        LEA_ABORT();
+    if (_sctp_encoder_emit_packed(enc, elem_type, count, &ptr) != SCTP_OK)
+        LEA_ABORT();
+    return ptr;
+}
+
+SCTP_EXPORT(sctp_encoder_add_raw_to)
+void *sctp_encoder_add_raw_to(sctp_encoder_t *enc, size_t length)
+{
+    void *ptr;
+    if (!enc)
+        LEA_ABORT();
+    if (_sctp_encoder_emit_raw(enc, length, &ptr) != SCTP_OK)
+        LEA_ABORT();
+    return ptr;
+}
+
+SCTP_EXPORT(sctp_encoder_add_vector_external_to)
+void sctp_encoder_add_vector_external_to(sctp_encoder_t *enc, size_t length, uint32_t tag)
+{
+    if (!enc)
+        LEA_ABORT();
+    if (_sctp_encoder_emit_vector_external(enc, length, tag) != SCTP_OK)
+        LEA_ABORT();
+}
+
+SCTP_EXPORT(sctp_encoder_get_segments)
+const sctp_segment_t *sctp_encoder_get_segments(const sctp_encoder_t *enc)
+{
+    if (!enc)
+        LEA_ABORT();
+    return enc->segment_count ? enc->segments : NULL;
+}
+
+SCTP_EXPORT(sctp_encoder_get_segment_count)
+size_t sctp_encoder_get_segment_count(const sctp_encoder_t *enc)
+{
+    if (!enc)
+        LEA_ABORT();
+    return enc->segment_count;
+}
+
+SCTP_EXPORT(sctp_encoder_get_gathered_size)
+size_t sctp_encoder_get_gathered_size(const sctp_encoder_t *enc)
+{
+    if (!enc)
+        LEA_ABORT();
+    size_t size = enc->position;
+    for (size_t i = 0; i < enc->segment_count; i++)
+        size += enc->segments[i].length;
+    return size;
+}
+
+SCTP_EXPORT(sctp_encoder_gather)
+void sctp_encoder_gather(const sctp_encoder_t *enc, const void *const *slices, void *out)
+{
+    if (!enc || !out || (!slices && enc->segment_count))
+        LEA_ABORT();
+
+    uint8_t *dst = out;
+    size_t from = 0;
+    for (size_t i = 0; i < enc->segment_count; i++)
+    {
+        const sctp_segment_t *segment = &enc->segments[i];
+        memcpy(dst, enc->buffer + from, segment->offset - from);
+        dst += segment->offset - from;
+        if (segment->length)
+            memcpy(dst, slices[segment->tag], segment->length);
+        dst += segment->length;
+        from = segment->offset;
+    }
+    if (enc->position > from)
+        memcpy(dst, enc->buffer + from, enc->position - from);
+}
+
+SCTP_EXPORT(sctp_encoder_add_short_to)
+void sctp_encoder_add_short_to(sctp_encoder_t *enc, uint8_t value)
+{
+    if (!enc)
+        LEA_ABORT();
+    if (_sctp_encoder_emit_short(enc, value) != SCTP_OK)
+        LEA_ABORT();
+}
+
+SCTP_EXPORT(sctp_encoder_add_uleb128_to)
+void sctp_encoder_add_uleb128_to(sctp_encoder_t *enc, uint64_t value)
+{
+    if (!enc)
+        LEA_ABORT();
+    if (_sctp_encoder_emit_uleb128(enc, value) != SCTP_OK)
+        LEA_ABORT();
+}
+
+SCTP_EXPORT(sctp_encoder_add_sleb128_to)
+void sctp_encoder_add_sleb128_to(sctp_encoder_t *enc, int64_t value)
+{
+    if (!enc)
+        LEA_ABORT();
+    if (_sctp_encoder_emit_sleb128(enc, value) != SCTP_OK)
+        LEA_ABORT();
+}
+
+SCTP_EXPORT(sctp_encoder_add_eof_to)
+void sctp_encoder_add_eof_to(sctp_encoder_t *enc)
+{
+    if (!enc)
+        LEA_ABORT();
+    if (_sctp_encoder_emit_eof(enc) != SCTP_OK)
+        LEA_ABORT();
+}
+
+// --- Error-Returning Instance API Implementation ---
+
+SCTP_EXPORT(sctp_encoder_try_add_vector_to)
+int sctp_encoder_try_add_vector_to(sctp_encoder_t *enc, size_t length, void **out_ptr)
+{
+    if (!enc || !out_ptr)
+        return SCTP_ERR_INVALID_ARG;
+    return _sctp_encoder_emit_vector(enc, length, out_ptr);
+}
+
+SCTP_EXPORT(sctp_encoder_try_add_vector_data_to)
+int sctp_encoder_try_add_vector_data_to(sctp_encoder_t *enc, const void *data, size_t length)
+{
+    if (!enc || (!data && length))
+        return SCTP_ERR_INVALID_ARG;
+    return _sctp_encoder_emit_vector_data(enc, data, length);
+}
+
+SCTP_EXPORT(sctp_encoder_try_add_packed_to)
+int sctp_encoder_try_add_packed_to(sctp_encoder_t *enc, sctp_type_t elem_type, size_t count, void **out_ptr)
+{
+    if (!enc || !out_ptr)
+        return SCTP_ERR_INVALID_ARG;
+    return _sctp_encoder_emit_packed(enc, elem_type, count, out_ptr);
+}
+
+SCTP_EXPORT(sctp_encoder_try_add_raw_to)
+int sctp_encoder_try_add_raw_to(sctp_encoder_t *enc, size_t length, void **out_ptr)
+{
+    if (!enc || !out_ptr)
+        return SCTP_ERR_INVALID_ARG;
+    return _sctp_encoder_emit_raw(enc, length, out_ptr);
+}
+
+SCTP_EXPORT(sctp_encoder_try_add_vector_external_to)
+int sctp_encoder_try_add_vector_external_to(sctp_encoder_t *enc, size_t length, uint32_t tag)
+{
+    if (!enc)
+        return SCTP_ERR_INVALID_ARG;
+    return _sctp_encoder_emit_vector_external(enc, length, tag);
+}
+
+SCTP_EXPORT(sctp_encoder_try_add_short_to)
+int sctp_encoder_try_add_short_to(sctp_encoder_t *enc, uint8_t value)
+{
+    if (!enc)
+        return SCTP_ERR_INVALID_ARG;
+    return _sctp_encoder_emit_short(enc, value);
+}
+
+SCTP_EXPORT(sctp_encoder_try_add_uleb128_to)
+int sctp_encoder_try_add_uleb128_to(sctp_encoder_t *enc, uint64_t value)
+{
+    if (!enc)
+        return SCTP_ERR_INVALID_ARG;
+    return _sctp_encoder_emit_uleb128(enc, value);
+}
+
+SCTP_EXPORT(sctp_encoder_try_add_sleb128_to)
+int sctp_encoder_try_add_sleb128_to(sctp_encoder_t *enc, int64_t value)
+{
+    if (!enc)
+        return SCTP_ERR_INVALID_ARG;
+    return _sctp_encoder_emit_sleb128(enc, value);
+}
+
+SCTP_EXPORT(sctp_encoder_try_add_eof_to)
+int sctp_encoder_try_add_eof_to(sctp_encoder_t *enc)
+{
+    if (!enc)
+        return SCTP_ERR_INVALID_ARG;
+    return _sctp_encoder_emit_eof(enc);
+}
+
+/**
+ * @def DEFINE_ENCODER_ADD_ARRAY
+ * @brief A macro to generate bulk functions for adding arrays of a fixed-size type.
+ *
+ * This macro creates `sctp_encoder_add_NAME_array_to`,
+ * `sctp_encoder_try_add_NAME_array_to` and the singleton wrapper
+ * `sctp_encoder_add_NAME_array`. Each element is emitted as a regular field,
+ * so the output is identical to calling `sctp_encoder_add_NAME` in a loop,
+ * but capacity is reserved once for the whole array and the header and
+ * payload pairs are written in a tight loop. A streaming window may be
+ * smaller than the array, so a streaming encoder adds the fields one at a
+ * time; each of them fits in the smallest window.
+ *
+ * @param name The suffix for the function name (e.g., int8, uint32).
+ * @param type The C data type (e.g., int8_t, uint32_t).
+ * @param sctp_type The corresponding `sctp_type_t` enum value.
+ */
+#define DEFINE_ENCODER_ADD_ARRAY(name, type, sctp_type)                                        \
+    static int _sctp_encoder_emit_##name##_array(sctp_encoder_t *enc, const type *values,      \
+                                                 size_t count)                                 \
+    {                                                                                          \
+        const size_t stride = 1 + sizeof(type);                                                \
+        if (count > SIZE_MAX / stride)                                                         \
+            return SCTP_ERR_NO_SPACE;                                                          \
+        if (enc->measuring)                                                                    \
+            return _sctp_encoder_count(enc, count * stride);                                   \
+        if (enc->streaming)                                                                    \
+        {                                                                                      \
+            int stream_status = SCTP_OK;                                                       \
+            for (size_t i = 0; i < count && stream_status == SCTP_OK; i++)                     \
+                stream_status = _sctp_encoder_emit_##name(enc, values[i]);                     \
+            return stream_status;                                                              \
+        }                                                                                      \
+        int status = _sctp_encoder_reserve(enc, count * stride);                               \
+        if (status != SCTP_OK)                                                                 \
+            return status;                                                                     \
+        uint8_t *out = enc->buffer + enc->position;                                            \
+        for (size_t i = 0; i < count; i++)                                                     \
+        {                                                                                      \
+            out[i * stride] = (uint8_t)(sctp_type);                                            \
+            memcpy(out + i * stride + 1, &values[i], sizeof(type));                            \
+        }                                                                                      \
+        enc->position += count * stride;                                                       \
+        SCTP_STATS_ENCODED_MANY(sctp_type, count, count * stride);                             \
+        return SCTP_OK;                                                                        \
+    }                                                                                          \
+                                                                                               \
+    SCTP_EXPORT(sctp_encoder_add_##name##_array_to)                                             \
+    void sctp_encoder_add_##name##_array_to(sctp_encoder_t *enc, const type *values,           \
+                                            size_t count)                                      \
+    {                                                                                          \
+        if (!enc || (!values && count))                                                        \
+            LEA_ABORT();                                                                       \
+        if (_sctp_encoder_emit_##name##_array(enc, values, count) != SCTP_OK)                  \
+            LEA_ABORT();                                                                       \
+    }                                                                                          \
+                                                                                               \
+    SCTP_EXPORT(sctp_encoder_try_add_##name##_array_to)                                         \
+    int sctp_encoder_try_add_##name##_array_to(sctp_encoder_t *enc, const type *values,        \
+                                               size_t count)                                   \
+    {                                                                                          \
+        if (!enc || (!values && count))                                                        \
+            return SCTP_ERR_INVALID_ARG;                                                       \
+        return _sctp_encoder_emit_##name##_array(enc, values, count);                          \
+    }                                                                                          \
+                                                                                               \
+    SCTP_EXPORT(sctp_encoder_add_##name##_array)                                                \
+    void sctp_encoder_add_##name##_array(const type *values, size_t count)                     \
+    {                                                                                          \
+        sctp_encoder_add_##name##_array_to(g_encoder, values, count);                          \
+    }
+
+/**
+ * @def DEFINE_ENCODER_ADD_PACKED
+ * @brief A macro to generate functions for adding packed arrays of a fixed-size type.
+ *
+ * This macro creates `sctp_encoder_add_packed_NAME_to`,
+ * `sctp_encoder_try_add_packed_NAME_to` and the singleton wrapper
+ * `sctp_encoder_add_packed_NAME`, which copy a C array into a single
+ * `SCTP_TYPE_PACKED` field.
+ *
+ * @param name The suffix for the function name (e.g., int8, uint32).
+ * @param type The C data type (e.g., int8_t, uint32_t).
+ * @param sctp_type The corresponding `sctp_type_t` enum value.
+ */
+#define DEFINE_ENCODER_ADD_PACKED(name, type, sctp_type)                                       \
+    static int _sctp_encoder_emit_packed_##name(sctp_encoder_t *enc, const type *values,       \
+                                                size_t count)                                  \
+    {                                                                                          \
+        return _sctp_encoder_emit_packed_data(enc, sctp_type, values, count);                  \
+    }                                                                                          \
+                                                                                               \
+    SCTP_EXPORT(sctp_encoder_add_packed_##name##_to)                                            \
+    void sctp_encoder_add_packed_##name##_to(sctp_encoder_t *enc, const type *values,          \
+                                             size_t count)                                     \
+    {                                                                                          \
+        if (!enc || (!values && count))                                                        \
+            LEA_ABORT();                                                                       \
+        if (_sctp_encoder_emit_packed_##name(enc, values, count) != SCTP_OK)                   \
+            LEA_ABORT();                                                                       \
+    }                                                                                          \
+                                                                                               \
+    SCTP_EXPORT(sctp_encoder_try_add_packed_##name##_to)                                        \
+    int sctp_encoder_try_add_packed_##name##_to(sctp_encoder_t *enc, const type *values,       \
+                                                size_t count)                                  \
+    {                                                                                          \
+        if (!enc || (!values && count))                                                        \
+            return SCTP_ERR_INVALID_ARG;                                                       \
+        return _sctp_encoder_emit_packed_##name(enc, values, count);                           \
+    }                                                                                          \
+                                                                                               \
+    SCTP_EXPORT(sctp_encoder_add_packed_##name)                                                 \
+    void sctp_encoder_add_packed_##name(const type *values, size_t count)                      \
+    {                                                                                          \
+        sctp_encoder_add_packed_##name##_to(g_encoder, values, count);                         \
+    }
+
+/**
+ * @def DEFINE_ENCODER_ADD_TYPE
+ * @brief A macro to generate functions for adding fixed-size numeric types.
+ *
+ * This macro creates an exported function `sctp_encoder_add_NAME_to` that
+ * writes the appropriate SCTP header and the binary representation of the
+ * value to the given encoder, its error-returning counterpart
+ * `sctp_encoder_try_add_NAME_to`, and the singleton wrapper
+ * `sctp_encoder_add_NAME`, plus the array variants from
+ * `DEFINE_ENCODER_ADD_ARRAY` and the packed variants from
+ * `DEFINE_ENCODER_ADD_PACKED`.
+ *
+ * @param name The suffix for the function name (e.g., int8, uint32).
+ * @param type The C data type (e.g., int8_t, uint32_t).
+ * @param sctp_type The corresponding `sctp_type_t` enum value.
+ */
+#define DEFINE_ENCODER_ADD_TYPE(name, type, sctp_type)                     \
+    static int _sctp_encoder_emit_##name(sctp_encoder_t *enc, type value)  \
+    {                                                                      \
+        if (enc->measuring)                                                \
+            return _sctp_encoder_count(enc, 1 + sizeof(type));             \
+        int status = _sctp_encoder_reserve(enc, 1 + sizeof(type));         \
+        if (status != SCTP_OK)                                             \
+            return status;                                                 \
+        _sctp_encoder_put_header(enc, sctp_type, 0);                       \
+        _sctp_encoder_put_data(enc, &value, sizeof(type));                 \
+        SCTP_STATS_ENCODED(sctp_type, 1 + sizeof(type), sizeof(type));     \
+        return SCTP_OK;                                                    \
+    }                                                                      \
+                                                                           \
+    SCTP_EXPORT(sctp_encoder_add_##name##_to)                               \
+    void sctp_encoder_add_##name##_to(sctp_encoder_t *enc, type value)     \
+    {                                                                      \
+        if (!enc)                                                          \
+            LEA_ABORT();                                                   \
+        if (_sctp_encoder_emit_##name(enc, value) != SCTP_OK)              \
+            LEA_ABORT();                                                   \
+    }                                                                      \
+                                                                           \
+    SCTP_EXPORT(sctp_encoder_try_add_##name##_to)                           \
+    int sctp_encoder_try_add_##name##_to(sctp_encoder_t *enc, type value)  \
+    {                                                                      \
+        if (!enc)                                                          \
+            return SCTP_ERR_INVALID_ARG;                                   \
+        return _sctp_encoder_emit_##name(enc, value);                      \
+    }                                                                      \
+                                                                           \
+    SCTP_EXPORT(sctp_encoder_add_##name)                                    \
+    void sctp_encoder_add_##name(type value)                               \
+    {                                                                      \
+        sctp_encoder_add_##name##_to(g_encoder, value);                    \
+    }                                                                      \
+                                                                           \
+    DEFINE_ENCODER_ADD_ARRAY(name, type, sctp_type)                        \
+    DEFINE_ENCODER_ADD_PACKED(name, type, sctp_type)
+
+DEFINE_ENCODER_ADD_TYPE(int8, int8_t, SCTP_TYPE_INT8)
+DEFINE_ENCODER_ADD_TYPE(uint8, uint8_t, SCTP_TYPE_UINT8)
+DEFINE_ENCODER_ADD_TYPE(int16, int16_t, SCTP_TYPE_INT16)
+DEFINE_ENCODER_ADD_TYPE(uint16, uint16_t, SCTP_TYPE_UINT16)
+DEFINE_ENCODER_ADD_TYPE(int32, int32_t, SCTP_TYPE_INT32)
+DEFINE_ENCODER_ADD_TYPE(uint32, uint32_t, SCTP_TYPE_UINT32)
+DEFINE_ENCODER_ADD_TYPE(int64, int64_t, SCTP_TYPE_INT64)
+DEFINE_ENCODER_ADD_TYPE(uint64, uint64_t, SCTP_TYPE_UINT64)
+DEFINE_ENCODER_ADD_TYPE(float32, float, SCTP_TYPE_FLOAT32)
+DEFINE_ENCODER_ADD_TYPE(float64, double, SCTP_TYPE_FLOAT64)
+
+/**
+ * @brief Emits an array of ULEB128 fields with a single capacity check.
+ *
+ * A first pass sums the encoded sizes (a branch-free count-leading-zeros per
+ * element that the compiler can vectorize), then the fields are written
+ * with the word-at-a-time LEB128 writer. A streaming encoder adds the fields
+ * one at a time instead, as the array may not fit in its window.
+ */
+static int _sctp_encoder_emit_uleb128_array(sctp_encoder_t *enc, const uint64_t *values, size_t count)
+{
+    if (count > SIZE_MAX / 11)
+        return SCTP_ERR_NO_SPACE;
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++)
+        total += 1 + _sctp_encoder_uleb128_size(values[i]);
+    if (enc->measuring)
+        return _sctp_encoder_count(enc, total);
+#ifdef SCTP_FLUSH_ENABLE
+    if (enc->streaming)
+    {
+        int status = SCTP_OK;
+        for (size_t i = 0; i < count && status == SCTP_OK; i++)
+            status = _sctp_encoder_emit_uleb128(enc, values[i]);
+        return status;
+    }
+#endif
+    int status = _sctp_encoder_reserve(enc, total);
+    if (status != SCTP_OK)
+        return status;
+    for (size_t i = 0; i < count; i++)
+    {
+        _sctp_encoder_put_header(enc, SCTP_TYPE_ULEB128, 0);
+        _sctp_encoder_put_uleb128(enc, values[i]);
+        SCTP_STATS_ENCODED(SCTP_TYPE_ULEB128, 1 + _sctp_encoder_uleb128_size(values[i]), 0);
+    }
+    return SCTP_OK;
+}
+
+/**
+ * @brief Emits an array of SLEB128 fields with a single capacity check.
+ * @see _sctp_encoder_emit_uleb128_array
+ */
+static int _sctp_encoder_emit_sleb128_array(sctp_encoder_t *enc, const int64_t *values, size_t count)
+{
+    if (count > SIZE_MAX / 11)
+        return SCTP_ERR_NO_SPACE;
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++)
+        total += 1 + _sctp_encoder_sleb128_size(values[i]);
+    if (enc->measuring)
+        return _sctp_encoder_count(enc, total);
+#ifdef SCTP_FLUSH_ENABLE
+    if (enc->streaming)
+    {
+        int status = SCTP_OK;
+        for (size_t i = 0; i < count && status == SCTP_OK; i++)
+            status = _sctp_encoder_emit_sleb128(enc, values[i]);
+        return status;
+    }
+#endif
+    int status = _sctp_encoder_reserve(enc, total);
+    if (status != SCTP_OK)
+        return status;
+    for (size_t i = 0; i < count; i++)
+    {
+        _sctp_encoder_put_header(enc, SCTP_TYPE_SLEB128, 0);
+        _sctp_encoder_put_sleb128(enc, values[i]);
+        SCTP_STATS_ENCODED(SCTP_TYPE_SLEB128, 1 + _sctp_encoder_sleb128_size(values[i]), 0);
+    }
+    return SCTP_OK;
+}
+
+SCTP_EXPORT(sctp_encoder_add_uleb128_array_to)
+void sctp_encoder_add_uleb128_array_to(sctp_encoder_t *enc, const uint64_t *values, size_t count)
+{
+    if (!enc || (!values && count))
+        LEA_ABORT();
+    if (_sctp_encoder_emit_uleb128_array(enc, values, count) != SCTP_OK)
+        LEA_ABORT();
+}
+
+SCTP_EXPORT(sctp_encoder_try_add_uleb128_array_to)
+int sctp_encoder_try_add_uleb128_array_to(sctp_encoder_t *enc, const uint64_t *values, size_t count)
+{
+    if (!enc || (!values && count))
+        return SCTP_ERR_INVALID_ARG;
+    return _sctp_encoder_emit_uleb128_array(enc, values, count);
+}
+
+SCTP_EXPORT(sctp_encoder_add_sleb128_array_to)
+void sctp_encoder_add_sleb128_array_to(sctp_encoder_t *enc, const int64_t *values, size_t count)
+{
+    if (!enc || (!values && count))
+        LEA_ABORT();
+    if (_sctp_encoder_emit_sleb128_array(enc, values, count) != SCTP_OK)
+        LEA_ABORT();
+}
+
+SCTP_EXPORT(sctp_encoder_try_add_sleb128_array_to)
+int sctp_encoder_try_add_sleb128_array_to(sctp_encoder_t *enc, const int64_t *values, size_t count)
+{
+    if (!enc || (!values && count))
+        return SCTP_ERR_INVALID_ARG;
+    return _sctp_encoder_emit_sleb128_array(enc, values, count);
+}
+
+// --- Automatic Integer Encoding ---
+
+/**
+ * @brief Chooses the wire type for `sctp_encoder_add_uint_auto`.
+ *
+ * Picks the shortest encoding, preferring the fixed-width type when it is as
+ * short as the ULEB128 form.
+ */
+static sctp_type_t _sctp_encoder_uint_auto_type(uint64_t value)
+{
+    if (value <= 0x0F)
+        return SCTP_TYPE_SHORT;
+    if (value <= UINT8_MAX)
+        return SCTP_TYPE_UINT8;
+    if (value <= UINT16_MAX)
+        return SCTP_TYPE_UINT16;
+    size_t leb = 1 + _sctp_encoder_uleb128_size(value);
+    if (value <= UINT32_MAX)
+        return leb < 1 + sizeof(uint32_t) ? SCTP_TYPE_ULEB128 : SCTP_TYPE_UINT32;
+    return leb < 1 + sizeof(uint64_t) ? SCTP_TYPE_ULEB128 : SCTP_TYPE_UINT64;
+}
+
+/**
+ * @brief Chooses the wire type for `sctp_encoder_add_int_auto`.
+ * @see _sctp_encoder_uint_auto_type
+ */
+static sctp_type_t _sctp_encoder_int_auto_type(int64_t value)
+{
+    if (value >= 0)
+        return _sctp_encoder_uint_auto_type((uint64_t)value);
+    if (value >= INT8_MIN)
+        return SCTP_TYPE_INT8;
+    if (value >= INT16_MIN)
+        return SCTP_TYPE_INT16;
+    size_t leb = 1 + _sctp_encoder_sleb128_size(value);
+    if (value >= INT32_MIN)
+        return leb < 1 + sizeof(int32_t) ? SCTP_TYPE_SLEB128 : SCTP_TYPE_INT32;
+    return leb < 1 + sizeof(int64_t) ? SCTP_TYPE_SLEB128 : SCTP_TYPE_INT64;
+}
+
+static int _sctp_encoder_emit_uint_auto(sctp_encoder_t *enc, uint64_t value)
+{
+    switch (_sctp_encoder_uint_auto_type(value))
+    {
+    case SCTP_TYPE_SHORT:
+        return _sctp_encoder_emit_short(enc, (uint8_t)value);
+    case SCTP_TYPE_UINT8:
+        return _sctp_encoder_emit_uint8(enc, (uint8_t)value);
+    case SCTP_TYPE_UINT16:
+        return _sctp_encoder_emit_uint16(enc, (uint16_t)value);
+    case SCTP_TYPE_UINT32:
+        return _sctp_encoder_emit_uint32(enc, (uint32_t)value);
+    case SCTP_TYPE_UINT64:
+        return _sctp_encoder_emit_uint64(enc, value);
+    default:
+        return _sctp_encoder_emit_uleb128(enc, value);
+    }
+}
+
+static int _sctp_encoder_emit_int_auto(sctp_encoder_t *enc, int64_t value)
+{
+    if (value >= 0)
+        return _sctp_encoder_emit_uint_auto(enc, (uint64_t)value);
+    switch (_sctp_encoder_int_auto_type(value))
+    {
+    case SCTP_TYPE_INT8:
+        return _sctp_encoder_emit_int8(enc, (int8_t)value);
+    case SCTP_TYPE_INT16:
+        return _sctp_encoder_emit_int16(enc, (int16_t)value);
+    case SCTP_TYPE_INT32:
+        return _sctp_encoder_emit_int32(enc, (int32_t)value);
+    case SCTP_TYPE_INT64:
+        return _sctp_encoder_emit_int64(enc, value);
+    default:
+        return _sctp_encoder_emit_sleb128(enc, value);
+    }
+}
+
+/** @brief Returns the encoded size of a field of `type` holding `value`. */
+static size_t _sctp_encoder_auto_size(sctp_type_t type, uint64_t value)
+{
+    switch (type)
+    {
+    case SCTP_TYPE_SHORT:
+        return 1;
+    case SCTP_TYPE_ULEB128:
+        return 1 + _sctp_encoder_uleb128_size(value);
+    case SCTP_TYPE_SLEB128:
+        return 1 + _sctp_encoder_sleb128_size((int64_t)value);
+    default:
+        return 1 + sctp_encoder_fixed_width[type];
+    }
+}
+
+SCTP_EXPORT(sctp_size_uint_auto)
+size_t sctp_size_uint_auto(uint64_t value)
+{
+    return _sctp_encoder_auto_size(_sctp_encoder_uint_auto_type(value), value);
+}
+
+SCTP_EXPORT(sctp_size_int_auto)
+size_t sctp_size_int_auto(int64_t value)
+{
+    return _sctp_encoder_auto_size(_sctp_encoder_int_auto_type(value), (uint64_t)value);
+}
+
+SCTP_EXPORT(sctp_encoder_add_uint_auto_to)
+void sctp_encoder_add_uint_auto_to(sctp_encoder_t *enc, uint64_t value)
+{
+    if (!enc)
+        LEA_ABORT();
+    if (_sctp_encoder_emit_uint_auto(enc, value) != SCTP_OK)
+        LEA_ABORT();
+}
+
+SCTP_EXPORT(sctp_encoder_add_int_auto_to)
+void sctp_encoder_add_int_auto_to(sctp_encoder_t *enc, int64_t value)
+{
+    if (!enc)
+        LEA_ABORT();
+    if (_sctp_encoder_emit_int_auto(enc, value) != SCTP_OK)
+        LEA_ABORT();
+}
+
+SCTP_EXPORT(sctp_encoder_try_add_uint_auto_to)
+int sctp_encoder_try_add_uint_auto_to(sctp_encoder_t *enc, uint64_t value)
+{
+    if (!enc)
+        return SCTP_ERR_INVALID_ARG;
+    return _sctp_encoder_emit_uint_auto(enc, value);
+}
+
+SCTP_EXPORT(sctp_encoder_try_add_int_auto_to)
+int sctp_encoder_try_add_int_auto_to(sctp_encoder_t *enc, int64_t value)
+{
+    if (!enc)
+        return SCTP_ERR_INVALID_ARG;
+    return _sctp_encoder_emit_int_auto(enc, value);
+}
+
+// --- Checksum Trailer ---
+
+SCTP_EXPORT(sctp_encoder_set_checksum)
+void sctp_encoder_set_checksum(sctp_encoder_t *enc, bool enabled)
+{
+    if (!enc)
+        LEA_ABORT();
+    enc->checksum_enabled = enabled;
+    enc->checksum = 0;
+    enc->checksum_position = enc->position;
+}
+
+SCTP_EXPORT(sctp_encoder_get_checksum)
+uint32_t sctp_encoder_get_checksum(sctp_encoder_t *enc)
+{
+    if (!enc)
+        LEA_ABORT();
+    if (!enc->checksum_enabled || enc->measuring)
+        return 0;
+    _sctp_encoder_checksum_update(enc);
+    return enc->checksum;
+}
+
+/**
+ * @brief Writes the checksum trailer and restarts the checksum after it.
+ * @param enc A pointer to the encoder context.
+ */
+static int _sctp_encoder_emit_checksum(sctp_encoder_t *enc)
+{
+    if (!enc->checksum_enabled)
+        return SCTP_ERR_INVALID_ARG;
+    int status = _sctp_encoder_emit_uint32(enc, sctp_encoder_get_checksum(enc));
+    if (status != SCTP_OK)
+        return status;
+    enc->checksum = 0;
+    enc->checksum_position = enc->position;
+    return SCTP_OK;
+}
+
+SCTP_EXPORT(sctp_encoder_add_checksum_to)
+void sctp_encoder_add_checksum_to(sctp_encoder_t *enc)
+{
+    if (!enc)
+        LEA_ABORT();
+    if (_sctp_encoder_emit_checksum(enc) != SCTP_OK)
+        LEA_ABORT();
+}
+
+SCTP_EXPORT(sctp_encoder_try_add_checksum_to)
+int sctp_encoder_try_add_checksum_to(sctp_encoder_t *enc)
+{
+    if (!enc)
+        return SCTP_ERR_INVALID_ARG;
+    return _sctp_encoder_emit_checksum(enc);
+}
+
+// --- Batch Container ---
+
+/** @brief Bytes kept free in front of the messages for the container header. */
+#define SCTP_BATCH_HEADER_RESERVE 10
+
+/**
+ * @brief State of a batch container being built.
+ *
+ * The frame starts with `SCTP_BATCH_HEADER_RESERVE` unused bytes, since the
+ * header holds the message count and is only known at the end. `finish`
+ * writes it right-aligned into that space, so the container starts
+ * `header_skip` bytes into the frame and the messages never move.
+ */
+struct sctp_batch_encoder
+{
+    sctp_encoder_t *frame; ///< Reserved header space, the messages, then the offset table.
+    size_t count;          ///< Number of messages appended.
+    size_t header_skip;    ///< Unused bytes in front of the header, once finished.
+    bool offset_table;     ///< True if `finish` appends an offset table.
+    bool finished;         ///< True once `finish` has written the header.
+};
+
+/** @brief Empties the frame and reserves the header space again. */
+static void _sctp_encoder_batch_clear(sctp_batch_encoder_t *batch)
+{
+    sctp_encoder_reset(batch->frame);
+    if (_sctp_encoder_reserve(batch->frame, SCTP_BATCH_HEADER_RESERVE) != SCTP_OK)
+        LEA_ABORT();
+    batch->frame->position = SCTP_BATCH_HEADER_RESERVE;
+    batch->count = 0;
+    batch->header_skip = 0;
+    batch->finished = false;
+}
+
+/** @brief Writes `value` as ULEB128 into `out`, which must hold 10 bytes. */
+static size_t _sctp_encoder_batch_uleb128(uint8_t *out, uint64_t value)
+{
+    size_t length = 0;
+    do
+    {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        out[length++] = value ? (byte | 0x80) : byte;
+    } while (value);
+    return length;
+}
+
+static int _sctp_encoder_batch_append(sctp_batch_encoder_t *batch, const void *message, size_t size)
+{
+    if (batch->finished)
+        return SCTP_ERR_INVALID_ARG;
+    sctp_encoder_t *frame = batch->frame;
+    const size_t prefix = _sctp_encoder_uleb128_size(size);
+    if (size > SIZE_MAX - prefix)
+        return SCTP_ERR_NO_SPACE;
+    if (batch->offset_table)
+    {
+        // The whole container, including the table entry of this message,
+        // must stay addressable by 32-bit offsets.
+        const uint64_t total = (uint64_t)frame->position + prefix + size + 4 * ((uint64_t)batch->count + 1);
+        if (size > UINT32_MAX || total > UINT32_MAX)
+            return SCTP_ERR_NO_SPACE;
+    }
+    int status = _sctp_encoder_reserve(frame, prefix + size);
+    if (status != SCTP_OK)
+        return status;
+    _sctp_encoder_put_uleb128(frame, size);
+    if (size)
+        _sctp_encoder_put_data(frame, message, size);
+    batch->count++;
+    return SCTP_OK;
+}
+
+/**
+ * @brief Appends the offset table, given the final header length.
+ *
+ * The offsets are recovered by walking the length prefixes, so nothing has
+ * to be recorded while messages are appended.
+ */
+static int _sctp_encoder_batch_write_table(sctp_batch_encoder_t *batch, size_t header_length)
+{
+    sctp_encoder_t *frame = batch->frame;
+    const size_t end = frame->position;
+    int status = _sctp_encoder_reserve(frame, 4 * batch->count);
+    if (status != SCTP_OK)
+        return status;
+    size_t position = SCTP_BATCH_HEADER_RESERVE;
+    while (position < end)
+    {
+        const uint32_t offset = (uint32_t)(position - SCTP_BATCH_HEADER_RESERVE + header_length);
+        const uint8_t entry[4] = {(uint8_t)offset, (uint8_t)(offset >> 8), (uint8_t)(offset >> 16),
+                                  (uint8_t)(offset >> 24)};
+        _sctp_encoder_put_data(frame, entry, sizeof(entry));
+
+        uint64_t length = 0;
+        unsigned shift = 0;
+        uint8_t byte;
+        do
+        {
+            byte = frame->buffer[position++];
+            length |= (uint64_t)(byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        position += (size_t)length;
+    }
+    return SCTP_OK;
+}
+
+SCTP_EXPORT(sctp_batch_encoder_create)
+sctp_batch_encoder_t *sctp_batch_encoder_create(size_t capacity, bool offset_table)
+{
+    sctp_batch_encoder_t *batch = malloc(sizeof(sctp_batch_encoder_t));
+    if (!batch)
+        LEA_ABORT();
+    if (capacity > SIZE_MAX - SCTP_BATCH_HEADER_RESERVE)
+        LEA_ABORT();
+    batch->frame = sctp_encoder_create(capacity + SCTP_BATCH_HEADER_RESERVE);
+    sctp_encoder_set_growth(batch->frame, SCTP_GROWTH_GEOMETRIC, 0);
+    batch->offset_table = offset_table;
+    _sctp_encoder_batch_clear(batch);
+    return batch;
+}
+
+SCTP_EXPORT(sctp_batch_encoder_append)
+void sctp_batch_encoder_append(sctp_batch_encoder_t *batch, const void *message, size_t size)
+{
+    if (!batch || (!message && size))
+        LEA_ABORT();
+    if (_sctp_encoder_batch_append(batch, message, size) != SCTP_OK)
+        LEA_ABORT();
+}
+
+SCTP_EXPORT(sctp_batch_encoder_try_append)
+int sctp_batch_encoder_try_append(sctp_batch_encoder_t *batch, const void *message, size_t size)
+{
+    if (!batch || (!message && size))
+        return SCTP_ERR_INVALID_ARG;
+    return _sctp_encoder_batch_append(batch, message, size);
+}
+
+SCTP_EXPORT(sctp_batch_encoder_count)
+size_t sctp_batch_encoder_count(const sctp_batch_encoder_t *batch)
+{
+    if (!batch)
+        LEA_ABORT();
+    return batch->count;
+}
+
+SCTP_EXPORT(sctp_batch_encoder_finish)
+const void *sctp_batch_encoder_finish(sctp_batch_encoder_t *batch, size_t *size)
+{
+    if (!batch || !size)
+        LEA_ABORT();
+    sctp_encoder_t *frame = batch->frame;
+    if (!batch->finished)
+    {
+        uint8_t header[SCTP_BATCH_HEADER_RESERVE];
+        const size_t header_length =
+            _sctp_encoder_batch_uleb128(header, ((uint64_t)batch->count << 1) | (batch->offset_table ? 1 : 0));
+        if (batch->offset_table && _sctp_encoder_batch_write_table(batch, header_length) != SCTP_OK)
+            LEA_ABORT();
+        batch->header_skip = SCTP_BATCH_HEADER_RESERVE - header_length;
+        memcpy(frame->buffer + batch->header_skip, header, header_length);
+        batch->finished = true;
+    }
+    *size = frame->position - batch->header_skip;
+    return frame->buffer + batch->header_skip;
+}
+
+SCTP_EXPORT(sctp_batch_encoder_reset)
+void sctp_batch_encoder_reset(sctp_batch_encoder_t *batch)
+{
+    if (!batch)
+        LEA_ABORT();
+    _sctp_encoder_batch_clear(batch);
+}
+
+SCTP_EXPORT(sctp_batch_encoder_free)
+void sctp_batch_encoder_free(sctp_batch_encoder_t *batch)
+{
+    if (!batch)
+        return;
+    sctp_encoder_free(batch->frame);
+    free(batch);
+}
+
+// --- Encoder Singleton API Implementation ---
+//
+// These functions operate on a global encoder instance and are thin wrappers
+// around the instance API above.
+
+SCTP_EXPORT(sctp_encoder_init)
+void sctp_encoder_init(size_t capacity)
+{
+    allocator_reset();
+    g_encoder = sctp_encoder_create(capacity);
+}
+
+SCTP_EXPORT(sctp_encoder_global)
+sctp_encoder_t *sctp_encoder_global(void)
+{
+    return g_encoder;
+}
+
+SCTP_EXPORT(sctp_encoder_data)
+const uint8_t *sctp_encoder_data(void)
+{
+    return sctp_encoder_get_data(g_encoder);
+}
+
+SCTP_EXPORT(sctp_encoder_size)
+size_t sctp_encoder_size(void)
+{
+    return sctp_encoder_get_size(g_encoder);
+}
+
+SCTP_EXPORT(sctp_encoder_remaining)
+size_t sctp_encoder_remaining(void)
+{
+    return sctp_encoder_get_remaining(g_encoder);
+}
+
+SCTP_EXPORT(sctp_encoder_add_vector)
+void *sctp_encoder_add_vector(size_t length)
+{
+    return sctp_encoder_add_vector_to(g_encoder, length);
+}
+
+SCTP_EXPORT(sctp_encoder_add_vector_data)
+void sctp_encoder_add_vector_data(const void *data, size_t length)
+{
+    sctp_encoder_add_vector_data_to(g_encoder, data, length);
+}
+
+SCTP_EXPORT(sctp_encoder_add_vector_external)
+void sctp_encoder_add_vector_external(size_t length, uint32_t tag)
+{
+    sctp_encoder_add_vector_external_to(g_encoder, length, tag);
+}
+
+SCTP_EXPORT(sctp_encoder_segments)
+const sctp_segment_t *sctp_encoder_segments(void)
+{
+    return sctp_encoder_get_segments(g_encoder);
+}
+
+SCTP_EXPORT(sctp_encoder_segment_count)
+size_t sctp_encoder_segment_count(void)
+{
+    return sctp_encoder_get_segment_count(g_encoder);
+}
+
+SCTP_EXPORT(sctp_encoder_gathered_size)
+size_t sctp_encoder_gathered_size(void)
+{
+    return sctp_encoder_get_gathered_size(g_encoder);
+}
+
+SCTP_EXPORT(sctp_encoder_add_packed)
+void *sctp_encoder_add_packed(sctp_type_t elem_type, size_t count)
+{
+    return sctp_encoder_add_packed_to(g_encoder, elem_type, count);
+}
+
+SCTP_EXPORT(sctp_encoder_add_raw)
+void* sctp_encoder_add_raw(size_t length)
+{
+    return sctp_encoder_add_raw_to(g_encoder, length);
+}
+
+SCTP_EXPORT(sctp_encoder_add_short)
+void sctp_encoder_add_short(uint8_t value)
+{
+    sctp_encoder_add_short_to(g_encoder, value);
+}
+
+SCTP_EXPORT(sctp_encoder_add_uleb128)
+void sctp_encoder_add_uleb128(uint64_t value)
+{
+    sctp_encoder_add_uleb128_to(g_encoder, value);
+}
+
+SCTP_EXPORT(sctp_encoder_add_sleb128)
+void sctp_encoder_add_sleb128(int64_t value)
+{
+    sctp_encoder_add_sleb128_to(g_encoder, value);
+}
+
+SCTP_EXPORT(sctp_encoder_add_uint_auto)
+void sctp_encoder_add_uint_auto(uint64_t value)
+{
+    sctp_encoder_add_uint_auto_to(g_encoder, value);
+}
+
+SCTP_EXPORT(sctp_encoder_add_int_auto)
+void sctp_encoder_add_int_auto(int64_t value)
+{
+    sctp_encoder_add_int_auto_to(g_encoder, value);
+}
+
+SCTP_EXPORT(sctp_encoder_add_eof)
+void sctp_encoder_add_eof(void)
+{
+    sctp_encoder_add_eof_to(g_encoder);
+}
+
+SCTP_EXPORT(sctp_encoder_add_uleb128_array)
+void sctp_encoder_add_uleb128_array(const uint64_t *values, size_t count)
+{
+    sctp_encoder_add_uleb128_array_to(g_encoder, values, count);
+}
+
+SCTP_EXPORT(sctp_encoder_add_sleb128_array)
+void sctp_encoder_add_sleb128_array(const int64_t *values, size_t count)
+{
+    sctp_encoder_add_sleb128_array_to(g_encoder, values, count);
 }
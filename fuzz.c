@@ -0,0 +1,502 @@
+/**
+ * @file fuzz.c
+ * @brief Coverage-guided fuzz target for the decoder and encoder.
+ *
+ * Defines `LLVMFuzzerTestOneInput`, so the same file builds with libFuzzer
+ * (`make fuzz`), with AFL++ (`afl-clang-fast -fsanitize=fuzzer`) or with
+ * `native/fuzz_main.c`, which replays files (`make fuzz-replay`). The raw
+ * input mostly reaches functions that must not abort on malformed data, so
+ * an abort, a sanitizer report or a failed property is always a bug. The
+ * one exception is `sctp_decoder_skip`: the fuzz builds define
+ * `LEA_ABORT_HOOK`, and an abort inside the skip walk returns to the walk
+ * as an expected failure. For each input the target:
+ *
+ * - validates it, and walks it with `sctp_decoder_try_next`, which must agree
+ *   with `sctp_validate` on the status and the offending offset;
+ * - walks it again with checksum verification on;
+ * - skips through it one field at a time, which must move forward within the
+ *   input on every field or abort, and must land where `try_next` does;
+ * - if the skip walk reaches the end, builds an index over it, which must
+ *   have increasing offsets and the same field count, and with
+ *   `SCTP_PARALLEL` decodes its blocks in parallel, which must agree with a
+ *   sequential run;
+ * - opens it as a batch container and validates the messages in it.
+ *
+ * If the input is a valid message, the target also:
+ *
+ * - decodes it with `sctp_decoder_next` and `sctp_decoder_skip`, which must
+ *   not abort;
+ * - re-encodes every field, with and without a dictionary, and checks that
+ *   both canonicalize to `sctp_canonicalize` of the input;
+ * - checks that the canonical form is a fixed point with the same hash;
+ * - feeds it to the streaming decoder in chunks and compares the fields.
+ *
+ * All of this is timed. An input that takes longer than a fixed base plus a
+ * per-byte allowance, counting the input and its canonical form, is reported
+ * as a failure, so super-linear decode paths show up as findings rather than
+ * as a slow campaign.
+ */
+
+#include "sctp.h"
+
+#include <setjmp.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// --- Configuration ---
+
+#ifndef SCTP_FUZZ_BUDGET_BASE_NS
+/** @brief Time any input may take, regardless of its size. */
+#define SCTP_FUZZ_BUDGET_BASE_NS 1000000
+#endif
+#ifndef SCTP_FUZZ_BUDGET_NS_PER_BYTE
+/** @brief Additional time allowed per byte of input and of canonical output. */
+#define SCTP_FUZZ_BUDGET_NS_PER_BYTE 250
+#endif
+/** @brief Runs over budget before an input is reported, so preemption is not mistaken for a slow path. */
+#define SCTP_FUZZ_ATTEMPTS 3
+
+/** @brief Payload width of each fixed-width type, indexed by `sctp_type_t`. */
+static const uint8_t sctp_fuzz_fixed_width[16] = {1, 1, 2, 2, 4, 4, 8, 8, 0, 0, 4, 8, 0, 0, 0, 0};
+
+/** @brief Encoders and buffers reused across inputs, so steady-state runs do not allocate. */
+static sctp_encoder_t *g_plain = NULL;
+static sctp_encoder_t *g_dedup = NULL;
+static uint8_t *g_canonical = NULL;
+static uint8_t *g_scratch = NULL;
+static size_t g_scratch_capacity = 0;
+
+/** @brief Where `LEA_ABORT` returns to while `g_trap_armed` is set. */
+static jmp_buf g_trap;
+static bool g_trap_armed = false;
+
+// --- Utility Functions ---
+
+/** @brief Reports a violated property and aborts, so the fuzzer saves the input. */
+static void _sctp_fuzz_check(bool condition, const char *property)
+{
+    if (!condition)
+    {
+        fprintf(stderr, "[FAIL] Fuzz property violated: %s\n", property);
+        LEA_ABORT();
+    }
+}
+
+/**
+ * @brief Called by `LEA_ABORT` in the library, which the fuzz builds compile
+ *        with `LEA_ABORT_HOOK=sctp_fuzz_abort`.
+ *
+ * While the trap is armed an abort is the expected failure of an aborting
+ * API on malformed input, and returns to the code that armed it. Otherwise
+ * it is a finding.
+ */
+_Noreturn void sctp_fuzz_abort(void)
+{
+    if (g_trap_armed)
+    {
+        g_trap_armed = false;
+        longjmp(g_trap, 1);
+    }
+    abort();
+}
+
+/** @brief Returns the monotonic clock in nanoseconds. */
+static uint64_t _sctp_fuzz_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/** @brief Makes both scratch buffers hold at least `size` bytes. */
+static void _sctp_fuzz_reserve(size_t size)
+{
+    if (size <= g_scratch_capacity)
+        return;
+    free(g_canonical);
+    free(g_scratch);
+    g_canonical = malloc(size);
+    g_scratch = malloc(size);
+    _sctp_fuzz_check(g_canonical && g_scratch, "scratch buffers can be allocated");
+    g_scratch_capacity = size;
+}
+
+/** @brief Creates the shared encoders on first use, and empties them. */
+static void _sctp_fuzz_reset_encoders(void)
+{
+    if (!g_plain)
+    {
+        g_plain = sctp_encoder_create(1024);
+        sctp_encoder_set_growth(g_plain, SCTP_GROWTH_GEOMETRIC, 0);
+        g_dedup = sctp_encoder_create(1024);
+        sctp_encoder_set_growth(g_dedup, SCTP_GROWTH_GEOMETRIC, 0);
+        _sctp_fuzz_check(sctp_encoder_set_dictionary(g_dedup, 64) == SCTP_OK, "dictionary can be allocated");
+    }
+    sctp_encoder_reset(g_plain);
+    sctp_encoder_reset(g_dedup);
+}
+
+// --- Properties ---
+
+/** @brief Appends the field a decoder has just read, using the encoder's own form for it. */
+static void _sctp_fuzz_encode_field(sctp_encoder_t *enc, const sctp_decoder_t *dec)
+{
+    const sctp_value_t *value = &dec->last_value;
+    switch (dec->last_type)
+    {
+    case SCTP_TYPE_INT8:
+        sctp_encoder_add_int8_to(enc, value->as_int8);
+        break;
+    case SCTP_TYPE_UINT8:
+        sctp_encoder_add_uint8_to(enc, value->as_uint8);
+        break;
+    case SCTP_TYPE_INT16:
+        sctp_encoder_add_int16_to(enc, value->as_int16);
+        break;
+    case SCTP_TYPE_UINT16:
+        sctp_encoder_add_uint16_to(enc, value->as_uint16);
+        break;
+    case SCTP_TYPE_INT32:
+        sctp_encoder_add_int32_to(enc, value->as_int32);
+        break;
+    case SCTP_TYPE_UINT32:
+        sctp_encoder_add_uint32_to(enc, value->as_uint32);
+        break;
+    case SCTP_TYPE_INT64:
+        sctp_encoder_add_int64_to(enc, value->as_int64);
+        break;
+    case SCTP_TYPE_UINT64:
+        sctp_encoder_add_uint64_to(enc, value->as_uint64);
+        break;
+    case SCTP_TYPE_ULEB128:
+        sctp_encoder_add_uleb128_to(enc, value->as_uleb128);
+        break;
+    case SCTP_TYPE_SLEB128:
+        sctp_encoder_add_sleb128_to(enc, value->as_sleb128);
+        break;
+    case SCTP_TYPE_FLOAT32:
+        sctp_encoder_add_float32_to(enc, value->as_float32);
+        break;
+    case SCTP_TYPE_FLOAT64:
+        sctp_encoder_add_float64_to(enc, value->as_float64);
+        break;
+    case SCTP_TYPE_SHORT:
+        sctp_encoder_add_short_to(enc, value->as_short);
+        break;
+    case SCTP_TYPE_VECTOR:
+        sctp_encoder_add_vector_data_to(enc, value->as_ptr, dec->last_size);
+        break;
+    case SCTP_TYPE_PACKED:
+    {
+        const size_t width = sctp_fuzz_fixed_width[dec->last_elem_type];
+        void *ptr = sctp_encoder_add_packed_to(enc, dec->last_elem_type, dec->last_size / width);
+        if (dec->last_size)
+            memcpy(ptr, value->as_ptr, dec->last_size);
+        break;
+    }
+    case SCTP_TYPE_EOF:
+        sctp_encoder_add_eof_to(enc);
+        break;
+    }
+}
+
+/** @brief Checks that the streaming decoder yields the same fields as a bound decoder. */
+static void _sctp_fuzz_stream(const uint8_t *data, size_t size)
+{
+    const size_t chunk = 1 + (size ? data[size - 1] % 16 : 0);
+    sctp_stream_decoder_t *sdec = sctp_stream_decoder_create();
+    sctp_decoder_t dec;
+    sctp_decoder_bind(&dec, data, size);
+    size_t offset = 0;
+    sctp_field_t field;
+    for (;;)
+    {
+        int status = sctp_stream_decoder_next(sdec, &field);
+        if (status == SCTP_NEED_MORE && offset < size)
+        {
+            const size_t n = size - offset < chunk ? size - offset : chunk;
+            _sctp_fuzz_check(sctp_stream_decoder_feed(sdec, data + offset, n) == SCTP_OK, "stream feed");
+            offset += n;
+            continue;
+        }
+        const sctp_type_t type = sctp_decoder_next(&dec);
+        if (status == SCTP_NEED_MORE)
+        {
+            // The input ended without an EOF field.
+            _sctp_fuzz_check(type == SCTP_TYPE_EOF && sctp_stream_decoder_buffered(sdec) == 0,
+                             "stream decoder ends with the input");
+            break;
+        }
+        if (status == SCTP_ERR_RESERVED_TYPE)
+        {
+            // Back-references cannot be streamed; the bound decoder resolved one.
+            _sctp_fuzz_check(type == SCTP_TYPE_VECTOR, "stream decoder rejects only back-references");
+            break;
+        }
+        _sctp_fuzz_check(status == SCTP_OK && field.type == type && field.size == dec.last_size,
+                         "stream decoder yields the same field");
+        if (type == SCTP_TYPE_VECTOR || type == SCTP_TYPE_PACKED)
+            _sctp_fuzz_check(memcmp(field.value.as_ptr, dec.last_value.as_ptr, field.size) == 0,
+                             "stream decoder yields the same data");
+        else if (type == SCTP_TYPE_SHORT)
+            _sctp_fuzz_check(field.value.as_short == dec.last_value.as_short, "stream decoder yields the same value");
+        else if (type != SCTP_TYPE_EOF)
+            _sctp_fuzz_check(field.value.as_uint64 == dec.last_value.as_uint64, "stream decoder yields the same value");
+        if (type == SCTP_TYPE_EOF)
+            break;
+    }
+    sctp_stream_decoder_free(sdec);
+}
+
+/**
+ * @brief Skips through raw input one field at a time.
+ *
+ * `sctp_decoder_skip` may abort on malformed input, but every field it does
+ * skip must move the position forward without leaving the input, and a
+ * field `sctp_decoder_try_next` accepts must be skipped to the same place.
+ *
+ * @return The number of fields skipped before an EOF field or the end of the
+ *         input, or `SIZE_MAX` if skipping aborted.
+ */
+static size_t _sctp_fuzz_skip_walk(const uint8_t *data, size_t size)
+{
+    static sctp_decoder_t dec;
+    static size_t fields;
+    sctp_decoder_t probe;
+    sctp_decoder_bind(&dec, data, size);
+    sctp_decoder_bind(&probe, data, size);
+    fields = 0;
+    if (setjmp(g_trap))
+        return SIZE_MAX;
+    for (;;)
+    {
+        const size_t start = dec.position;
+        sctp_decoder_seek(&probe, start);
+        const int status = sctp_decoder_try_next(&probe);
+        // Only the skip itself may abort; anywhere else an abort is a finding.
+        g_trap_armed = true;
+        const size_t skipped = sctp_decoder_skip(&dec, 1);
+        g_trap_armed = false;
+        if (skipped == 0)
+        {
+            _sctp_fuzz_check(dec.position == start && (start == size || (data[start] & 0x0F) == SCTP_TYPE_EOF),
+                             "skip stops only at EOF or the end");
+            break;
+        }
+        _sctp_fuzz_check(dec.position > start && dec.position <= size, "skip moves forward within the input");
+        if (status == SCTP_OK)
+            _sctp_fuzz_check(dec.position == probe.position, "skip lands where try_next does");
+        fields++;
+    }
+    return fields;
+}
+
+#ifdef SCTP_PARALLEL
+/** @brief Per-block results of one parallel or sequential run. */
+typedef struct
+{
+    size_t *fields; ///< Fields read from each block.
+    size_t merged;  ///< Blocks merged so far.
+} sctp_fuzz_blocks_t;
+
+/** @brief Reads a block with `sctp_decoder_try_next` and records its field count. */
+static int _sctp_fuzz_block(sctp_decoder_t *dec, size_t block, void *context)
+{
+    sctp_fuzz_blocks_t *blocks = context;
+    size_t fields = 0;
+    int status;
+    while ((status = sctp_decoder_try_next(dec)) == SCTP_OK && dec->last_type != SCTP_TYPE_EOF)
+        fields++;
+    blocks->fields[block] = fields;
+    return status;
+}
+
+static void _sctp_fuzz_merge(size_t block, void *context)
+{
+    sctp_fuzz_blocks_t *blocks = context;
+    _sctp_fuzz_check(block == blocks->merged, "blocks are merged in order");
+    blocks->merged++;
+}
+
+/** @brief Checks that a parallel decode agrees with decoding the blocks one after another. */
+static void _sctp_fuzz_parallel(const uint8_t *data, size_t size, const sctp_index_t *index)
+{
+    sctp_fuzz_blocks_t parallel = {malloc(index->count * sizeof(size_t)), 0};
+    sctp_fuzz_blocks_t sequential = {malloc(index->count * sizeof(size_t)), 0};
+    _sctp_fuzz_check(parallel.fields && sequential.fields, "block results can be allocated");
+
+    int expected = SCTP_OK;
+    size_t good = 0;
+    for (; good < index->count; good++)
+    {
+        const size_t start = index->offsets[good];
+        const size_t end = good + 1 < index->count ? index->offsets[good + 1] : size;
+        sctp_decoder_t dec;
+        sctp_decoder_bind(&dec, data + start, end - start);
+        dec.origin = data;
+        expected = _sctp_fuzz_block(&dec, good, &sequential);
+        if (expected != SCTP_OK)
+            break;
+        if (good + 1 < index->count)
+            _sctp_fuzz_check(sequential.fields[good] == index->stride, "a block holds stride fields");
+    }
+
+    const size_t threads = 2 + (size ? data[0] % 3 : 0);
+    _sctp_fuzz_check(sctp_index_decode_parallel(data, size, index, threads, _sctp_fuzz_block, _sctp_fuzz_merge,
+                                                &parallel) == expected,
+                     "parallel decode reports the first failed block");
+    _sctp_fuzz_check(parallel.merged == good, "parallel decode merges the blocks before the failure");
+    for (size_t block = 0; block < good; block++)
+        _sctp_fuzz_check(parallel.fields[block] == sequential.fields[block], "parallel decode reads the same fields");
+    free(parallel.fields);
+    free(sequential.fields);
+}
+#endif
+
+/**
+ * @brief Builds an index over input that skips cleanly and checks it.
+ *
+ * `sctp_index_build` walks like `sctp_decoder_skip`, so after a complete
+ * skip walk it must not abort.
+ */
+static void _sctp_fuzz_index(const uint8_t *data, size_t size, size_t fields)
+{
+    const size_t stride = 1 + (size ? data[size - 1] % 8 : 0);
+    sctp_index_t *index = sctp_index_build(data, size, stride);
+    _sctp_fuzz_check(index->fields == fields && index->count == fields / stride + 1 && index->offsets[0] == 0,
+                     "the index counts the same fields");
+    for (size_t i = 1; i < index->count; i++)
+        _sctp_fuzz_check(index->offsets[i] > index->offsets[i - 1] && index->offsets[i] <= size,
+                         "index offsets increase within the input");
+#ifdef SCTP_PARALLEL
+    _sctp_fuzz_parallel(data, size, index);
+#endif
+    free(index);
+}
+
+/**
+ * @brief Runs the properties that hold for a valid message.
+ * @return The size of its canonical form, which counts towards the time budget.
+ */
+static size_t _sctp_fuzz_valid(const uint8_t *data, size_t size, size_t fields)
+{
+    size_t canonical_size;
+    _sctp_fuzz_check(sctp_canonicalize(data, size, NULL, 0, &canonical_size) == SCTP_OK,
+                     "a valid message can be canonicalized");
+    _sctp_fuzz_reserve(canonical_size);
+    size_t n;
+    _sctp_fuzz_check(sctp_canonicalize(data, size, g_canonical, canonical_size, &n) == SCTP_OK &&
+                         n == canonical_size,
+                     "the canonical size is exact");
+    _sctp_fuzz_check(sctp_validate(g_canonical, canonical_size, NULL) == SCTP_OK, "the canonical form is valid");
+    _sctp_fuzz_check(sctp_canonicalize(g_canonical, canonical_size, g_scratch, canonical_size, &n) == SCTP_OK &&
+                         n == canonical_size && memcmp(g_scratch, g_canonical, n) == 0,
+                     "the canonical form is a fixed point");
+    uint64_t hash, canonical_hash;
+    _sctp_fuzz_check(sctp_canonical_hash(data, size, &hash) == SCTP_OK &&
+                         sctp_canonical_hash(g_canonical, canonical_size, &canonical_hash) == SCTP_OK &&
+                         hash == canonical_hash,
+                     "a message and its canonical form hash equally");
+
+    // Decoding must not abort on a message sctp_validate accepted, and
+    // encoding what was decoded must reproduce the canonical form.
+    _sctp_fuzz_reset_encoders();
+    sctp_decoder_t dec;
+    sctp_decoder_bind(&dec, data, size);
+    for (;;)
+    {
+        const sctp_type_t type = sctp_decoder_next(&dec);
+        _sctp_fuzz_encode_field(g_plain, &dec);
+        _sctp_fuzz_encode_field(g_dedup, &dec);
+        if (type == SCTP_TYPE_EOF)
+            break;
+    }
+    _sctp_fuzz_check(sctp_encoder_get_size(g_plain) == canonical_size &&
+                         memcmp(sctp_encoder_get_data(g_plain), g_canonical, canonical_size) == 0,
+                     "re-encoding the decoded fields gives the canonical form");
+    _sctp_fuzz_check(sctp_canonicalize(sctp_encoder_get_data(g_dedup), sctp_encoder_get_size(g_dedup), g_scratch,
+                                       canonical_size, &n) == SCTP_OK &&
+                         n == canonical_size && memcmp(g_scratch, g_canonical, n) == 0,
+                     "re-encoding with a dictionary gives the same fields");
+
+    sctp_decoder_bind(&dec, data, size);
+    _sctp_fuzz_check(sctp_decoder_skip(&dec, SIZE_MAX) == fields, "skip counts the same fields");
+    _sctp_fuzz_check(sctp_decoder_next(&dec) == SCTP_TYPE_EOF, "skip stops at the end");
+
+    _sctp_fuzz_stream(data, size);
+    return canonical_size;
+}
+
+/**
+ * @brief Runs every property on one input.
+ * @return The number of bytes processed, for the time budget.
+ */
+static size_t _sctp_fuzz_run(const uint8_t *data, size_t size)
+{
+    size_t error_position = 0;
+    const int status = sctp_validate(data, size, &error_position);
+
+    sctp_decoder_t dec;
+    sctp_decoder_bind(&dec, data, size);
+    int walk;
+    size_t fields = 0;
+    while ((walk = sctp_decoder_try_next(&dec)) == SCTP_OK && dec.last_type != SCTP_TYPE_EOF)
+        _sctp_fuzz_check(++fields <= size, "try_next consumes input");
+    _sctp_fuzz_check(walk == status, "try_next agrees with sctp_validate");
+    if (status != SCTP_OK)
+        _sctp_fuzz_check(dec.position == error_position, "try_next stops where sctp_validate does");
+
+    sctp_decoder_bind(&dec, data, size);
+    sctp_decoder_set_checksum(&dec, true);
+    while ((walk = sctp_decoder_try_next(&dec)) == SCTP_OK && dec.last_type != SCTP_TYPE_EOF)
+        ;
+    _sctp_fuzz_check(walk == status || walk == SCTP_ERR_CHECKSUM, "checksum verification reports only checksums");
+
+    const size_t skipped = _sctp_fuzz_skip_walk(data, size);
+    if (status == SCTP_OK)
+        _sctp_fuzz_check(skipped == fields, "skip accepts a valid message");
+    if (skipped != SIZE_MAX)
+        _sctp_fuzz_index(data, size, skipped);
+
+    sctp_batch_reader_t reader;
+    if (sctp_batch_open(&reader, data, size) == SCTP_OK)
+    {
+        size_t count = 0;
+        while (sctp_batch_next(&reader, &dec))
+        {
+            sctp_validate(dec.data, dec.size, NULL);
+            count++;
+        }
+        _sctp_fuzz_check(count == reader.count, "a batch yields every message");
+        if (count)
+            _sctp_fuzz_check(sctp_batch_message(&reader, count - 1, &dec) == SCTP_OK, "the last message is reachable");
+        _sctp_fuzz_check(sctp_batch_message(&reader, count, &dec) == SCTP_ERR_INVALID_ARG,
+                         "messages past the end are rejected");
+    }
+
+    if (status != SCTP_OK)
+        return size;
+    return size + _sctp_fuzz_valid(data, size, fields);
+}
+
+// --- Fuzzer Entry Point ---
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    for (int attempt = 1;; attempt++)
+    {
+        const uint64_t start = _sctp_fuzz_now_ns();
+        const size_t work = _sctp_fuzz_run(data, size);
+        const uint64_t elapsed = _sctp_fuzz_now_ns() - start;
+        const uint64_t budget = SCTP_FUZZ_BUDGET_BASE_NS + (uint64_t)work * SCTP_FUZZ_BUDGET_NS_PER_BYTE;
+        if (elapsed <= budget)
+            return 0;
+        if (attempt == SCTP_FUZZ_ATTEMPTS)
+        {
+            fprintf(stderr, "[FAIL] Slow input: %zu bytes (%zu processed) took %llu ns, budget %llu ns\n", size,
+                    work, (unsigned long long)elapsed, (unsigned long long)budget);
+            LEA_ABORT();
+        }
+    }
+}
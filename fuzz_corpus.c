@@ -0,0 +1,210 @@
+#include "sctp.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @file fuzz_corpus.c
+ * @brief Writes the seed corpus for fuzz.c.
+ *
+ * Run as `fuzz_corpus <directory>`; `make fuzz-corpus` does this. The seeds
+ * are the message shapes test.c exercises, built with the same encoder
+ * calls: every field type at its boundary values, each vector and packed
+ * length form, back-references, checksum trailers and batch containers. A
+ * few hand-written seeds start the fuzzer next to the inputs most likely to
+ * hit slow paths: over-long LEB128 runs, length prefixes far past the end
+ * of the input or large enough to wrap, and many back-references to one
+ * large vector.
+ */
+
+static const char *g_directory;
+static int g_seeds = 0;
+
+/** @brief Writes one seed file. */
+static void write_seed(const char *name, const void *data, size_t size)
+{
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/%02d-%s.sctp", g_directory, g_seeds, name);
+    FILE *file = fopen(path, "wb");
+    if (!file || fwrite(data, 1, size, file) != size || fclose(file) != 0)
+    {
+        fprintf(stderr, "Cannot write %s\n", path);
+        exit(1);
+    }
+    g_seeds++;
+}
+
+/** @brief Writes an encoder's output as a seed and empties the encoder. */
+static void write_encoder(const char *name, sctp_encoder_t *enc)
+{
+    write_seed(name, sctp_encoder_get_data(enc), sctp_encoder_get_size(enc));
+    sctp_encoder_reset(enc);
+}
+
+// --- Encoded Seeds ---
+
+static void seed_scalars(sctp_encoder_t *enc)
+{
+    sctp_encoder_add_int8_to(enc, INT8_MIN);
+    sctp_encoder_add_uint8_to(enc, UINT8_MAX);
+    sctp_encoder_add_int16_to(enc, INT16_MIN);
+    sctp_encoder_add_uint16_to(enc, UINT16_MAX);
+    sctp_encoder_add_int32_to(enc, INT32_MIN);
+    sctp_encoder_add_uint32_to(enc, UINT32_MAX);
+    sctp_encoder_add_int64_to(enc, INT64_MIN);
+    sctp_encoder_add_uint64_to(enc, UINT64_MAX);
+    sctp_encoder_add_float32_to(enc, -0.0f);
+    sctp_encoder_add_float64_to(enc, 1.0 / 3.0);
+    for (uint8_t i = 0; i < 16; i++)
+        sctp_encoder_add_short_to(enc, i);
+    sctp_encoder_add_eof_to(enc);
+    write_encoder("scalars", enc);
+
+    const uint64_t ulebs[] = {0, 127, 128, 16383, 16384, UINT32_MAX, UINT64_MAX};
+    const int64_t slebs[] = {0, -1, 63, -64, 64, -65, INT64_MIN, INT64_MAX};
+    for (size_t i = 0; i < sizeof(ulebs) / sizeof(ulebs[0]); i++)
+        sctp_encoder_add_uleb128_to(enc, ulebs[i]);
+    for (size_t i = 0; i < sizeof(slebs) / sizeof(slebs[0]); i++)
+        sctp_encoder_add_sleb128_to(enc, slebs[i]);
+    sctp_encoder_add_eof_to(enc);
+    write_encoder("leb128", enc);
+
+    sctp_encoder_add_uleb128_array_to(enc, ulebs, sizeof(ulebs) / sizeof(ulebs[0]));
+    sctp_encoder_add_sleb128_array_to(enc, slebs, sizeof(slebs) / sizeof(slebs[0]));
+    write_encoder("leb128-arrays-no-eof", enc);
+
+    for (size_t i = 0; i < sizeof(slebs) / sizeof(slebs[0]); i++)
+    {
+        sctp_encoder_add_uint_auto_to(enc, (uint64_t)slebs[i]);
+        sctp_encoder_add_int_auto_to(enc, slebs[i]);
+    }
+    sctp_encoder_add_eof_to(enc);
+    write_encoder("auto-width", enc);
+}
+
+static void seed_vectors(sctp_encoder_t *enc)
+{
+    uint8_t bytes[300];
+    for (size_t i = 0; i < sizeof(bytes); i++)
+        bytes[i] = (uint8_t)(i * 31);
+    const size_t lengths[] = {0, 1, 14, 15, 127, 128, 300};
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+        sctp_encoder_add_vector_data_to(enc, bytes, lengths[i]);
+    sctp_encoder_add_eof_to(enc);
+    write_encoder("vectors", enc);
+
+    const uint16_t words[] = {1, 0x8000, 0xFFFF};
+    const uint32_t dwords[] = {0, 1, 0x80000000u, UINT32_MAX};
+    const uint64_t qwords[] = {1, UINT64_MAX};
+    const double doubles[] = {0.5, -2.0};
+    sctp_encoder_add_packed_uint8_to(enc, bytes, 0);
+    sctp_encoder_add_packed_int8_to(enc, (const int8_t *)bytes, 20);
+    sctp_encoder_add_packed_uint16_to(enc, words, 3);
+    sctp_encoder_add_packed_uint32_to(enc, dwords, 4);
+    sctp_encoder_add_packed_uint64_to(enc, qwords, 2);
+    sctp_encoder_add_packed_float64_to(enc, doubles, 2);
+    sctp_encoder_add_eof_to(enc);
+    write_encoder("packed", enc);
+
+    // Repeated vectors become back-references, including back-to-back ones.
+    sctp_encoder_set_dictionary(enc, 16);
+    for (int i = 0; i < 3; i++)
+    {
+        sctp_encoder_add_vector_data_to(enc, bytes, 32);
+        sctp_encoder_add_uint32_to(enc, (uint32_t)i);
+        sctp_encoder_add_vector_data_to(enc, bytes + 32, 20);
+    }
+    sctp_encoder_add_eof_to(enc);
+    write_encoder("back-references", enc);
+
+    // Many short references to one large vector expand to far more output than input.
+    sctp_encoder_add_vector_data_to(enc, bytes, sizeof(bytes));
+    for (int i = 0; i < 200; i++)
+        sctp_encoder_add_vector_data_to(enc, bytes, sizeof(bytes));
+    sctp_encoder_add_eof_to(enc);
+    write_encoder("reference-fan-out", enc);
+    sctp_encoder_set_dictionary(enc, 0);
+}
+
+static void seed_containers(sctp_encoder_t *enc)
+{
+    sctp_encoder_set_checksum(enc, true);
+    sctp_encoder_add_uint64_to(enc, 42);
+    sctp_encoder_add_vector_data_to(enc, "checksummed", 11);
+    sctp_encoder_add_checksum_to(enc);
+    sctp_encoder_add_eof_to(enc);
+    write_encoder("checksum", enc);
+    sctp_encoder_set_checksum(enc, false);
+
+    for (int table = 0; table < 2; table++)
+    {
+        sctp_batch_encoder_t *batch = sctp_batch_encoder_create(256, table);
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            sctp_encoder_add_short_to(enc, i);
+            sctp_encoder_add_uleb128_to(enc, 1000u * i);
+            sctp_encoder_add_eof_to(enc);
+            sctp_batch_encoder_append(batch, sctp_encoder_get_data(enc), sctp_encoder_get_size(enc));
+            sctp_encoder_reset(enc);
+        }
+        size_t size;
+        const void *container = sctp_batch_encoder_finish(batch, &size);
+        write_seed(table ? "batch-offset-table" : "batch", container, size);
+        sctp_batch_encoder_free(batch);
+    }
+}
+
+// --- Hand-Written Seeds ---
+
+static void seed_pathological(void)
+{
+    // A ULEB128 with redundant continuation bytes, then one that overflows.
+    const uint8_t overlong[] = {0x08, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00,
+                                0x08, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0x0F};
+    write_seed("leb128-overlong", overlong, sizeof(overlong));
+
+    // A vector length prefix kept going far past ten bytes.
+    uint8_t run[64];
+    run[0] = 0xFD;
+    memset(run + 1, 0x80, sizeof(run) - 2);
+    run[sizeof(run) - 1] = 0x00;
+    write_seed("leb128-run", run, sizeof(run));
+
+    // Vector and packed lengths claiming far more data than follows.
+    const uint8_t bombs[] = {0xFD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3F, 1, 2, 3,
+                             0x7E, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 1, 2, 3, 4, 5, 6, 7, 8};
+    write_seed("length-bombs", bombs, sizeof(bombs));
+
+    // A vector length of 2^64 - 11, which wraps `position + length` back to the start.
+    const uint8_t wrapping[] = {0xFD, 0xF5, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0x0F};
+    write_seed("length-wraps", wrapping, sizeof(wrapping));
+
+    // A back-reference pointing before the start of the input.
+    const uint8_t reference[] = {0x4D, 0x01, 0x02, 0x03, 0x04, 0xDE, 0x20, 0x0F};
+    write_seed("reference-out-of-range", reference, sizeof(reference));
+
+    // Bytes after EOF, and an empty input.
+    const uint8_t trailing[] = {0x0C, 0x0F, 0x00};
+    write_seed("trailing-data", trailing, sizeof(trailing));
+    write_seed("empty", trailing, 0);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: %s <directory>\n", argv[0]);
+        return 1;
+    }
+    g_directory = argv[1];
+
+    sctp_encoder_t *enc = sctp_encoder_create(1024);
+    sctp_encoder_set_growth(enc, SCTP_GROWTH_GEOMETRIC, 0);
+    seed_scalars(enc);
+    seed_vectors(enc);
+    seed_containers(enc);
+    seed_pathological();
+    sctp_encoder_free(enc);
+
+    printf("Wrote %d seeds to %s\n", g_seeds, g_directory);
+    return 0;
+}
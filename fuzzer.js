@@ -21,7 +21,7 @@ const sctp_type_enum = {
     SCTP_TYPE_FLOAT32: 10, SCTP_TYPE_FLOAT64: 11,
     SCTP_TYPE_SHORT: 12,
     SCTP_TYPE_VECTOR: 13,
-    SCTP_TYPE_RESERVED: 14,
+    SCTP_TYPE_PACKED: 14,
     SCTP_TYPE_EOF: 15,
 };
 const ALL_TYPES = Object.values(sctp_type_enum);
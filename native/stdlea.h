@@ -0,0 +1,49 @@
+#ifndef STDLEA_H
+#define STDLEA_H
+
+/**
+ * @file stdlea.h
+ * @brief Portable stand-in for stdlea, for building SCTP as a native library.
+ *
+ * Provides the small part of the stdlea API that SCTP uses, mapped onto the
+ * C library. Put this directory on the include path instead of stdlea when
+ * compiling for a native target; `make native` does this.
+ *
+ * - `LEA_EXPORT(name)` marks a function as part of the public ABI of the
+ *   shared library.
+ * - `LEA_IMPORT(module, name)` expands to nothing. Host imports such as
+ *   `__sctp_data_handler` become ordinary external functions that the
+ *   application must define.
+ * - `LEA_ABORT()` flushes stdio and calls `abort()`, so output printed before
+ *   the failure is not lost. When `LEA_ABORT_HOOK` names a function, that
+ *   function is called instead of `abort()`; the fuzz builds use this to
+ *   catch the expected aborts of aborting APIs on malformed input.
+ * - `allocator_reset()` does nothing. Memory comes from `malloc` and is
+ *   released with `free`, rather than being reclaimed by resetting a bump
+ *   allocator.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#define LEA_EXPORT(name) __declspec(dllexport)
+#else
+#define LEA_EXPORT(name) __attribute__((visibility("default")))
+#endif
+
+#define LEA_IMPORT(module, name)
+
+#ifdef LEA_ABORT_HOOK
+_Noreturn void LEA_ABORT_HOOK(void);
+#define LEA_ABORT() (fflush(NULL), LEA_ABORT_HOOK())
+#else
+#define LEA_ABORT() (fflush(NULL), abort())
+#endif
+
+static inline void allocator_reset(void)
+{
+}
+
+#endif // STDLEA_H
@@ -0,0 +1,11 @@
+/**
+ * @file test_main.c
+ * @brief Native entry point for test.c, which the wasm build calls through `run_test`.
+ */
+
+int run_test(void);
+
+int main(void)
+{
+    return run_test();
+}
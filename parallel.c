@@ -0,0 +1,144 @@
+#include "sctp.h"
+
+/**
+ * @file parallel.c
+ * @brief Decodes the blocks of an indexed stream on several threads.
+ *
+ * Compiled in with `SCTP_PARALLEL`, which needs POSIX threads and C11
+ * atomics: a native build, or a wasm build with threads and shared memory.
+ * Each index entry starts a block of `stride` fields. Workers claim blocks
+ * one at a time from a shared atomic counter, so a thread that draws cheap
+ * blocks simply claims more of them, and runs of large vectors do not hold
+ * the other threads up.
+ */
+
+#ifdef SCTP_PARALLEL
+#include <pthread.h>
+#include <stdatomic.h>
+
+/** @brief Marks a block that has not been decoded. */
+#define SCTP_BLOCK_PENDING SCTP_NEED_MORE
+
+/**
+ * @brief Upper bound on the workers of one call, including the caller.
+ *
+ * Can be overridden on the compiler command line.
+ */
+#ifndef SCTP_PARALLEL_MAX_THREADS
+#define SCTP_PARALLEL_MAX_THREADS 256
+#endif
+
+/** @brief State shared by the workers of one `sctp_index_decode_parallel` call. */
+typedef struct
+{
+    const uint8_t *data;           ///< The encoded stream.
+    size_t size;                   ///< Size of the stream.
+    const sctp_index_t *index;     ///< Index over the stream.
+    sctp_block_handler_t handler;  ///< Called for every block.
+    void *context;                 ///< Passed to `handler`.
+    int *status;                   ///< Result of each block, in block order.
+    atomic_size_t next_block;      ///< Next block to be claimed.
+    atomic_bool failed;            ///< Set when a block fails, to stop claiming.
+} sctp_parallel_job_t;
+
+/**
+ * @brief Claims and decodes blocks until none are left or one fails.
+ *
+ * Blocks are claimed in increasing order, so when block `k` fails every
+ * block before it has already been claimed and will be completed.
+ */
+static void *_sctp_parallel_worker(void *arg)
+{
+    sctp_parallel_job_t *job = arg;
+    const sctp_index_t *index = job->index;
+    sctp_decoder_t dec;
+
+    while (!atomic_load_explicit(&job->failed, memory_order_relaxed))
+    {
+        const size_t block = atomic_fetch_add_explicit(&job->next_block, 1, memory_order_relaxed);
+        if (block >= index->count)
+            break;
+        const size_t start = index->offsets[block];
+        const size_t end = block + 1 < index->count ? index->offsets[block + 1] : job->size;
+
+        sctp_decoder_bind(&dec, job->data + start, end - start);
+        dec.origin = job->data; // back-references may point into earlier blocks
+        const int status = job->handler(&dec, block, job->context);
+        job->status[block] = status;
+        if (status != SCTP_OK)
+            atomic_store_explicit(&job->failed, true, memory_order_relaxed);
+    }
+    return NULL;
+}
+
+SCTP_EXPORT(sctp_index_decode_parallel)
+int sctp_index_decode_parallel(const void *buffer, size_t size, const sctp_index_t *index, size_t threads,
+                               sctp_block_handler_t handler, sctp_block_merge_t merge, void *context)
+{
+    if ((!buffer && size) || !index || !handler || threads == 0)
+        return SCTP_ERR_INVALID_ARG;
+    for (size_t i = 0; i < index->count; i++)
+    {
+        if (index->offsets[i] > size || (i && index->offsets[i] < index->offsets[i - 1]))
+            return SCTP_ERR_INVALID_ARG;
+    }
+    if (index->count == 0)
+        return SCTP_OK;
+
+    // Workers beyond the number of blocks would find nothing to claim.
+    if (threads > index->count)
+        threads = index->count;
+    if (threads > SCTP_PARALLEL_MAX_THREADS)
+        threads = SCTP_PARALLEL_MAX_THREADS;
+    // Reachable only with a 32-bit size_t. The worker array is small once clamped.
+    const size_t blocks = index->count;
+    if (blocks > SIZE_MAX / sizeof(int))
+        return SCTP_ERR_NO_SPACE;
+
+    sctp_parallel_job_t job;
+    job.data = buffer;
+    job.size = size;
+    job.index = index;
+    job.handler = handler;
+    job.context = context;
+    job.status = malloc(blocks * sizeof(int));
+    pthread_t *workers = threads > 1 ? malloc((threads - 1) * sizeof(pthread_t)) : NULL;
+    if (!job.status || (threads > 1 && !workers))
+    {
+        free(job.status);
+        free(workers);
+        return SCTP_ERR_NO_SPACE;
+    }
+    for (size_t i = 0; i < index->count; i++)
+        job.status[i] = SCTP_BLOCK_PENDING;
+    atomic_init(&job.next_block, 0);
+    atomic_init(&job.failed, false);
+
+    // The calling thread is a worker too. If a thread cannot be started the
+    // remaining workers, at least the caller, drain its share.
+    size_t started = 0;
+    while (started < threads - 1 && pthread_create(&workers[started], NULL, _sctp_parallel_worker, &job) == 0)
+        started++;
+    _sctp_parallel_worker(&job);
+    for (size_t i = 0; i < started; i++)
+        pthread_join(workers[i], NULL);
+
+    // Merge in block order, up to the first block that failed.
+    int result = SCTP_OK;
+    for (size_t block = 0; block < index->count; block++)
+    {
+        if (job.status[block] != SCTP_OK)
+        {
+            result = job.status[block];
+            break;
+        }
+        if (merge)
+            merge(block, context);
+    }
+
+    free(job.status);
+    free(workers);
+    return result;
+}
+
+#endif
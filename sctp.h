@@ -7,6 +7,10 @@
 #include <string.h>
 #include <stdbool.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /**
  * @file sctp.h
  * @brief Public API for the Simple Compact Transaction Protocol (SCTP) library.
@@ -16,6 +20,37 @@
  * environments and uses a bump allocator model.
  */
 
+// --- Configuration ---
+
+/**
+ * @brief Number of fields staged per `__sctp_data_handler_batch` call.
+ *
+ * Only used when compiled with `SCTP_CALLBACK_BATCH`. Can be overridden on
+ * the compiler command line.
+ */
+#ifndef SCTP_CALLBACK_BATCH_SIZE
+#define SCTP_CALLBACK_BATCH_SIZE 64
+#endif
+
+/**
+ * @def SCTP_HEADER_ONLY
+ * @brief Compiles the whole library into the including translation unit.
+ *
+ * When defined before including this header, every public function becomes
+ * `static inline` and the implementation is pulled in at the end of the
+ * header, so the compiler can inline the hot add and next functions into the
+ * caller. Nothing is exported from the module in this mode. Define it in
+ * every file that includes `sctp.h`, and do not also link `encoder.c` and
+ * `decoder.c`. Each translation unit then has its own singleton encoder.
+ */
+#ifdef SCTP_HEADER_ONLY
+#define SCTP_API static inline
+#define SCTP_EXPORT(name) static inline
+#else
+#define SCTP_API
+#define SCTP_EXPORT(name) LEA_EXPORT(name)
+#endif
+
 // --- Core Data Types ---
 
 /**
@@ -24,7 +59,22 @@
 typedef struct sctp_encoder sctp_encoder_t;
 
 /**
- * @brief Defines the 14 SCTP data types plus a reserved and EOF marker.
+ * @brief Opaque pointer to a streaming decoder's state. Managed by the library.
+ */
+typedef struct sctp_stream_decoder sctp_stream_decoder_t;
+
+/**
+ * @brief Opaque pointer to a bump arena. See the Arena API below.
+ */
+typedef struct sctp_arena sctp_arena_t;
+
+/**
+ * @brief Opaque pointer to a batch container being built. See the Batch Container API below.
+ */
+typedef struct sctp_batch_encoder sctp_batch_encoder_t;
+
+/**
+ * @brief Defines the 15 SCTP data types plus an EOF marker.
  *
  * These values correspond to the lower 4 bits of a field's header byte.
  */
@@ -44,15 +94,50 @@ typedef enum
     SCTP_TYPE_FLOAT64 = 11,
     SCTP_TYPE_SHORT = 12,
     SCTP_TYPE_VECTOR = 13,
-    // Value 14 is reserved
+    SCTP_TYPE_PACKED = 14,
     SCTP_TYPE_EOF = 15
 } sctp_type_t;
 
+/**
+ * @brief Status codes returned by the error-returning SCTP functions.
+ *
+ * Functions that report errors instead of aborting return `SCTP_OK` (zero) on
+ * success and one of the negative values below on failure. The streaming
+ * decoder also returns the positive `SCTP_NEED_MORE`, which is not an error.
+ * `SCTP_ERR_TRUNCATED` and the codes after it describe malformed input.
+ */
+typedef enum
+{
+    SCTP_NEED_MORE = 1,           ///< The input ended inside a field; feed more data.
+    SCTP_OK = 0,                  ///< The operation succeeded.
+    SCTP_ERR_NO_SPACE = -1,       ///< The buffer is full and could not grow.
+    SCTP_ERR_INVALID_ARG = -2,    ///< An argument was NULL or out of range.
+    SCTP_ERR_TRUNCATED = -3,      ///< A field extends past the end of the input.
+    SCTP_ERR_OVERFLOW = -4,       ///< A LEB128 value or a length does not fit in 64 bits.
+    SCTP_ERR_RESERVED_TYPE = -5,  ///< A field uses a reserved type or element type.
+    SCTP_ERR_TRAILING_DATA = -6,  ///< Bytes follow the EOF field.
+    SCTP_ERR_TYPE_MISMATCH = -7,  ///< A field does not have the type a schema expects.
+    SCTP_ERR_BAD_REFERENCE = -8,  ///< A back-reference does not point at an earlier vector.
+    SCTP_ERR_BAD_FRAME = -9,      ///< A batch container's offset table does not match its messages.
+    SCTP_ERR_CHECKSUM = -10,      ///< The checksum trailer is missing or does not match.
+} sctp_status_t;
+
+/**
+ * @brief Strategies an encoder can use when its buffer runs out of space.
+ */
+typedef enum
+{
+    SCTP_GROWTH_NONE = 0,      ///< Fixed capacity; overflow is an error (default).
+    SCTP_GROWTH_GEOMETRIC = 1, ///< Double the capacity until the data fits.
+    SCTP_GROWTH_CHUNKED = 2,   ///< Grow in fixed-size increments.
+} sctp_growth_t;
+
 /**
  * @brief A union holding the value of a decoded SCTP field.
  *
  * The field to access depends on the `sctp_type_t` of the decoded item.
- * For `SCTP_TYPE_VECTOR`, the `ptr` field points to the data.
+ * For `SCTP_TYPE_VECTOR` and `SCTP_TYPE_PACKED`, the `ptr` field points to
+ * the data.
  */
 typedef union {
     int8_t as_int8;
@@ -79,15 +164,163 @@ typedef union {
  * stateful API.
  */
 typedef struct sctp_decoder {
-    const uint8_t* data;     ///< Pointer to the input data buffer.
-    size_t size;             ///< Total size of the data buffer in bytes.
-    size_t position;         ///< Current read offset in the buffer.
-    sctp_type_t last_type;   ///< Type of the last decoded item.
-    sctp_value_t last_value; ///< Value of the last decoded item.
-    size_t last_size;        ///< Size of the last decoded item.
-    bool is_external_buffer; ///< True if the buffer is managed externally.
+    const uint8_t* data;        ///< Pointer to the input data buffer.
+    size_t size;                ///< Total size of the data buffer in bytes.
+    size_t position;            ///< Current read offset in the buffer.
+    sctp_type_t last_type;      ///< Type of the last decoded item.
+    sctp_value_t last_value;    ///< Value of the last decoded item.
+    size_t last_size;           ///< Size of the last decoded item.
+    bool is_external_buffer;    ///< True if the buffer is managed externally.
+    sctp_type_t last_elem_type; ///< Element type of the last PACKED item.
+    const uint8_t* origin;      ///< Start of the stream that back-references may point into.
+    bool verify_checksum;       ///< True while a checksum trailer is being verified.
+    uint32_t checksum;          ///< CRC32C of the bytes verified so far.
+    size_t checksum_position;   ///< Offset up to which `checksum` has been computed.
+    size_t checksum_field;      ///< Start of the last field read, the candidate trailer.
 } sctp_decoder_t;
 
+/**
+ * @brief A single decoded field, as produced by the batch decoding APIs.
+ *
+ * The layout is fixed so hosts can read arrays of fields straight out of
+ * linear memory. On wasm32 each field is 24 bytes: `type` at offset 0,
+ * `size` at offset 4, `value` at offset 8 and `elem_type` at offset 16.
+ */
+typedef struct sctp_field {
+    sctp_type_t type;      ///< Type of the decoded field.
+    size_t size;           ///< Size of the decoded field (see `last_size`).
+    sctp_value_t value;    ///< Value of the decoded field.
+    sctp_type_t elem_type; ///< Element type if `type` is `SCTP_TYPE_PACKED`.
+} sctp_field_t;
+
+/**
+ * @brief A snapshot of a decoder's read position and last decoded item.
+ *
+ * Filled by `sctp_decoder_save` and applied with `sctp_decoder_restore`, so a
+ * caller can look ahead in a stream and return to where it was.
+ */
+typedef struct sctp_decoder_state {
+    size_t position;            ///< Read offset at the time of the snapshot.
+    sctp_type_t last_type;      ///< Saved `last_type`.
+    sctp_value_t last_value;    ///< Saved `last_value`.
+    size_t last_size;           ///< Saved `last_size`.
+    sctp_type_t last_elem_type; ///< Saved `last_elem_type`.
+} sctp_decoder_state_t;
+
+/**
+ * @brief A snapshot of an encoder's output, for undoing speculative adds.
+ *
+ * Filled by `sctp_encoder_mark` and applied with `sctp_encoder_rollback`.
+ * The members are for the library; callers should treat them as opaque.
+ */
+typedef struct sctp_encoder_mark {
+    size_t position;          ///< Write offset at the time of the mark.
+    size_t segment_count;     ///< Number of external segments at the time of the mark.
+    size_t external_size;     ///< Length of the external payloads at the time of the mark.
+    uint32_t checksum;        ///< Running checksum at the time of the mark.
+    size_t checksum_position; ///< Offset the running checksum covered.
+} sctp_encoder_mark_t;
+
+/**
+ * @brief A table of field start offsets for random access into a stream.
+ *
+ * Entry `i` holds the byte offset of field `i * stride`. The index is one
+ * contiguous block of `sctp_index_size(index)` bytes with no pointers, so it
+ * can be written out next to the data and loaded back as is (offsets are in
+ * host byte order, which is little-endian on wasm32).
+ */
+typedef struct sctp_index {
+    uint32_t stride;    ///< Number of fields between indexed offsets.
+    uint32_t count;     ///< Number of entries in `offsets`.
+    uint32_t fields;    ///< Number of fields in the stream, excluding EOF.
+    uint32_t offsets[]; ///< Byte offset of every `stride`-th field.
+} sctp_index_t;
+
+/**
+ * @brief A vector payload that lives outside the encoder buffer.
+ *
+ * Created by `sctp_encoder_add_vector_external_to`. The payload belongs at
+ * `offset` in the encoder's output, so the full stream is the buffer with
+ * each segment's payload inserted at its offset. The layout is fixed at 12
+ * bytes so hosts can read the segment list straight out of linear memory.
+ */
+typedef struct sctp_segment {
+    uint32_t offset; ///< Position in the encoder buffer the payload belongs at.
+    uint32_t length; ///< Length of the payload in bytes.
+    uint32_t tag;    ///< Caller-chosen identifier of the payload, e.g. an index into a host array.
+} sctp_segment_t;
+
+/**
+ * @brief Iterates over the messages of a batch container.
+ *
+ * Filled by `sctp_batch_open` and can live on the stack. It only refers to
+ * the container, which must stay valid while the reader is used.
+ */
+typedef struct sctp_batch_reader {
+    const uint8_t* data;  ///< The container.
+    size_t size;          ///< Size of the container in bytes.
+    size_t count;         ///< Number of messages.
+    size_t index;         ///< Number of messages returned by `sctp_batch_next` so far.
+    size_t position;      ///< Offset of the length prefix of the next message.
+    const uint8_t* table; ///< The offset table, or NULL if the container has none.
+} sctp_batch_reader_t;
+
+// --- Arena API ---
+//
+// An arena is a block of memory that encoders and decoders can be created
+// in. Resetting or freeing the arena releases everything in it at once, in
+// constant time, without touching objects outside the arena. A decoder for
+// each message can then be created in the same arena and discarded with one
+// reset, so memory stays bounded however many messages are decoded.
+
+/**
+ * @brief Creates an arena with room for `capacity` bytes of allocations.
+ *
+ * The arena and its block are one allocation, released by `sctp_arena_free`.
+ *
+ * @param capacity The number of usable bytes.
+ * @return A pointer to the new arena.
+ */
+SCTP_API sctp_arena_t* sctp_arena_create(size_t capacity);
+
+/**
+ * @brief Creates an arena inside caller-provided memory.
+ *
+ * The arena header is stored at the start of `memory`, so this needs no
+ * allocation and works for static or stack buffers. `sctp_arena_free` does
+ * nothing for such an arena.
+ *
+ * @param memory The memory to use.
+ * @param size The size of `memory` in bytes.
+ * @return The arena, or NULL if `memory` is too small to hold its header.
+ */
+SCTP_API sctp_arena_t* sctp_arena_from_buffer(void* memory, size_t size);
+
+/**
+ * @brief Allocates `size` bytes from an arena, aligned to 16 bytes.
+ * @param arena The arena.
+ * @param size The number of bytes.
+ * @return The memory, or NULL if the arena is full.
+ */
+SCTP_API void* sctp_arena_alloc(sctp_arena_t* arena, size_t size);
+
+/**
+ * @brief Releases every allocation in an arena at once.
+ *
+ * Encoders and decoders created in the arena must not be used afterwards.
+ *
+ * @param arena The arena.
+ */
+SCTP_API void sctp_arena_reset(sctp_arena_t* arena);
+
+/** @brief Returns the number of bytes currently allocated from an arena. */
+SCTP_API size_t sctp_arena_used(const sctp_arena_t* arena);
+
+/**
+ * @brief Frees an arena created by `sctp_arena_create`, and everything in it.
+ * @param arena The arena. May be NULL.
+ */
+SCTP_API void sctp_arena_free(sctp_arena_t* arena);
 
 // --- Decoder API ---
 
@@ -100,7 +333,7 @@ typedef struct sctp_decoder {
  * @param size The size of the data buffer to allocate.
  * @return A pointer to a new `sctp_decoder_t` instance, or NULL on failure.
  */
-sctp_decoder_t* sctp_decoder_init(size_t size);
+SCTP_API sctp_decoder_t* sctp_decoder_init(size_t size);
 
 /**
  * @brief Creates a new decoder instance that reads from an existing buffer.
@@ -112,7 +345,43 @@ sctp_decoder_t* sctp_decoder_init(size_t size);
  * @param size The size of the data buffer.
  * @return A pointer to a new `sctp_decoder_t` instance, or NULL on failure.
  */
-sctp_decoder_t* sctp_decoder_from_buffer(const void* buffer, size_t size);
+SCTP_API sctp_decoder_t* sctp_decoder_from_buffer(const void* buffer, size_t size);
+
+/**
+ * @brief Creates a decoder that reads from an existing buffer, inside an arena.
+ *
+ * The decoder is released with the arena and must not be passed to
+ * `sctp_decoder_free`.
+ *
+ * @param arena The arena to allocate the decoder in.
+ * @param buffer Pointer to the data buffer to decode.
+ * @param size The size of the data buffer.
+ * @return A pointer to the decoder.
+ */
+SCTP_API sctp_decoder_t* sctp_decoder_from_buffer_in(sctp_arena_t* arena, const void* buffer, size_t size);
+
+/**
+ * @brief Initializes caller-provided decoder storage to read from a buffer.
+ *
+ * Nothing is allocated, so the decoder can live on the stack, and one
+ * decoder can be rebound to each new message. The buffer is not copied.
+ * A bound decoder must not be passed to `sctp_decoder_free`.
+ *
+ * @param dec The decoder storage.
+ * @param buffer Pointer to the data buffer to decode.
+ * @param size The size of the data buffer.
+ */
+SCTP_API void sctp_decoder_bind(sctp_decoder_t* dec, const void* buffer, size_t size);
+
+/**
+ * @brief Frees a decoder and, for `sctp_decoder_init`, its data buffer.
+ *
+ * Only for decoders returned by `sctp_decoder_init`,
+ * `sctp_decoder_from_buffer` and `sctp_decoder_from_index`.
+ *
+ * @param dec The decoder instance. May be NULL.
+ */
+SCTP_API void sctp_decoder_free(sctp_decoder_t* dec);
 
 /**
  * @brief Gets a pointer to the writable data buffer of a decoder instance.
@@ -122,7 +391,7 @@ sctp_decoder_t* sctp_decoder_from_buffer(const void* buffer, size_t size);
  * @param dec The decoder instance.
  * @return A pointer to the start of the writable data buffer.
  */
-void* sctp_decoder_get_buffer(sctp_decoder_t* dec);
+SCTP_API void* sctp_decoder_get_buffer(sctp_decoder_t* dec);
 
 /**
  * @brief Decodes the next field from the stream in a stateful manner.
@@ -130,18 +399,391 @@ void* sctp_decoder_get_buffer(sctp_decoder_t* dec);
  * After calling this, you can get the decoded data type, value, and size
  * by directly accessing the members of the `sctp_decoder_t` struct.
  *
+ * A vector back-reference (see `sctp_encoder_set_dictionary`) is returned
+ * as `SCTP_TYPE_VECTOR`, with `last_value.as_ptr` pointing at the earlier
+ * copy. It may point anywhere from `origin` on, which for a decoder created
+ * by `sctp_decoder_bind` is the start of its own buffer.
+ *
  * @param dec The decoder instance.
  * @return The `sctp_type_t` of the decoded field, or `SCTP_TYPE_EOF` if the
  *         stream has been fully read.
  */
-sctp_type_t sctp_decoder_next(sctp_decoder_t* dec);
+SCTP_API sctp_type_t sctp_decoder_next(sctp_decoder_t* dec);
+
+/**
+ * @brief Decodes up to `max` fields into a caller-provided array.
+ *
+ * This is equivalent to calling `sctp_decoder_next` repeatedly and copying
+ * `last_type`, `last_size` and `last_value` into `out`, but needs only one
+ * call, which matters when the caller is on the other side of a wasm
+ * boundary. Decoding stops after the EOF field, which is included in the
+ * output. The decoder's `last_*` members describe the final field written.
+ *
+ * @param dec The decoder instance.
+ * @param out The array to fill.
+ * @param max The capacity of `out` in fields.
+ * @return The number of fields written. If the last one has type
+ *         `SCTP_TYPE_EOF`, the stream has been fully read.
+ */
+SCTP_API size_t sctp_decoder_next_batch(sctp_decoder_t* dec, sctp_field_t* out, size_t max);
+
+/**
+ * @brief Advances past up to `n` fields without decoding their values.
+ *
+ * Only the information needed to find the end of each field is parsed:
+ * vector and packed lengths are read, and LEB128 values are scanned for
+ * their terminator byte without being assembled. Skipping stops early at the
+ * end of the buffer or in front of an EOF field, so the next call to
+ * `sctp_decoder_next` returns `SCTP_TYPE_EOF`. The decoder's `last_*`
+ * members are left unchanged.
+ *
+ * @param dec The decoder instance.
+ * @param n The number of fields to skip.
+ * @return The number of fields actually skipped.
+ * @note Aborts on malformed input, like `sctp_decoder_next`.
+ */
+SCTP_API size_t sctp_decoder_skip(sctp_decoder_t* dec, size_t n);
+
+/**
+ * @brief Moves the read position to a byte offset in the buffer.
+ *
+ * The offset must be the start of a field (for example a position recorded
+ * earlier from `dec->position`) or the end of the buffer. The `last_*`
+ * members are left unchanged.
+ *
+ * @param dec The decoder instance.
+ * @param position The new read offset.
+ * @return `SCTP_OK`, or `SCTP_ERR_INVALID_ARG` if `position` is past the end
+ *         of the buffer.
+ */
+SCTP_API int sctp_decoder_seek(sctp_decoder_t* dec, size_t position);
+
+/**
+ * @brief Saves the decoder's read position and last decoded item.
+ * @param dec The decoder instance.
+ * @param state Receives the snapshot.
+ */
+SCTP_API void sctp_decoder_save(const sctp_decoder_t* dec, sctp_decoder_state_t* state);
+
+/**
+ * @brief Restores a snapshot taken with `sctp_decoder_save`.
+ *
+ * The snapshot must come from a decoder over the same buffer.
+ *
+ * @param dec The decoder instance.
+ * @param state The snapshot to apply.
+ */
+SCTP_API void sctp_decoder_restore(sctp_decoder_t* dec, const sctp_decoder_state_t* state);
+
+/**
+ * @brief Builds an offset index over a buffer in a single pass.
+ *
+ * Walks the buffer with the same logic as `sctp_decoder_skip` and records the
+ * start of every `stride`-th field, stopping at an EOF field or the end of
+ * the buffer. The index is allocated with `malloc`.
+ *
+ * @param buffer The encoded data.
+ * @param size The size of the data. Must fit in 32 bits.
+ * @param stride Index every `stride`-th field (1 indexes every field).
+ * @return The new index.
+ * @note Aborts on malformed input, including a field that does not move the
+ *       position forward, or a zero stride.
+ */
+SCTP_API sctp_index_t* sctp_index_build(const void* buffer, size_t size, size_t stride);
+
+/**
+ * @brief Returns the size in bytes of an index, for persisting it.
+ * @param index The index.
+ * @return `sizeof(sctp_index_t)` plus the size of the offset table.
+ */
+SCTP_API size_t sctp_index_size(const sctp_index_t* index);
+
+/**
+ * @brief Creates a decoder positioned at a field found through an index.
+ *
+ * Seeks to the nearest indexed offset at or before `field` and skips the
+ * remaining `field % stride` fields, so the next `sctp_decoder_next` decodes
+ * field `field`.
+ *
+ * @param buffer The encoded data the index was built from.
+ * @param size The size of the data.
+ * @param index The index.
+ * @param field The ordinal of the field to start at, at most `index->fields`.
+ * @return A new decoder over `buffer`.
+ * @note Aborts if `field` is out of range or the index does not fit `buffer`.
+ */
+SCTP_API sctp_decoder_t* sctp_decoder_from_index(const void* buffer, size_t size, const sctp_index_t* index, size_t field);
+
+#ifdef SCTP_PARALLEL
+/**
+ * @brief Decodes one block of an indexed stream. Called on a worker thread.
+ *
+ * `dec` reads only the block: it starts at the block's first field and
+ * reports `SCTP_TYPE_EOF` after its last one. Positions are relative to the
+ * block, but vector and packed pointers point into the original buffer.
+ * Vector back-references may point into earlier blocks.
+ * Results should be stored per block (e.g. in an array indexed by `block`)
+ * and combined in `sctp_block_merge_t`.
+ *
+ * @param dec A decoder bound to the block, owned by the worker.
+ * @param block The block number, which is also the index entry number.
+ * @param context The context passed to `sctp_index_decode_parallel`.
+ * @return `SCTP_OK` to continue, or a negative `sctp_status_t` to stop.
+ */
+typedef int (*sctp_block_handler_t)(sctp_decoder_t* dec, size_t block, void* context);
+
+/** @brief Called on the calling thread for each decoded block, in block order. */
+typedef void (*sctp_block_merge_t)(size_t block, void* context);
+
+/**
+ * @brief Decodes the blocks of an indexed stream on several threads.
+ *
+ * Only available when compiled with `SCTP_PARALLEL`. Block `i` covers the
+ * fields from `index->offsets[i]` to the next indexed offset (or the end of
+ * the buffer), so each block holds `index->stride` fields. Workers claim
+ * blocks one at a time from a shared counter, which balances blocks of very
+ * different sizes. The calling thread is one of the `threads` workers.
+ *
+ * After all workers have finished, `merge` (if not NULL) is called for each
+ * block in order on the calling thread, up to the first block that failed.
+ * Once a block fails, workers stop claiming new blocks.
+ *
+ * @param buffer The encoded data the index was built from.
+ * @param size The size of the data.
+ * @param index The index. Its stride is the block size.
+ * @param threads The number of workers, including the calling thread. At
+ *        most one worker per block, and at most `SCTP_PARALLEL_MAX_THREADS`
+ *        (256 by default), are used.
+ * @param handler Decodes one block.
+ * @param merge Combines the results of one block, or NULL.
+ * @param context Passed to `handler` and `merge`.
+ * @return `SCTP_OK`, the status of the first failed block,
+ *         `SCTP_ERR_INVALID_ARG` if the index does not fit `buffer`, or
+ *         `SCTP_ERR_NO_SPACE` if the per-block state cannot be allocated.
+ */
+SCTP_API int sctp_index_decode_parallel(const void* buffer, size_t size, const sctp_index_t* index, size_t threads,
+                                        sctp_block_handler_t handler, sctp_block_merge_t merge, void* context);
+#endif
+
+/**
+ * @brief Returns the payload width of a fixed-width type.
+ *
+ * These are the types that can be used as the element type of a packed
+ * array: `SCTP_TYPE_INT8` to `SCTP_TYPE_UINT64`, `SCTP_TYPE_FLOAT32` and
+ * `SCTP_TYPE_FLOAT64`. For a decoded `SCTP_TYPE_PACKED` field the element
+ * count is `last_size / sctp_type_width(last_elem_type)`.
+ *
+ * @param type The type to query.
+ * @return The width in bytes, or 0 if the type is not fixed-width.
+ */
+SCTP_API size_t sctp_type_width(sctp_type_t type);
+
+/**
+ * @brief Reads the last decoded field as an unsigned integer, whatever its integer type.
+ *
+ * Accepts every integer field: SHORT, INT8 to UINT64, ULEB128 and SLEB128.
+ * This reads back the output of `sctp_encoder_add_uint_auto`, or any other
+ * choice of integer type.
+ *
+ * @param dec The decoder instance.
+ * @param out Receives the value.
+ * @return `SCTP_OK`, `SCTP_ERR_TYPE_MISMATCH` if the field is not an
+ *         integer, or `SCTP_ERR_OVERFLOW` if the value is negative.
+ */
+SCTP_API int sctp_decoder_as_uint(const sctp_decoder_t* dec, uint64_t* out);
+
+/**
+ * @brief Reads the last decoded field as a signed integer, whatever its integer type.
+ * @param dec The decoder instance.
+ * @param out Receives the value.
+ * @return `SCTP_OK`, `SCTP_ERR_TYPE_MISMATCH` if the field is not an
+ *         integer, or `SCTP_ERR_OVERFLOW` if the value exceeds `INT64_MAX`.
+ * @see sctp_decoder_as_uint
+ */
+SCTP_API int sctp_decoder_as_int(const sctp_decoder_t* dec, int64_t* out);
+
+/** @brief Variant of `sctp_decoder_as_uint` for a field from the batch or streaming decoders. */
+SCTP_API int sctp_field_as_uint(const sctp_field_t* field, uint64_t* out);
+
+/** @brief Variant of `sctp_decoder_as_int` for a field from the batch or streaming decoders. */
+SCTP_API int sctp_field_as_int(const sctp_field_t* field, int64_t* out);
 
 /**
  * @brief Runs the decoder over the buffer using a callback for each field.
  * @param dec The decoder instance.
  * @return 0 on success or if EOF is reached, non-zero on error.
  */
-int sctp_decoder_run(sctp_decoder_t* dec);
+#ifdef SCTP_CALLBACK_ENABLE
+SCTP_API int sctp_decoder_run(sctp_decoder_t* dec);
+#endif
+
+/**
+ * @brief Runs the decoder over the buffer, delivering fields in batches.
+ *
+ * Only available when compiled with `SCTP_CALLBACK_BATCH`. Fields are
+ * collected into a staging ring of `SCTP_CALLBACK_BATCH_SIZE` entries
+ * (default 64) in linear memory, and the host's
+ * `__sctp_data_handler_batch(fields, count)` is called each time the ring
+ * fills and once at the end of the stream. The last batch ends with the EOF
+ * field. Vector pointers in the ring point into the decoder's buffer.
+ *
+ * @param dec The decoder instance.
+ * @return 0 on success or if EOF is reached, non-zero on error.
+ */
+#ifdef SCTP_CALLBACK_BATCH
+SCTP_API int sctp_decoder_run_batch(sctp_decoder_t* dec);
+#endif
+
+// --- Validating Decoder API ---
+//
+// These functions never abort on malformed input. They report an
+// `sctp_status_t` and the byte offset of the offending field, so hostile
+// input can be rejected without losing the wasm instance.
+
+/**
+ * @brief Non-aborting variant of `sctp_decoder_next`.
+ *
+ * On success the `last_*` members are updated as by `sctp_decoder_next`. On
+ * failure nothing is consumed and `dec->position` is the offset of the
+ * malformed field. The exception is `SCTP_ERR_TRAILING_DATA`: the EOF field
+ * is decoded and `dec->position` is the offset of the first trailing byte.
+ * At the end of the buffer `SCTP_OK` is returned with `last_type` set to
+ * `SCTP_TYPE_EOF`.
+ *
+ * @param dec The decoder instance.
+ * @return `SCTP_OK`, `SCTP_ERR_TRUNCATED`, `SCTP_ERR_OVERFLOW`,
+ *         `SCTP_ERR_RESERVED_TYPE`, `SCTP_ERR_TRAILING_DATA` or
+ *         `SCTP_ERR_BAD_REFERENCE`.
+ */
+SCTP_API int sctp_decoder_try_next(sctp_decoder_t* dec);
+
+/**
+ * @brief Checks that a whole buffer is well-formed without decoding values.
+ *
+ * Measures each field the way `sctp_decoder_skip` does, without reading
+ * past the end and without aborting. A buffer is valid if it is a sequence
+ * of complete fields, optionally ended by an EOF field that must be its last
+ * byte. A buffer that passes can be decoded with `sctp_decoder_next`
+ * without aborting.
+ *
+ * @param buffer The encoded data.
+ * @param size The size of the data.
+ * @param error_position Receives the offset of the first invalid field (or
+ *        of the first trailing byte) on failure. May be NULL.
+ * @return `SCTP_OK`, `SCTP_ERR_TRUNCATED`, `SCTP_ERR_OVERFLOW`,
+ *         `SCTP_ERR_RESERVED_TYPE`, `SCTP_ERR_TRAILING_DATA`,
+ *         `SCTP_ERR_BAD_REFERENCE`, or `SCTP_ERR_INVALID_ARG` if `buffer`
+ *         is NULL.
+ */
+SCTP_API int sctp_validate(const void* buffer, size_t size, size_t* error_position);
+
+// --- Canonical Form API ---
+//
+// The same fields can be encoded in more than one way: a LEB128 value or a
+// length with redundant continuation bytes, a short vector in the large
+// form, a vector written as a back-reference, stray metadata bits on a
+// fixed-width header, or no EOF field at the end. The canonical form uses
+// the encoding `sctp_encoder_add_*` produces for every field, expands
+// back-references, and always ends with EOF, so two messages hold the same
+// fields exactly when their canonical forms are byte-for-byte equal. Values
+// are compared as bits: a float NaN is not rewritten.
+
+/**
+ * @brief Rewrites a message in canonical form in one pass.
+ *
+ * The input is validated as by `sctp_validate` while it is rewritten. A
+ * checksum trailer is kept as an ordinary field, so it only still matches
+ * if the input was already canonical.
+ *
+ * @param buffer The message.
+ * @param size The size of the message.
+ * @param out Receives the canonical form. May be NULL to only compute its
+ *        size. Must not overlap `buffer`.
+ * @param capacity The size of `out`.
+ * @param out_size Receives the size of the canonical form, also when it does
+ *        not fit `out`.
+ * @return `SCTP_OK`, `SCTP_ERR_NO_SPACE` if `out` is too small, one of the
+ *         `sctp_validate` codes for malformed input, or
+ *         `SCTP_ERR_INVALID_ARG` if `buffer` or `out_size` is NULL.
+ */
+SCTP_API int sctp_canonicalize(const void* buffer, size_t size, void* out, size_t capacity, size_t* out_size);
+
+/**
+ * @brief Hashes the canonical form of a message without writing it out.
+ *
+ * Returns the 64-bit FNV-1a hash of the bytes `sctp_canonicalize` would
+ * produce, so equal messages hash equally however they were encoded.
+ *
+ * @param buffer The message.
+ * @param size The size of the message.
+ * @param hash Receives the hash.
+ * @return `SCTP_OK`, one of the `sctp_validate` codes for malformed input,
+ *         or `SCTP_ERR_INVALID_ARG` if `buffer` or `hash` is NULL.
+ */
+SCTP_API int sctp_canonical_hash(const void* buffer, size_t size, uint64_t* hash);
+
+// --- Streaming Decoder API ---
+
+/**
+ * @brief Creates a decoder that accepts its input in chunks.
+ *
+ * Unlike `sctp_decoder_from_buffer`, the message does not have to be in one
+ * contiguous buffer. Fields that lie entirely within a chunk are decoded in
+ * place. Only a field that crosses a chunk boundary is copied, into an
+ * internal carry buffer that grows to the size of the largest such field.
+ *
+ * @return A new streaming decoder.
+ */
+SCTP_API sctp_stream_decoder_t* sctp_stream_decoder_create(void);
+
+/**
+ * @brief Supplies the next chunk of input.
+ *
+ * The chunk is not copied and must stay valid until `sctp_stream_decoder_next`
+ * returns `SCTP_NEED_MORE`. Chunks may be of any size, including a single byte.
+ *
+ * @param sdec The streaming decoder.
+ * @param chunk The input bytes.
+ * @param size The number of bytes in `chunk`.
+ * @return `SCTP_OK`, or `SCTP_ERR_INVALID_ARG` if the previous chunk has not
+ *         been fully consumed yet.
+ */
+SCTP_API int sctp_stream_decoder_feed(sctp_stream_decoder_t* sdec, const void* chunk, size_t size);
+
+/**
+ * @brief Decodes the next field from the input fed so far.
+ *
+ * Vector and packed pointers in `out` point into the current chunk or into
+ * the carry buffer, and stay valid until the next call to this function or to
+ * `sctp_stream_decoder_feed`. Once the EOF field has been decoded, every
+ * further call returns `SCTP_OK` with `out->type` set to `SCTP_TYPE_EOF`.
+ * Earlier input is not kept, so vector back-references are rejected with
+ * `SCTP_ERR_RESERVED_TYPE`.
+ *
+ * @param sdec The streaming decoder.
+ * @param out Receives the decoded field.
+ * @return `SCTP_OK` if a field was decoded, `SCTP_NEED_MORE` if the current
+ *         chunk is used up (a partial field is kept for the next chunk), or
+ *         `SCTP_ERR_OVERFLOW` or `SCTP_ERR_RESERVED_TYPE` on invalid input.
+ */
+SCTP_API int sctp_stream_decoder_next(sctp_stream_decoder_t* sdec, sctp_field_t* out);
+
+/**
+ * @brief Returns the number of bytes of a partial field held in the carry buffer.
+ *
+ * A non-zero value when the input is known to have ended means the stream
+ * was truncated.
+ *
+ * @param sdec The streaming decoder.
+ * @return The number of buffered bytes.
+ */
+SCTP_API size_t sctp_stream_decoder_buffered(const sctp_stream_decoder_t* sdec);
+
+/**
+ * @brief Frees a streaming decoder and its carry buffer.
+ * @param sdec The streaming decoder. May be NULL.
+ */
+SCTP_API void sctp_stream_decoder_free(sctp_stream_decoder_t* sdec);
 
 // --- Encoder API ---
 
@@ -149,19 +791,22 @@ int sctp_decoder_run(sctp_decoder_t* dec);
  * @brief Initializes the encoder, resetting any previous state.
  * @param capacity The initial capacity of the internal buffer to allocate.
  */
-void sctp_encoder_init(size_t capacity);
+SCTP_API void sctp_encoder_init(size_t capacity);
 
 /**
  * @brief Gets a read-only pointer to the encoded data buffer.
  * @return A const pointer to the start of the encoded data.
  */
-const uint8_t *sctp_encoder_data(void);
+SCTP_API const uint8_t *sctp_encoder_data(void);
 
 /**
  * @brief Gets the current size of the encoded data.
  * @return The number of bytes currently written to the buffer.
  */
-size_t sctp_encoder_size(void);
+SCTP_API size_t sctp_encoder_size(void);
+
+/** @brief Singleton variant of `sctp_encoder_get_remaining`. */
+SCTP_API size_t sctp_encoder_remaining(void);
 
 // --- Encoder 'add' functions ---
 
@@ -170,96 +815,1124 @@ size_t sctp_encoder_size(void);
  * @param length The size of the vector in bytes.
  * @return A writable pointer to the allocated space in the buffer for the vector data.
  */
-void *sctp_encoder_add_vector(size_t length);
+SCTP_API void *sctp_encoder_add_vector(size_t length);
+
+/**
+ * @brief Appends a data vector to the stream by copying it from `data`.
+ * @param data The vector contents.
+ * @param length The size of the vector in bytes.
+ */
+SCTP_API void sctp_encoder_add_vector_data(const void *data, size_t length);
 
 /**
  * @brief Reserves space for raw, unprocessed bytes in the stream and returns a pointer to it.
  * @param length The size of the data in bytes.
  * @return A writable pointer to the allocated space in the buffer.
  */
-void* sctp_encoder_add_raw(size_t length);
+SCTP_API void* sctp_encoder_add_raw(size_t length);
+
+/**
+ * @brief Appends a packed array of fixed-width elements and returns a pointer to it.
+ *
+ * A packed array stores `count` elements of `elem_type` back to back after a
+ * single header and a ULEB128 count, instead of one header per element.
+ *
+ * @param elem_type A fixed-width type (see `sctp_type_width`).
+ * @param count The number of elements.
+ * @return A writable pointer to `count * sctp_type_width(elem_type)` bytes in
+ *         the buffer, which the caller must fill with little-endian elements.
+ */
+SCTP_API void *sctp_encoder_add_packed(sctp_type_t elem_type, size_t count);
 
 /**
  * @brief Appends a short integer (0-15) to the stream.
  * @param value The 4-bit value to encode. Must be <= 15.
  */
-void sctp_encoder_add_short(uint8_t value);
+SCTP_API void sctp_encoder_add_short(uint8_t value);
 
 /**
  * @brief Appends an 8-bit signed integer to the stream.
  * @param value The value to encode.
  */
-void sctp_encoder_add_int8(int8_t value);
+SCTP_API void sctp_encoder_add_int8(int8_t value);
 
 /**
  * @brief Appends an 8-bit unsigned integer to the stream.
  * @param value The value to encode.
  */
-void sctp_encoder_add_uint8(uint8_t value);
+SCTP_API void sctp_encoder_add_uint8(uint8_t value);
 
 /**
  * @brief Appends a 16-bit signed integer to the stream.
  * @param value The value to encode.
  */
-void sctp_encoder_add_int16(int16_t value);
+SCTP_API void sctp_encoder_add_int16(int16_t value);
 
 /**
  * @brief Appends a 16-bit unsigned integer to the stream.
  * @param value The value to encode.
  */
-void sctp_encoder_add_uint16(uint16_t value);
+SCTP_API void sctp_encoder_add_uint16(uint16_t value);
 
 /**
  * @brief Appends a 32-bit signed integer to the stream.
  * @param value The value to encode.
  */
-void sctp_encoder_add_int32(int32_t value);
+SCTP_API void sctp_encoder_add_int32(int32_t value);
 
 /**
  * @brief Appends a 32-bit unsigned integer to the stream.
  * @param value The value to encode.
  */
-void sctp_encoder_add_uint32(uint32_t value);
+SCTP_API void sctp_encoder_add_uint32(uint32_t value);
 
 /**
  * @brief Appends a 64-bit signed integer to the stream.
  * @param value The value to encode.
  */
-void sctp_encoder_add_int64(int64_t value);
+SCTP_API void sctp_encoder_add_int64(int64_t value);
 
 /**
  * @brief Appends a 64-bit unsigned integer to the stream.
  * @param value The value to encode.
  */
-void sctp_encoder_add_uint64(uint64_t value);
+SCTP_API void sctp_encoder_add_uint64(uint64_t value);
 
 /**
  * @brief Appends a ULEB128-encoded 64-bit unsigned integer.
  * @param value The value to encode.
  */
-void sctp_encoder_add_uleb128(uint64_t value);
+SCTP_API void sctp_encoder_add_uleb128(uint64_t value);
 
 /**
  * @brief Appends an SLEB128-encoded 64-bit signed integer.
  * @param value The value to encode.
  */
-void sctp_encoder_add_sleb128(int64_t value);
+SCTP_API void sctp_encoder_add_sleb128(int64_t value);
 
 /**
  * @brief Appends a 32-bit float to the stream.
  * @param value The value to encode.
  */
-void sctp_encoder_add_float32(float value);
+SCTP_API void sctp_encoder_add_float32(float value);
 
 /**
  * @brief Appends a 64-bit float (double) to the stream.
  * @param value The value to encode.
  */
-void sctp_encoder_add_float64(double value);
+SCTP_API void sctp_encoder_add_float64(double value);
 
 /**
  * @brief Appends an End-Of-File marker to the stream.
  */
-void sctp_encoder_add_eof(void);
+SCTP_API void sctp_encoder_add_eof(void);
+
+// --- Size Helpers ---
+//
+// These return the exact encoded size of a single field, header included, in
+// constant time. Summing them gives the size of a stream.
+
+/**
+ * @brief Returns the encoded size of a ULEB128 field.
+ * @param value The value to be encoded.
+ * @return The size of the field in bytes (2-11).
+ */
+SCTP_API size_t sctp_size_uleb128(uint64_t value);
+
+/**
+ * @brief Returns the encoded size of an SLEB128 field.
+ * @param value The value to be encoded.
+ * @return The size of the field in bytes (2-11).
+ */
+SCTP_API size_t sctp_size_sleb128(int64_t value);
+
+/**
+ * @brief Returns the encoded size of a vector field, including its payload.
+ * @param length The length of the vector payload in bytes.
+ * @return The size of the field in bytes.
+ */
+SCTP_API size_t sctp_size_vector(size_t length);
+
+/**
+ * @brief Returns the encoded size of a packed array field, including its payload.
+ * @param elem_type A fixed-width element type.
+ * @param count The number of elements.
+ * @return The size of the field in bytes, or 0 if `elem_type` is not fixed-width.
+ */
+SCTP_API size_t sctp_size_packed(sctp_type_t elem_type, size_t count);
+
+/** @brief Returns the encoded size of a SHORT field (always 1). */
+SCTP_API size_t sctp_size_short(void);
+
+/** @brief Returns the encoded size of an EOF marker (always 1). */
+SCTP_API size_t sctp_size_eof(void);
+
+/** @brief Returns the encoded size of an INT8 field (always 2). */
+SCTP_API size_t sctp_size_int8(void);
+
+/** @brief Returns the encoded size of a UINT8 field (always 2). */
+SCTP_API size_t sctp_size_uint8(void);
+
+/** @brief Returns the encoded size of an INT16 field (always 3). */
+SCTP_API size_t sctp_size_int16(void);
+
+/** @brief Returns the encoded size of a UINT16 field (always 3). */
+SCTP_API size_t sctp_size_uint16(void);
+
+/** @brief Returns the encoded size of an INT32 field (always 5). */
+SCTP_API size_t sctp_size_int32(void);
+
+/** @brief Returns the encoded size of a UINT32 field (always 5). */
+SCTP_API size_t sctp_size_uint32(void);
+
+/** @brief Returns the encoded size of an INT64 field (always 9). */
+SCTP_API size_t sctp_size_int64(void);
+
+/** @brief Returns the encoded size of a UINT64 field (always 9). */
+SCTP_API size_t sctp_size_uint64(void);
+
+/** @brief Returns the encoded size of a FLOAT32 field (always 5). */
+SCTP_API size_t sctp_size_float32(void);
+
+/** @brief Returns the encoded size of a FLOAT64 field (always 9). */
+SCTP_API size_t sctp_size_float64(void);
+
+// --- Encoder Instance API ---
+//
+// The functions below operate on an explicit encoder instance, so several
+// encoders can be in flight at the same time and a single instance can be
+// reused across messages without reallocating its buffer. The singleton API
+// above is implemented on top of these functions.
+
+/**
+ * @brief Creates a new encoder instance with its own buffer.
+ *
+ * Unlike `sctp_encoder_init`, this does not reset the allocator, so it is
+ * safe to create an encoder while other encoders or decoders are live.
+ * The instance must be freed with `sctp_encoder_free`.
+ *
+ * @param capacity The capacity of the internal buffer to allocate.
+ * @return A pointer to a new `sctp_encoder_t` instance.
+ */
+SCTP_API sctp_encoder_t *sctp_encoder_create(size_t capacity);
+
+/**
+ * @brief Creates an encoder whose state and buffer live in an arena.
+ *
+ * If the encoder has a growth strategy, larger buffers are taken from the
+ * same arena; the old buffer is only reclaimed when the arena is reset.
+ * `sctp_encoder_free` does nothing for an arena encoder.
+ *
+ * @param arena The arena to allocate the encoder in.
+ * @param capacity The initial capacity of the buffer.
+ * @return A pointer to a new `sctp_encoder_t` instance.
+ */
+SCTP_API sctp_encoder_t *sctp_encoder_create_in(sctp_arena_t *arena, size_t capacity);
+
+/**
+ * @brief Creates an encoder that only measures the size of a stream.
+ *
+ * A measuring encoder accepts the same `add` calls as a regular encoder but
+ * writes nothing; it only advances its position. After replaying a message
+ * into it, `sctp_encoder_get_size` returns the exact number of bytes needed,
+ * so the real encoder can be created with a single right-sized allocation.
+ * `sctp_encoder_get_data` returns NULL, and the vector and raw add functions
+ * return NULL instead of a writable pointer, so callers must skip copying
+ * payloads while measuring.
+ *
+ * @return A pointer to a new measuring `sctp_encoder_t` instance.
+ */
+SCTP_API sctp_encoder_t *sctp_encoder_create_measuring(void);
+
+/**
+ * @brief Creates an encoder that streams its output through a fixed window.
+ *
+ * Only available when compiled with `SCTP_FLUSH_ENABLE`. Whenever the next
+ * field does not fit in the window, the bytes written so far are handed to
+ * the host import `__sctp_flush(data, size)` and the window is reused, so a
+ * stream of any length is encoded in constant memory. Call
+ * `sctp_encoder_flush_to` after the last field to flush the rest.
+ *
+ * Fields written in one piece (fixed-width values, LEB128 values, and the
+ * zero-copy vector, packed and array functions) must fit in the window.
+ * `sctp_encoder_add_vector_data_to` and the typed packed functions copy
+ * their payload in pieces and accept any size. Pointers returned by the
+ * zero-copy functions are only valid until the next add.
+ *
+ * @param window The window size in bytes, at least 16.
+ * @return A pointer to a new streaming `sctp_encoder_t` instance.
+ */
+#ifdef SCTP_FLUSH_ENABLE
+SCTP_API sctp_encoder_t *sctp_encoder_create_streaming(size_t window);
+#endif
+
+/**
+ * @brief Hands any bytes left in a streaming encoder's window to the host.
+ *
+ * Only available when compiled with `SCTP_FLUSH_ENABLE`.
+ *
+ * @param enc A streaming encoder instance.
+ */
+#ifdef SCTP_FLUSH_ENABLE
+SCTP_API void sctp_encoder_flush_to(sctp_encoder_t *enc);
+#endif
+
+/**
+ * @brief Selects how an encoder reacts when its buffer is full.
+ *
+ * By default an encoder has a fixed capacity and overflowing it aborts (or
+ * fails, for the `try_add` functions). With a growth strategy the buffer is
+ * reallocated on demand instead, so encoders can start small.
+ *
+ * @note Growing moves the buffer. Pointers previously returned by
+ *       `sctp_encoder_get_data`, `sctp_encoder_add_vector_to` or
+ *       `sctp_encoder_add_raw_to` are invalidated by any later add.
+ *
+ * @param enc The encoder instance.
+ * @param growth The growth strategy to use.
+ * @param chunk_size The increment for `SCTP_GROWTH_CHUNKED`. Pass 0 for the
+ *                   default (4 KiB). Ignored by the other strategies.
+ */
+SCTP_API void sctp_encoder_set_growth(sctp_encoder_t *enc, sctp_growth_t growth, size_t chunk_size);
+
+/**
+ * @brief Makes an encoder replace repeated vectors with back-references.
+ *
+ * The encoder keeps a hash table of recently written vectors. When
+ * `sctp_encoder_add_vector_data_to` writes a vector of 4 or more bytes that
+ * is already in the table, and a back-reference to it is shorter than the
+ * vector itself, the back-reference is written instead. Decoders return it
+ * as a `SCTP_TYPE_VECTOR` whose pointer is the earlier copy.
+ *
+ * Back-references are an extension of the wire format (a `PACKED` header
+ * with element type `VECTOR`). Decoders that predate them reject such
+ * streams with `SCTP_ERR_RESERVED_TYPE`, so only enable this when every
+ * reader is up to date.
+ *
+ * @param enc The encoder instance. Must not be a streaming or measuring
+ *            encoder, since both need the earlier vectors in the buffer.
+ * @param entries The table size, rounded up to a power of two (at most
+ *                65536). Pass 0 to turn deduplication off.
+ * @return `SCTP_OK`, `SCTP_ERR_INVALID_ARG` for a streaming or measuring
+ *         encoder or too many entries, or `SCTP_ERR_NO_SPACE` if the table
+ *         cannot be allocated.
+ */
+SCTP_API int sctp_encoder_set_dictionary(sctp_encoder_t *enc, size_t entries);
+
+/**
+ * @brief Gets the global instance used by the singleton API.
+ *
+ * This allows the instance API (e.g. `sctp_encoder_set_growth`) to be used
+ * on the encoder created by `sctp_encoder_init`.
+ *
+ * @return The global encoder, or NULL if `sctp_encoder_init` was not called.
+ */
+SCTP_API sctp_encoder_t *sctp_encoder_global(void);
+
+/**
+ * @brief Rewinds an encoder so it can be reused for a new message.
+ *
+ * Only the write position and the segment list are reset; the buffer is
+ * kept and not cleared.
+ * Pointers previously returned by `sctp_encoder_get_data` stay valid but
+ * their contents will be overwritten by subsequent adds.
+ *
+ * @param enc The encoder instance.
+ */
+SCTP_API void sctp_encoder_reset(sctp_encoder_t *enc);
+
+/**
+ * @brief Records the current end of an encoder's output.
+ *
+ * Fields added afterwards can be undone with `sctp_encoder_rollback`, for
+ * example when a transaction turns out not to fit in a block. Taking a mark
+ * costs a few stores. Aborts on a streaming encoder, whose flushed windows
+ * cannot be taken back.
+ *
+ * @param enc The encoder instance.
+ * @param mark Receives the mark.
+ */
+SCTP_API void sctp_encoder_mark(const sctp_encoder_t *enc, sctp_encoder_mark_t *mark);
+
+/**
+ * @brief Discards every field added since a mark.
+ *
+ * The write position, the segment list and the running checksum return to
+ * their state at the mark. The buffer keeps any capacity it grew in the
+ * meantime. Dictionary entries for vectors written after the mark are
+ * forgotten, which scans the dictionary once. Marks taken after `mark` become
+ * invalid, and so do all marks after `sctp_encoder_reset`,
+ * `sctp_encoder_set_checksum` or `sctp_encoder_set_dictionary`. Aborts if the
+ * mark lies past the current output.
+ *
+ * @param enc The encoder instance the mark was taken on.
+ * @param mark A mark from `sctp_encoder_mark`.
+ */
+SCTP_API void sctp_encoder_rollback(sctp_encoder_t *enc, const sctp_encoder_mark_t *mark);
+
+/**
+ * @brief Gets the number of bytes that can still be added without growing.
+ *
+ * For an encoder without a growth strategy this is a hard limit: exactly
+ * how much more output fits, so a caller can check a candidate against it,
+ * for example with `sctp_encoder_get_size` of a measuring encoder, before
+ * adding it. With `sctp_encoder_set_growth` it is only the space left before
+ * the next reallocation. A measuring encoder has no buffer and reports
+ * `SIZE_MAX` minus the bytes counted so far, and a streaming encoder reports
+ * the space left in the current window, which is flushed rather than
+ * overrun when more is added.
+ *
+ * @param enc The encoder instance.
+ * @return `capacity - size` in bytes, where the capacity is the buffer or
+ *         window size, or `SIZE_MAX` for a measuring encoder.
+ */
+SCTP_API size_t sctp_encoder_get_remaining(const sctp_encoder_t *enc);
+
+/**
+ * @brief Frees an encoder instance and its buffer.
+ * @param enc The encoder instance. May be NULL.
+ */
+SCTP_API void sctp_encoder_free(sctp_encoder_t *enc);
+
+/**
+ * @brief Gets a read-only pointer to an encoder's data buffer.
+ * @param enc The encoder instance.
+ * @return A const pointer to the start of the encoded data.
+ */
+SCTP_API const uint8_t *sctp_encoder_get_data(const sctp_encoder_t *enc);
+
+/**
+ * @brief Gets the number of bytes written to an encoder.
+ * @param enc The encoder instance.
+ * @return The number of bytes currently written to the buffer.
+ */
+SCTP_API size_t sctp_encoder_get_size(const sctp_encoder_t *enc);
+
+/**
+ * @brief Instance variant of `sctp_encoder_add_vector`.
+ * @param enc The encoder instance.
+ * @param length The size of the vector in bytes.
+ * @return A writable pointer to the allocated space in the buffer for the vector data.
+ */
+SCTP_API void *sctp_encoder_add_vector_to(sctp_encoder_t *enc, size_t length);
+
+/**
+ * @brief Appends a vector by copying its contents from `data`.
+ *
+ * Unlike `sctp_encoder_add_vector_to` this does not hand out a pointer into
+ * the buffer, so it also works for vectors larger than a streaming
+ * encoder's window.
+ *
+ * @param enc The encoder instance.
+ * @param data The vector contents.
+ * @param length The size of the vector in bytes.
+ */
+SCTP_API void sctp_encoder_add_vector_data_to(sctp_encoder_t *enc, const void *data, size_t length);
+
+/**
+ * @brief Instance variant of `sctp_encoder_add_raw`.
+ * @param enc The encoder instance.
+ * @param length The size of the data in bytes.
+ * @return A writable pointer to the allocated space in the buffer.
+ */
+SCTP_API void *sctp_encoder_add_raw_to(sctp_encoder_t *enc, size_t length);
+
+/**
+ * @brief Instance variant of `sctp_encoder_add_packed`.
+ * @param enc The encoder instance.
+ * @param elem_type A fixed-width type (see `sctp_type_width`).
+ * @param count The number of elements.
+ * @return A writable pointer to the element data in the buffer.
+ */
+SCTP_API void *sctp_encoder_add_packed_to(sctp_encoder_t *enc, sctp_type_t elem_type, size_t count);
+
+/**
+ * @brief Instance variant of `sctp_encoder_add_short`.
+ * @param enc The encoder instance.
+ * @param value The 4-bit value to encode. Must be <= 15.
+ */
+SCTP_API void sctp_encoder_add_short_to(sctp_encoder_t *enc, uint8_t value);
+
+/** @brief Instance variant of `sctp_encoder_add_int8`. */
+SCTP_API void sctp_encoder_add_int8_to(sctp_encoder_t *enc, int8_t value);
+
+/** @brief Instance variant of `sctp_encoder_add_uint8`. */
+SCTP_API void sctp_encoder_add_uint8_to(sctp_encoder_t *enc, uint8_t value);
+
+/** @brief Instance variant of `sctp_encoder_add_int16`. */
+SCTP_API void sctp_encoder_add_int16_to(sctp_encoder_t *enc, int16_t value);
+
+/** @brief Instance variant of `sctp_encoder_add_uint16`. */
+SCTP_API void sctp_encoder_add_uint16_to(sctp_encoder_t *enc, uint16_t value);
+
+/** @brief Instance variant of `sctp_encoder_add_int32`. */
+SCTP_API void sctp_encoder_add_int32_to(sctp_encoder_t *enc, int32_t value);
+
+/** @brief Instance variant of `sctp_encoder_add_uint32`. */
+SCTP_API void sctp_encoder_add_uint32_to(sctp_encoder_t *enc, uint32_t value);
+
+/** @brief Instance variant of `sctp_encoder_add_int64`. */
+SCTP_API void sctp_encoder_add_int64_to(sctp_encoder_t *enc, int64_t value);
+
+/** @brief Instance variant of `sctp_encoder_add_uint64`. */
+SCTP_API void sctp_encoder_add_uint64_to(sctp_encoder_t *enc, uint64_t value);
+
+/** @brief Instance variant of `sctp_encoder_add_uleb128`. */
+SCTP_API void sctp_encoder_add_uleb128_to(sctp_encoder_t *enc, uint64_t value);
+
+/** @brief Instance variant of `sctp_encoder_add_sleb128`. */
+SCTP_API void sctp_encoder_add_sleb128_to(sctp_encoder_t *enc, int64_t value);
+
+/** @brief Instance variant of `sctp_encoder_add_float32`. */
+SCTP_API void sctp_encoder_add_float32_to(sctp_encoder_t *enc, float value);
+
+/** @brief Instance variant of `sctp_encoder_add_float64`. */
+SCTP_API void sctp_encoder_add_float64_to(sctp_encoder_t *enc, double value);
+
+/** @brief Instance variant of `sctp_encoder_add_eof`. */
+SCTP_API void sctp_encoder_add_eof_to(sctp_encoder_t *enc);
+
+// --- Error-Returning Encoder API ---
+//
+// These mirror the `sctp_encoder_add_*_to` functions, but return a
+// `sctp_status_t` instead of aborting. A field is either written completely
+// or not at all, so the encoder remains usable after a failure.
+
+/**
+ * @brief Error-returning variant of `sctp_encoder_add_vector_to`.
+ * @param enc The encoder instance.
+ * @param length The size of the vector in bytes.
+ * @param out_ptr Receives a writable pointer to the vector data on success.
+ * @return `SCTP_OK` on success or a negative `sctp_status_t` on failure.
+ */
+SCTP_API int sctp_encoder_try_add_vector_to(sctp_encoder_t *enc, size_t length, void **out_ptr);
+
+/**
+ * @brief Error-returning variant of `sctp_encoder_add_vector_data_to`.
+ * @param enc The encoder instance.
+ * @param data The vector contents.
+ * @param length The size of the vector in bytes.
+ * @return `SCTP_OK` on success or a negative `sctp_status_t` on failure.
+ */
+SCTP_API int sctp_encoder_try_add_vector_data_to(sctp_encoder_t *enc, const void *data, size_t length);
+
+/**
+ * @brief Error-returning variant of `sctp_encoder_add_raw_to`.
+ * @param enc The encoder instance.
+ * @param length The size of the data in bytes.
+ * @param out_ptr Receives a writable pointer to the reserved space on success.
+ * @return `SCTP_OK` on success or a negative `sctp_status_t` on failure.
+ */
+SCTP_API int sctp_encoder_try_add_raw_to(sctp_encoder_t *enc, size_t length, void **out_ptr);
+
+/**
+ * @brief Error-returning variant of `sctp_encoder_add_packed_to`.
+ * @param enc The encoder instance.
+ * @param elem_type A fixed-width type (see `sctp_type_width`).
+ * @param count The number of elements.
+ * @param out_ptr Receives a writable pointer to the element data on success.
+ * @return `SCTP_OK`, `SCTP_ERR_NO_SPACE`, or `SCTP_ERR_INVALID_ARG` if
+ *         `elem_type` is not fixed-width.
+ */
+SCTP_API int sctp_encoder_try_add_packed_to(sctp_encoder_t *enc, sctp_type_t elem_type, size_t count, void **out_ptr);
+
+/**
+ * @brief Error-returning variant of `sctp_encoder_add_short_to`.
+ * @return `SCTP_OK`, `SCTP_ERR_NO_SPACE`, or `SCTP_ERR_INVALID_ARG` if the
+ *         value is greater than 15.
+ */
+SCTP_API int sctp_encoder_try_add_short_to(sctp_encoder_t *enc, uint8_t value);
+
+/** @brief Error-returning variant of `sctp_encoder_add_int8_to`. */
+SCTP_API int sctp_encoder_try_add_int8_to(sctp_encoder_t *enc, int8_t value);
+
+/** @brief Error-returning variant of `sctp_encoder_add_uint8_to`. */
+SCTP_API int sctp_encoder_try_add_uint8_to(sctp_encoder_t *enc, uint8_t value);
+
+/** @brief Error-returning variant of `sctp_encoder_add_int16_to`. */
+SCTP_API int sctp_encoder_try_add_int16_to(sctp_encoder_t *enc, int16_t value);
+
+/** @brief Error-returning variant of `sctp_encoder_add_uint16_to`. */
+SCTP_API int sctp_encoder_try_add_uint16_to(sctp_encoder_t *enc, uint16_t value);
+
+/** @brief Error-returning variant of `sctp_encoder_add_int32_to`. */
+SCTP_API int sctp_encoder_try_add_int32_to(sctp_encoder_t *enc, int32_t value);
+
+/** @brief Error-returning variant of `sctp_encoder_add_uint32_to`. */
+SCTP_API int sctp_encoder_try_add_uint32_to(sctp_encoder_t *enc, uint32_t value);
+
+/** @brief Error-returning variant of `sctp_encoder_add_int64_to`. */
+SCTP_API int sctp_encoder_try_add_int64_to(sctp_encoder_t *enc, int64_t value);
+
+/** @brief Error-returning variant of `sctp_encoder_add_uint64_to`. */
+SCTP_API int sctp_encoder_try_add_uint64_to(sctp_encoder_t *enc, uint64_t value);
+
+/** @brief Error-returning variant of `sctp_encoder_add_uleb128_to`. */
+SCTP_API int sctp_encoder_try_add_uleb128_to(sctp_encoder_t *enc, uint64_t value);
+
+/** @brief Error-returning variant of `sctp_encoder_add_sleb128_to`. */
+SCTP_API int sctp_encoder_try_add_sleb128_to(sctp_encoder_t *enc, int64_t value);
+
+/** @brief Error-returning variant of `sctp_encoder_add_float32_to`. */
+SCTP_API int sctp_encoder_try_add_float32_to(sctp_encoder_t *enc, float value);
+
+/** @brief Error-returning variant of `sctp_encoder_add_float64_to`. */
+SCTP_API int sctp_encoder_try_add_float64_to(sctp_encoder_t *enc, double value);
+
+/** @brief Error-returning variant of `sctp_encoder_add_eof_to`. */
+SCTP_API int sctp_encoder_try_add_eof_to(sctp_encoder_t *enc);
+
+// --- Scatter/Gather Encoder API ---
+//
+// An external vector writes only its header and length prefix into the
+// encoder buffer and records where its payload belongs, so large payloads
+// never have to be copied into wasm memory. The host assembles the output
+// once from the buffer and its own slices, or passes the pieces to a
+// vectored write. See `sctp_encoder_gather` for the assembly rule.
+
+/**
+ * @brief Appends a vector whose payload is supplied later by the caller.
+ *
+ * The header and length prefix are written to the buffer and a segment is
+ * recorded at the current position. Not supported by streaming encoders or
+ * while a checksum is running, since the encoder never sees the payload. A
+ * measuring encoder counts the full vector and records nothing.
+ *
+ * @param enc The encoder instance.
+ * @param length The size of the payload in bytes, at most `UINT32_MAX`.
+ * @param tag An identifier for the payload, returned in the segment.
+ */
+SCTP_API void sctp_encoder_add_vector_external_to(sctp_encoder_t *enc, size_t length, uint32_t tag);
+
+/**
+ * @brief Error-returning variant of `sctp_encoder_add_vector_external_to`.
+ * @return `SCTP_OK`, `SCTP_ERR_NO_SPACE`, or `SCTP_ERR_INVALID_ARG` for a
+ *         streaming or checksumming encoder or a payload larger than
+ *         `UINT32_MAX`.
+ */
+SCTP_API int sctp_encoder_try_add_vector_external_to(sctp_encoder_t *enc, size_t length, uint32_t tag);
+
+/** @brief Singleton variant of `sctp_encoder_add_vector_external_to`. */
+SCTP_API void sctp_encoder_add_vector_external(size_t length, uint32_t tag);
+
+/**
+ * @brief Gets the segments recorded by external vectors, in stream order.
+ *
+ * The array is owned by the encoder and is invalidated by the next add.
+ *
+ * @param enc The encoder instance.
+ * @return The segment array, or NULL if there are none.
+ */
+SCTP_API const sctp_segment_t *sctp_encoder_get_segments(const sctp_encoder_t *enc);
+
+/** @brief Gets the number of recorded segments. */
+SCTP_API size_t sctp_encoder_get_segment_count(const sctp_encoder_t *enc);
+
+/**
+ * @brief Gets the size of the assembled stream.
+ *
+ * This is `sctp_encoder_get_size` plus the length of every external payload.
+ *
+ * @param enc The encoder instance.
+ * @return The size of the output of `sctp_encoder_gather`.
+ */
+SCTP_API size_t sctp_encoder_get_gathered_size(const sctp_encoder_t *enc);
+
+/**
+ * @brief Assembles the full stream of an encoder with external vectors.
+ *
+ * Copies the buffer up to the first segment's offset, then that segment's
+ * payload `slices[tag]`, then the buffer up to the next offset, and so on,
+ * ending with the rest of the buffer.
+ *
+ * @param enc The encoder instance.
+ * @param slices The payloads, indexed by segment tag.
+ * @param out Receives `sctp_encoder_get_gathered_size(enc)` bytes.
+ */
+SCTP_API void sctp_encoder_gather(const sctp_encoder_t *enc, const void *const *slices, void *out);
+
+/** @brief Singleton variant of `sctp_encoder_get_segments`. */
+SCTP_API const sctp_segment_t *sctp_encoder_segments(void);
+
+/** @brief Singleton variant of `sctp_encoder_get_segment_count`. */
+SCTP_API size_t sctp_encoder_segment_count(void);
+
+/** @brief Singleton variant of `sctp_encoder_get_gathered_size`. */
+SCTP_API size_t sctp_encoder_gathered_size(void);
+
+// --- Bulk Array Encoder API ---
+//
+// Each function appends `count` regular fields, one per element. The output
+// is identical to calling the scalar `add` function in a loop, but capacity
+// is checked once for the whole array and the fields are written in a tight
+// loop. The `try_add` variants write either all elements or none.
+
+/**
+ * @brief Appends an array of 32-bit unsigned integers as individual fields.
+ *
+ * The other `*_array` functions follow the same pattern for their type.
+ *
+ * @param enc The encoder instance.
+ * @param values The elements to encode. May be NULL if `count` is 0.
+ * @param count The number of elements.
+ */
+SCTP_API void sctp_encoder_add_uint32_array_to(sctp_encoder_t *enc, const uint32_t *values, size_t count);
+SCTP_API void sctp_encoder_add_int8_array_to(sctp_encoder_t *enc, const int8_t *values, size_t count);
+SCTP_API void sctp_encoder_add_uint8_array_to(sctp_encoder_t *enc, const uint8_t *values, size_t count);
+SCTP_API void sctp_encoder_add_int16_array_to(sctp_encoder_t *enc, const int16_t *values, size_t count);
+SCTP_API void sctp_encoder_add_uint16_array_to(sctp_encoder_t *enc, const uint16_t *values, size_t count);
+SCTP_API void sctp_encoder_add_int32_array_to(sctp_encoder_t *enc, const int32_t *values, size_t count);
+SCTP_API void sctp_encoder_add_int64_array_to(sctp_encoder_t *enc, const int64_t *values, size_t count);
+SCTP_API void sctp_encoder_add_uint64_array_to(sctp_encoder_t *enc, const uint64_t *values, size_t count);
+SCTP_API void sctp_encoder_add_uleb128_array_to(sctp_encoder_t *enc, const uint64_t *values, size_t count);
+SCTP_API void sctp_encoder_add_sleb128_array_to(sctp_encoder_t *enc, const int64_t *values, size_t count);
+SCTP_API void sctp_encoder_add_float32_array_to(sctp_encoder_t *enc, const float *values, size_t count);
+SCTP_API void sctp_encoder_add_float64_array_to(sctp_encoder_t *enc, const double *values, size_t count);
+
+/** @brief Error-returning variants of the `*_array_to` functions. */
+SCTP_API int sctp_encoder_try_add_int8_array_to(sctp_encoder_t *enc, const int8_t *values, size_t count);
+SCTP_API int sctp_encoder_try_add_uint8_array_to(sctp_encoder_t *enc, const uint8_t *values, size_t count);
+SCTP_API int sctp_encoder_try_add_int16_array_to(sctp_encoder_t *enc, const int16_t *values, size_t count);
+SCTP_API int sctp_encoder_try_add_uint16_array_to(sctp_encoder_t *enc, const uint16_t *values, size_t count);
+SCTP_API int sctp_encoder_try_add_int32_array_to(sctp_encoder_t *enc, const int32_t *values, size_t count);
+SCTP_API int sctp_encoder_try_add_uint32_array_to(sctp_encoder_t *enc, const uint32_t *values, size_t count);
+SCTP_API int sctp_encoder_try_add_int64_array_to(sctp_encoder_t *enc, const int64_t *values, size_t count);
+SCTP_API int sctp_encoder_try_add_uint64_array_to(sctp_encoder_t *enc, const uint64_t *values, size_t count);
+SCTP_API int sctp_encoder_try_add_uleb128_array_to(sctp_encoder_t *enc, const uint64_t *values, size_t count);
+SCTP_API int sctp_encoder_try_add_sleb128_array_to(sctp_encoder_t *enc, const int64_t *values, size_t count);
+SCTP_API int sctp_encoder_try_add_float32_array_to(sctp_encoder_t *enc, const float *values, size_t count);
+SCTP_API int sctp_encoder_try_add_float64_array_to(sctp_encoder_t *enc, const double *values, size_t count);
+
+/** @brief Singleton variants of the `*_array_to` functions. */
+SCTP_API void sctp_encoder_add_int8_array(const int8_t *values, size_t count);
+SCTP_API void sctp_encoder_add_uint8_array(const uint8_t *values, size_t count);
+SCTP_API void sctp_encoder_add_int16_array(const int16_t *values, size_t count);
+SCTP_API void sctp_encoder_add_uint16_array(const uint16_t *values, size_t count);
+SCTP_API void sctp_encoder_add_int32_array(const int32_t *values, size_t count);
+SCTP_API void sctp_encoder_add_uint32_array(const uint32_t *values, size_t count);
+SCTP_API void sctp_encoder_add_int64_array(const int64_t *values, size_t count);
+SCTP_API void sctp_encoder_add_uint64_array(const uint64_t *values, size_t count);
+SCTP_API void sctp_encoder_add_uleb128_array(const uint64_t *values, size_t count);
+SCTP_API void sctp_encoder_add_sleb128_array(const int64_t *values, size_t count);
+SCTP_API void sctp_encoder_add_float32_array(const float *values, size_t count);
+SCTP_API void sctp_encoder_add_float64_array(const double *values, size_t count);
+
+// --- Packed Array Encoder API ---
+//
+// These copy a C array into a single `SCTP_TYPE_PACKED` field: one header,
+// a ULEB128 element count and the raw elements. Compared to the `*_array`
+// functions this saves one header byte per element and lets decoders skip
+// the whole array at once.
+
+/**
+ * @brief Appends a packed array of 32-bit unsigned integers.
+ *
+ * The other `add_packed_*` functions follow the same pattern for their type.
+ *
+ * @param enc The encoder instance.
+ * @param values The elements to encode. May be NULL if `count` is 0.
+ * @param count The number of elements.
+ */
+SCTP_API void sctp_encoder_add_packed_uint32_to(sctp_encoder_t *enc, const uint32_t *values, size_t count);
+SCTP_API void sctp_encoder_add_packed_int8_to(sctp_encoder_t *enc, const int8_t *values, size_t count);
+SCTP_API void sctp_encoder_add_packed_uint8_to(sctp_encoder_t *enc, const uint8_t *values, size_t count);
+SCTP_API void sctp_encoder_add_packed_int16_to(sctp_encoder_t *enc, const int16_t *values, size_t count);
+SCTP_API void sctp_encoder_add_packed_uint16_to(sctp_encoder_t *enc, const uint16_t *values, size_t count);
+SCTP_API void sctp_encoder_add_packed_int32_to(sctp_encoder_t *enc, const int32_t *values, size_t count);
+SCTP_API void sctp_encoder_add_packed_int64_to(sctp_encoder_t *enc, const int64_t *values, size_t count);
+SCTP_API void sctp_encoder_add_packed_uint64_to(sctp_encoder_t *enc, const uint64_t *values, size_t count);
+SCTP_API void sctp_encoder_add_packed_float32_to(sctp_encoder_t *enc, const float *values, size_t count);
+SCTP_API void sctp_encoder_add_packed_float64_to(sctp_encoder_t *enc, const double *values, size_t count);
+
+/** @brief Error-returning variants of the `add_packed_*_to` functions. */
+SCTP_API int sctp_encoder_try_add_packed_int8_to(sctp_encoder_t *enc, const int8_t *values, size_t count);
+SCTP_API int sctp_encoder_try_add_packed_uint8_to(sctp_encoder_t *enc, const uint8_t *values, size_t count);
+SCTP_API int sctp_encoder_try_add_packed_int16_to(sctp_encoder_t *enc, const int16_t *values, size_t count);
+SCTP_API int sctp_encoder_try_add_packed_uint16_to(sctp_encoder_t *enc, const uint16_t *values, size_t count);
+SCTP_API int sctp_encoder_try_add_packed_int32_to(sctp_encoder_t *enc, const int32_t *values, size_t count);
+SCTP_API int sctp_encoder_try_add_packed_uint32_to(sctp_encoder_t *enc, const uint32_t *values, size_t count);
+SCTP_API int sctp_encoder_try_add_packed_int64_to(sctp_encoder_t *enc, const int64_t *values, size_t count);
+SCTP_API int sctp_encoder_try_add_packed_uint64_to(sctp_encoder_t *enc, const uint64_t *values, size_t count);
+SCTP_API int sctp_encoder_try_add_packed_float32_to(sctp_encoder_t *enc, const float *values, size_t count);
+SCTP_API int sctp_encoder_try_add_packed_float64_to(sctp_encoder_t *enc, const double *values, size_t count);
+
+/** @brief Singleton variants of the `add_packed_*_to` functions. */
+SCTP_API void sctp_encoder_add_packed_int8(const int8_t *values, size_t count);
+SCTP_API void sctp_encoder_add_packed_uint8(const uint8_t *values, size_t count);
+SCTP_API void sctp_encoder_add_packed_int16(const int16_t *values, size_t count);
+SCTP_API void sctp_encoder_add_packed_uint16(const uint16_t *values, size_t count);
+SCTP_API void sctp_encoder_add_packed_int32(const int32_t *values, size_t count);
+SCTP_API void sctp_encoder_add_packed_uint32(const uint32_t *values, size_t count);
+SCTP_API void sctp_encoder_add_packed_int64(const int64_t *values, size_t count);
+SCTP_API void sctp_encoder_add_packed_uint64(const uint64_t *values, size_t count);
+SCTP_API void sctp_encoder_add_packed_float32(const float *values, size_t count);
+SCTP_API void sctp_encoder_add_packed_float64(const double *values, size_t count);
+
+// --- Automatic Integer Encoding ---
+//
+// These pick the smallest wire type that holds a value, for generic code that
+// would otherwise always emit the widest type. Values 0-15 become SHORT, then
+// the smallest fixed-width type or LEB128 field, whichever is shorter; on a
+// tie the fixed-width type is used because it decodes faster. The output is
+// ordinary SCTP and is read back with `sctp_decoder_as_uint` and
+// `sctp_decoder_as_int`.
+//
+// | Unsigned value      | Field   | Bytes |
+// | ------------------- | ------- | ----- |
+// | 0 - 15              | SHORT   | 1     |
+// | 16 - 255            | UINT8   | 2     |
+// | 256 - 65535         | UINT16  | 3     |
+// | 65536 - 2^21-1      | ULEB128 | 4     |
+// | 2^21 - 2^32-1       | UINT32  | 5     |
+// | 2^32 - 2^49-1       | ULEB128 | 6-8   |
+// | 2^49 and above      | UINT64  | 9     |
+//
+// `add_int_auto` encodes non-negative values like `add_uint_auto`, and
+// negative values as INT8, INT16, SLEB128 (up to -2^20), INT32, SLEB128
+// (up to -2^48) or INT64.
+
+/**
+ * @brief Appends an unsigned integer using the smallest suitable field.
+ * @param enc The encoder instance.
+ * @param value The value to encode.
+ */
+SCTP_API void sctp_encoder_add_uint_auto_to(sctp_encoder_t *enc, uint64_t value);
+
+/**
+ * @brief Appends a signed integer using the smallest suitable field.
+ * @param enc The encoder instance.
+ * @param value The value to encode.
+ */
+SCTP_API void sctp_encoder_add_int_auto_to(sctp_encoder_t *enc, int64_t value);
+
+/** @brief Error-returning variant of `sctp_encoder_add_uint_auto_to`. */
+SCTP_API int sctp_encoder_try_add_uint_auto_to(sctp_encoder_t *enc, uint64_t value);
+
+/** @brief Error-returning variant of `sctp_encoder_add_int_auto_to`. */
+SCTP_API int sctp_encoder_try_add_int_auto_to(sctp_encoder_t *enc, int64_t value);
+
+/** @brief Singleton variant of `sctp_encoder_add_uint_auto_to`. */
+SCTP_API void sctp_encoder_add_uint_auto(uint64_t value);
+
+/** @brief Singleton variant of `sctp_encoder_add_int_auto_to`. */
+SCTP_API void sctp_encoder_add_int_auto(int64_t value);
+
+/** @brief Returns the encoded size of `sctp_encoder_add_uint_auto(value)` (1-9). */
+SCTP_API size_t sctp_size_uint_auto(uint64_t value);
+
+/** @brief Returns the encoded size of `sctp_encoder_add_int_auto(value)` (1-9). */
+SCTP_API size_t sctp_size_int_auto(int64_t value);
+
+// --- Batch Container API ---
+//
+// A batch container holds several complete SCTP messages in one buffer:
+//
+//   ULEB128 header                  count * 2, plus 1 if there is an offset table
+//   count * (ULEB128 length, bytes) the messages, in order
+//   count * uint32 (optional)       offset of each message's length prefix
+//
+// Offsets are little-endian and relative to the start of the container. The
+// table allows random access to any message, and limits the container to
+// 4 GiB. A reader rebinds one caller-owned decoder to each message in turn,
+// so iterating over a batch allocates nothing.
+
+/**
+ * @brief Creates a batch container builder.
+ * @param capacity Initial buffer size in bytes. The buffer grows as needed.
+ * @param offset_table True to end the container with an offset table.
+ * @return The builder. Aborts if it cannot be allocated.
+ */
+SCTP_API sctp_batch_encoder_t* sctp_batch_encoder_create(size_t capacity, bool offset_table);
+
+/**
+ * @brief Appends a complete encoded message to a batch.
+ * @param batch The builder. Must not have been finished.
+ * @param message The encoded message, e.g. from `sctp_encoder_get_data`.
+ * @param size The size of the message in bytes.
+ */
+SCTP_API void sctp_batch_encoder_append(sctp_batch_encoder_t* batch, const void* message, size_t size);
+
+/**
+ * @brief Error-returning variant of `sctp_batch_encoder_append`.
+ * @return `SCTP_OK`, `SCTP_ERR_INVALID_ARG` if the batch is finished, or
+ *         `SCTP_ERR_NO_SPACE` if the buffer cannot grow or a container with
+ *         an offset table would exceed 4 GiB.
+ */
+SCTP_API int sctp_batch_encoder_try_append(sctp_batch_encoder_t* batch, const void* message, size_t size);
+
+/** @brief Returns the number of messages appended so far. */
+SCTP_API size_t sctp_batch_encoder_count(const sctp_batch_encoder_t* batch);
+
+/**
+ * @brief Completes the container and returns it.
+ *
+ * Writes the header in front of the messages, which were placed after room
+ * reserved for it, so the messages are not moved. Later calls return the
+ * same container until `sctp_batch_encoder_reset`.
+ *
+ * @param batch The builder.
+ * @param size Receives the size of the container in bytes.
+ * @return The container, valid until the builder is reset or freed.
+ */
+SCTP_API const void* sctp_batch_encoder_finish(sctp_batch_encoder_t* batch, size_t* size);
+
+/** @brief Empties a batch so a new one can be built in the same buffer. */
+SCTP_API void sctp_batch_encoder_reset(sctp_batch_encoder_t* batch);
+
+/** @brief Frees a batch builder. May be NULL. */
+SCTP_API void sctp_batch_encoder_free(sctp_batch_encoder_t* batch);
+
+/**
+ * @brief Checks a batch container and prepares a reader for it.
+ *
+ * Walks the length prefixes, without reading the messages, and checks the
+ * offset table against them. Once this succeeds, the other reader functions
+ * cannot fail on this container. The messages themselves are not validated;
+ * use `sctp_validate` or `sctp_decoder_try_next` on untrusted ones.
+ *
+ * @param reader The reader storage.
+ * @param buffer The container.
+ * @param size The size of the container.
+ * @return `SCTP_OK`, `SCTP_ERR_INVALID_ARG` if `reader` or `buffer` is NULL,
+ *         `SCTP_ERR_TRUNCATED` or `SCTP_ERR_OVERFLOW` for a bad header or
+ *         length, `SCTP_ERR_TRAILING_DATA` if bytes follow the last message,
+ *         or `SCTP_ERR_BAD_FRAME` if the offset table does not match.
+ */
+SCTP_API int sctp_batch_open(sctp_batch_reader_t* reader, const void* buffer, size_t size);
+
+/**
+ * @brief Binds a decoder to the next message of a batch.
+ *
+ * `dec` is rebound as by `sctp_decoder_bind`, so one decoder, for example on
+ * the stack, serves the whole batch.
+ *
+ * @param reader A reader prepared by `sctp_batch_open`.
+ * @param dec The decoder to bind.
+ * @return True if `dec` was bound, false after the last message.
+ */
+SCTP_API bool sctp_batch_next(sctp_batch_reader_t* reader, sctp_decoder_t* dec);
+
+/**
+ * @brief Binds a decoder to message `index` of a batch.
+ *
+ * Constant time with an offset table. Without one, the length prefixes
+ * before the message are walked. Does not change what `sctp_batch_next`
+ * returns.
+ *
+ * @param reader A reader prepared by `sctp_batch_open`.
+ * @param index The message number.
+ * @param dec The decoder to bind.
+ * @return `SCTP_OK`, or `SCTP_ERR_INVALID_ARG` if `index` is out of range.
+ */
+SCTP_API int sctp_batch_message(const sctp_batch_reader_t* reader, size_t index, sctp_decoder_t* dec);
+
+// --- Checksum API ---
+//
+// A checksummed stream ends with a trailer: a UINT32 field holding the
+// CRC32C of every byte before it, followed by EOF. The encoder folds bytes
+// into the CRC as it goes and the decoder verifies it while decoding, so the
+// integrity check does not need a second pass over the buffer. The trailer
+// is an ordinary field, so decoders that do not verify simply see a UINT32.
+
+/**
+ * @brief Computes or extends a CRC32C (Castagnoli) checksum.
+ * @param crc 0 to start, or the result of a previous call to continue.
+ * @param data The bytes to add.
+ * @param size The number of bytes.
+ * @return The checksum of all bytes passed so far.
+ */
+SCTP_API uint32_t sctp_crc32c(uint32_t crc, const void* data, size_t size);
+
+/**
+ * @brief Turns the running checksum of an encoder on or off.
+ *
+ * When turned on, the checksum starts from the current position and covers
+ * every byte written after it, including the windows a streaming encoder
+ * flushes. External vectors are rejected while it runs. `sctp_encoder_reset`
+ * restarts it. The CRC is only computed when the checksum is read, the
+ * trailer is written or a streaming window is flushed, so payloads returned
+ * by `sctp_encoder_add_vector_to` and friends may be filled in after later
+ * fields have been added, as long as the buffer has not moved.
+ *
+ * @param enc The encoder.
+ * @param enabled True to start checksumming, false to stop.
+ */
+SCTP_API void sctp_encoder_set_checksum(sctp_encoder_t* enc, bool enabled);
+
+/**
+ * @brief Returns the CRC32C of the bytes written since the checksum started.
+ * @param enc The encoder. Returns 0 if checksumming is off or the encoder is
+ *        measuring.
+ */
+SCTP_API uint32_t sctp_encoder_get_checksum(sctp_encoder_t* enc);
+
+/**
+ * @brief Appends the checksum trailer.
+ *
+ * Writes a UINT32 field holding `sctp_encoder_get_checksum`, then restarts
+ * the checksum after it. Follow it with `sctp_encoder_add_eof_to`. Aborts if
+ * checksumming is off or the field does not fit.
+ *
+ * @param enc The encoder.
+ */
+SCTP_API void sctp_encoder_add_checksum_to(sctp_encoder_t* enc);
+
+/**
+ * @brief Error-returning variant of `sctp_encoder_add_checksum_to`.
+ * @return `SCTP_OK`, `SCTP_ERR_NO_SPACE`, or `SCTP_ERR_INVALID_ARG` if
+ *         checksumming is off.
+ */
+SCTP_API int sctp_encoder_try_add_checksum_to(sctp_encoder_t* enc);
+
+/**
+ * @brief Turns checksum verification on or off for a decoder.
+ *
+ * When turned on, the bytes from the current position on are folded into a
+ * CRC32C as `sctp_decoder_next` reads them. On reaching EOF, the last field
+ * must be a checksum trailer matching the bytes before it; otherwise
+ * `sctp_decoder_next` aborts and `sctp_decoder_try_next` returns
+ * `SCTP_ERR_CHECKSUM` without consuming the EOF. Verification ends once the
+ * trailer has been checked. Skipping fields is allowed, but
+ * `sctp_decoder_seek`, `sctp_decoder_restore` and rebinding the decoder turn
+ * verification off.
+ *
+ * @param dec The decoder.
+ * @param enabled True to start verifying, false to stop.
+ */
+SCTP_API void sctp_decoder_set_checksum(sctp_decoder_t* dec, bool enabled);
+
+// --- Statistics API ---
+//
+// Compiled in with `SCTP_STATS`. Without it none of the declarations below
+// exist and the recording hooks expand to nothing, so the counters cost
+// nothing in a normal build.
+
+/** @brief Number of buckets in the LEB128 length histogram (1 to 10 bytes). */
+#define SCTP_STATS_LEB128_BUCKETS 10
+
+/**
+ * @brief Number of buckets in the vector size histogram.
+ *
+ * Bucket 0 counts empty vectors and bucket `i` counts sizes in
+ * `[2^(i-1), 2^i)`. The last bucket also holds everything larger.
+ */
+#define SCTP_STATS_SIZE_BUCKETS 33
+
+#ifdef SCTP_STATS
+/**
+ * @brief Counters for one direction (encoding or decoding).
+ *
+ * Every member is a `uint64_t`, so a host can read the struct as a plain
+ * array of 64-bit integers.
+ */
+typedef struct
+{
+    uint64_t fields[16];                                 ///< Fields per type, indexed by `sctp_type_t`.
+    uint64_t bytes[16];                                  ///< Wire bytes per type, including headers and prefixes.
+    uint64_t leb128_lengths[SCTP_STATS_LEB128_BUCKETS]; ///< ULEB128/SLEB128 fields by value length; index 0 is 1 byte.
+    uint64_t vector_sizes[SCTP_STATS_SIZE_BUCKETS];     ///< Vectors by payload size, see `SCTP_STATS_SIZE_BUCKETS`.
+    uint64_t vector_long_prefix;                         ///< Vectors that needed a ULEB128 length prefix.
+} sctp_stats_counters_t;
+
+/** @brief Process-wide counters returned by `sctp_stats_get`. */
+typedef struct
+{
+    sctp_stats_counters_t encoded; ///< Fields written by encoders. Measuring encoders are not counted.
+    sctp_stats_counters_t decoded; ///< Fields returned by the stateful and streaming decoders.
+    uint64_t capacity_high_water;  ///< Largest encoder buffer allocated, in bytes.
+} sctp_stats_t;
+
+/**
+ * @brief Returns the live counters.
+ *
+ * The counters are updated in place, so the pointer stays valid and can be
+ * read again at any time. A wasm host reads `sizeof(sctp_stats_t) / 8`
+ * 64-bit integers from the returned address.
+ *
+ * @note The counters are not synchronized. Updates from concurrent threads,
+ *       such as `sctp_index_decode_parallel` workers, may be lost.
+ */
+SCTP_API const sctp_stats_t* sctp_stats_get(void);
+
+/** @brief Sets all counters to zero. */
+SCTP_API void sctp_stats_reset(void);
+
+// Internal recording hooks used by encoder.c and decoder.c.
+
+#ifdef SCTP_HEADER_ONLY
+static sctp_stats_t g_sctp_stats;
+#else
+extern sctp_stats_t g_sctp_stats;
+#endif
+
+/**
+ * @brief Records one field.
+ * @param counters The direction to record into.
+ * @param type The field type.
+ * @param length The size of the whole field on the wire.
+ * @param payload The payload size, used for the vector histogram.
+ */
+static inline void _sctp_stats_record(sctp_stats_counters_t* counters, sctp_type_t type, size_t length,
+                                      size_t payload)
+{
+    counters->fields[type & 0x0F]++;
+    counters->bytes[type & 0x0F] += length;
+    if (type == SCTP_TYPE_ULEB128 || type == SCTP_TYPE_SLEB128)
+    {
+        size_t leb_length = length - 1;
+        if (leb_length > SCTP_STATS_LEB128_BUCKETS)
+            leb_length = SCTP_STATS_LEB128_BUCKETS;
+        counters->leb128_lengths[leb_length - 1]++;
+    }
+    else if (type == SCTP_TYPE_VECTOR)
+    {
+        size_t bucket = payload ? (size_t)(64 - __builtin_clzll((unsigned long long)payload)) : 0;
+        if (bucket >= SCTP_STATS_SIZE_BUCKETS)
+            bucket = SCTP_STATS_SIZE_BUCKETS - 1;
+        counters->vector_sizes[bucket]++;
+        if (payload >= 15)
+            counters->vector_long_prefix++;
+    }
+}
+
+/** @brief Records `count` fixed-width fields that take `length` bytes in total. */
+static inline void _sctp_stats_record_many(sctp_stats_counters_t* counters, sctp_type_t type, size_t count,
+                                           size_t length)
+{
+    counters->fields[type & 0x0F] += count;
+    counters->bytes[type & 0x0F] += length;
+}
+
+/** @brief Raises the capacity high-water mark to `capacity` if it is larger. */
+static inline void _sctp_stats_record_capacity(size_t capacity)
+{
+    if (capacity > g_sctp_stats.capacity_high_water)
+        g_sctp_stats.capacity_high_water = capacity;
+}
+
+#define SCTP_STATS_ENCODED(type, length, payload) _sctp_stats_record(&g_sctp_stats.encoded, type, length, payload)
+#define SCTP_STATS_ENCODED_MANY(type, count, length) \
+    _sctp_stats_record_many(&g_sctp_stats.encoded, type, count, length)
+#define SCTP_STATS_DECODED(type, length, payload) _sctp_stats_record(&g_sctp_stats.decoded, type, length, payload)
+#define SCTP_STATS_CAPACITY(capacity) _sctp_stats_record_capacity(capacity)
+#else
+#define SCTP_STATS_ENCODED(type, length, payload) ((void)0)
+#define SCTP_STATS_ENCODED_MANY(type, count, length) ((void)0)
+#define SCTP_STATS_DECODED(type, length, payload) ((void)0)
+#define SCTP_STATS_CAPACITY(capacity) ((void)0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef SCTP_HEADER_ONLY
+#include "encoder.c"
+#include "decoder.c"
+#include "stats.c"
+#include "arena.c"
+#include "checksum.c"
+#include "parallel.c"
+#endif
 
 #endif // SCTP_H
@@ -0,0 +1,645 @@
+#ifndef SCTP_HPP
+#define SCTP_HPP
+
+/**
+ * @file sctp.hpp
+ * @brief Typed, variadic C++20 encoding and decoding on top of sctp.h.
+ *
+ * The field sequence of a message is given by the argument or template types,
+ * so every header byte, size and read is chosen at compile time and there is
+ * no `switch` on the decoded type at run time:
+ *
+ * @code
+ * sctp::encode(enc, uint64_t{nonce}, sctp::uleb128{fee}, sctp::vec(to, 20));
+ *
+ * auto tx = sctp::decode<uint64_t, sctp::uleb128, sctp::vec>(message);
+ * if (!tx) { ... }
+ * auto [nonce, fee, to] = *tx;
+ * @endcode
+ *
+ * `encode` measures every field first and makes a single reservation for the
+ * whole sequence. `decode` checks up front that the input can hold the
+ * minimum size of every field, so runs of fixed-width fields are read with a
+ * header comparison each and no further bounds checks. Variable-length
+ * fields are read with the `sctp_schema.h` readers, after which the check is
+ * repeated for the fields that remain. Vectors are `std::span` views into
+ * the input.
+ *
+ * Field types are the fixed-width `int8_t` ... `uint64_t`, `float` and
+ * `double`, matched exactly (an `unsigned long long` is not a `uint64_t` on
+ * every platform), and the wrappers below. This is a layer over the compiled
+ * library; link `encoder.c` and `decoder.c` as usual. It does not support
+ * `SCTP_HEADER_ONLY`, because the C sources do not compile as C++.
+ */
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <utility>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic" // sctp_index_t ends in a flexible array member.
+#endif
+#include "sctp.h"
+#include "sctp_schema.h"
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+#ifdef SCTP_HEADER_ONLY
+#error "sctp.hpp needs the compiled library; SCTP_HEADER_ONLY is not supported in C++"
+#endif
+
+static_assert(std::endian::native == std::endian::little,
+              "fixed-width fields are copied in host byte order, as the C encoder does");
+
+namespace sctp
+{
+
+// --- Field Types ---
+
+/** @brief A ULEB128 field. */
+struct uleb128
+{
+    uint64_t value;
+    friend constexpr bool operator==(const uleb128&, const uleb128&) = default;
+};
+
+/** @brief An SLEB128 field. */
+struct sleb128
+{
+    int64_t value;
+    friend constexpr bool operator==(const sleb128&, const sleb128&) = default;
+};
+
+/** @brief A SHORT field, holding 0-15 in its header byte. */
+struct short_field
+{
+    uint8_t value;
+    friend constexpr bool operator==(const short_field&, const short_field&) = default;
+};
+
+/** @brief A VECTOR field: a view of its contents. Decoded vectors point into the input. */
+using vec = std::span<const uint8_t>;
+
+/**
+ * @brief A PACKED array of fixed-width elements.
+ *
+ * Decoded arrays point into the input, where the elements need not be
+ * aligned, so they are read with `operator[]` rather than exposed as a
+ * `std::span<const T>`.
+ */
+template <class T>
+class packed
+{
+  public:
+    using value_type = T;
+
+    constexpr packed() = default;
+
+    /** @brief Views `values` for encoding. */
+    packed(std::span<const T> values)
+        : bytes_(reinterpret_cast<const uint8_t*>(values.data())), count_(values.size())
+    {
+    }
+
+    /** @brief Views `count` elements stored at `bytes`. */
+    constexpr packed(const uint8_t* bytes, size_t count) : bytes_(bytes), count_(count)
+    {
+    }
+
+    /** @brief Number of elements. */
+    constexpr size_t size() const
+    {
+        return count_;
+    }
+
+    /** @brief The elements as stored, little-endian and possibly unaligned. */
+    constexpr const uint8_t* bytes() const
+    {
+        return bytes_;
+    }
+
+    /** @brief Reads element `index`. */
+    T operator[](size_t index) const
+    {
+        T value;
+        std::memcpy(&value, bytes_ + index * sizeof(T), sizeof(T));
+        return value;
+    }
+
+  private:
+    const uint8_t* bytes_ = nullptr;
+    size_t count_ = 0;
+};
+
+namespace detail
+{
+
+// --- Wire Format Helpers ---
+
+constexpr uint8_t header(sctp_type_t type, uint8_t meta = 0)
+{
+    return static_cast<uint8_t>(type | meta << 4);
+}
+
+constexpr size_t uleb128_size(uint64_t value)
+{
+    return static_cast<size_t>(64 - std::countl_zero(value | 1) + 6) / 7;
+}
+
+constexpr size_t sleb128_size(int64_t value)
+{
+    // Significant bits of the magnitude, plus a sign bit.
+    const uint64_t magnitude = value < 0 ? ~static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    return static_cast<size_t>(64 - std::countl_zero(magnitude) + 7) / 7;
+}
+
+inline uint8_t* write_uleb128(uint8_t* out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        *out++ = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(value);
+    return out;
+}
+
+inline uint8_t* write_sleb128(uint8_t* out, int64_t value)
+{
+    for (size_t length = sleb128_size(value); length > 1; length--)
+    {
+        *out++ = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(value & 0x7F);
+    return out;
+}
+
+/** @brief Adds two sizes, saturating at `SIZE_MAX` so an impossible size fails the reservation. */
+constexpr size_t add_size(size_t a, size_t b)
+{
+    return b <= SIZE_MAX - a ? a + b : SIZE_MAX;
+}
+
+constexpr size_t vector_prefix_size(size_t length)
+{
+    return length < 0x0F ? 1 : 1 + uleb128_size(length);
+}
+
+// --- Field Traits ---
+//
+// Each field type provides its header, its minimum encoded size, whether that
+// size is fixed, its exact size and writer, and a checked reader with the
+// conventions of sctp_schema.h: `*position` only advances on success.
+// Fixed-width types also have a reader for when the bounds are known.
+
+template <class T>
+struct field_traits;
+
+template <class T, sctp_type_t Type>
+struct fixed_field
+{
+    static constexpr sctp_type_t type = Type;
+    static constexpr bool fixed = true;
+    static constexpr size_t min_size = 1 + sizeof(T);
+
+    static constexpr bool valid(const T&)
+    {
+        return true;
+    }
+
+    static constexpr size_t size(const T&)
+    {
+        return min_size;
+    }
+
+    static uint8_t* write(uint8_t* out, const T& value)
+    {
+        out[0] = header(Type);
+        std::memcpy(out + 1, &value, sizeof(T));
+        return out + min_size;
+    }
+
+    /** @brief Reads the field at `field`, which is known to have `min_size` bytes. */
+    static int read_unchecked(const uint8_t* field, T& out)
+    {
+        if ((field[0] & 0x0F) != Type)
+            return SCTP_ERR_TYPE_MISMATCH;
+        std::memcpy(&out, field + 1, sizeof(T));
+        return SCTP_OK;
+    }
+
+    static int read(const uint8_t* data, size_t size, size_t* position, T& out)
+    {
+        if (*position >= size)
+            return SCTP_ERR_TRUNCATED;
+        if ((data[*position] & 0x0F) != Type)
+            return SCTP_ERR_TYPE_MISMATCH;
+        if (size - *position < min_size)
+            return SCTP_ERR_TRUNCATED;
+        std::memcpy(&out, data + *position + 1, sizeof(T));
+        *position += min_size;
+        return SCTP_OK;
+    }
+};
+
+template <>
+struct field_traits<int8_t> : fixed_field<int8_t, SCTP_TYPE_INT8>
+{
+};
+template <>
+struct field_traits<uint8_t> : fixed_field<uint8_t, SCTP_TYPE_UINT8>
+{
+};
+template <>
+struct field_traits<int16_t> : fixed_field<int16_t, SCTP_TYPE_INT16>
+{
+};
+template <>
+struct field_traits<uint16_t> : fixed_field<uint16_t, SCTP_TYPE_UINT16>
+{
+};
+template <>
+struct field_traits<int32_t> : fixed_field<int32_t, SCTP_TYPE_INT32>
+{
+};
+template <>
+struct field_traits<uint32_t> : fixed_field<uint32_t, SCTP_TYPE_UINT32>
+{
+};
+template <>
+struct field_traits<int64_t> : fixed_field<int64_t, SCTP_TYPE_INT64>
+{
+};
+template <>
+struct field_traits<uint64_t> : fixed_field<uint64_t, SCTP_TYPE_UINT64>
+{
+};
+template <>
+struct field_traits<float> : fixed_field<float, SCTP_TYPE_FLOAT32>
+{
+};
+template <>
+struct field_traits<double> : fixed_field<double, SCTP_TYPE_FLOAT64>
+{
+};
+
+template <>
+struct field_traits<uleb128>
+{
+    static constexpr sctp_type_t type = SCTP_TYPE_ULEB128;
+    static constexpr bool fixed = false;
+    static constexpr size_t min_size = 2;
+
+    static constexpr bool valid(const uleb128&)
+    {
+        return true;
+    }
+
+    static constexpr size_t size(const uleb128& field)
+    {
+        return 1 + uleb128_size(field.value);
+    }
+
+    static uint8_t* write(uint8_t* out, const uleb128& field)
+    {
+        *out = header(type);
+        return write_uleb128(out + 1, field.value);
+    }
+
+    static int read(const uint8_t* data, size_t size, size_t* position, uleb128& out)
+    {
+        return sctp_schema_read_uleb128(data, size, position, &out.value);
+    }
+};
+
+template <>
+struct field_traits<sleb128>
+{
+    static constexpr sctp_type_t type = SCTP_TYPE_SLEB128;
+    static constexpr bool fixed = false;
+    static constexpr size_t min_size = 2;
+
+    static constexpr bool valid(const sleb128&)
+    {
+        return true;
+    }
+
+    static constexpr size_t size(const sleb128& field)
+    {
+        return 1 + sleb128_size(field.value);
+    }
+
+    static uint8_t* write(uint8_t* out, const sleb128& field)
+    {
+        *out = header(type);
+        return write_sleb128(out + 1, field.value);
+    }
+
+    static int read(const uint8_t* data, size_t size, size_t* position, sleb128& out)
+    {
+        return sctp_schema_read_sleb128(data, size, position, &out.value);
+    }
+};
+
+template <>
+struct field_traits<short_field>
+{
+    static constexpr sctp_type_t type = SCTP_TYPE_SHORT;
+    static constexpr bool fixed = false; // One byte, but its value is in the header.
+    static constexpr size_t min_size = 1;
+
+    static constexpr bool valid(const short_field& field)
+    {
+        return field.value <= 15;
+    }
+
+    static constexpr size_t size(const short_field&)
+    {
+        return 1;
+    }
+
+    static uint8_t* write(uint8_t* out, const short_field& field)
+    {
+        *out = header(type, field.value);
+        return out + 1;
+    }
+
+    static int read(const uint8_t* data, size_t size, size_t* position, short_field& out)
+    {
+        return sctp_schema_read_short(data, size, position, &out.value);
+    }
+};
+
+template <>
+struct field_traits<vec>
+{
+    static constexpr sctp_type_t type = SCTP_TYPE_VECTOR;
+    static constexpr bool fixed = false;
+    static constexpr size_t min_size = 1;
+
+    static constexpr bool valid(const vec&)
+    {
+        return true;
+    }
+
+    static constexpr size_t size(const vec& field)
+    {
+        return add_size(vector_prefix_size(field.size()), field.size());
+    }
+
+    static uint8_t* write(uint8_t* out, const vec& field)
+    {
+        if (field.size() < 0x0F)
+        {
+            *out++ = header(type, static_cast<uint8_t>(field.size()));
+        }
+        else
+        {
+            *out++ = header(type, 0x0F);
+            out = write_uleb128(out, field.size());
+        }
+        if (!field.empty())
+            std::memcpy(out, field.data(), field.size());
+        return out + field.size();
+    }
+
+    /** @brief Reads a vector or a back-reference to one. */
+    static int read(const uint8_t* data, size_t size, size_t* position, vec& out)
+    {
+        sctp_bytes_t bytes;
+        int status = sctp_schema_read_vector(data, size, position, &bytes);
+        if (status == SCTP_OK)
+            out = vec(bytes.data, bytes.size);
+        return status;
+    }
+};
+
+template <class T>
+struct field_traits<packed<T>>
+{
+    static_assert(field_traits<T>::fixed, "packed arrays hold fixed-width elements only");
+
+    static constexpr sctp_type_t type = SCTP_TYPE_PACKED;
+    static constexpr bool fixed = false;
+    static constexpr size_t min_size = 2;
+
+    static constexpr bool valid(const packed<T>&)
+    {
+        return true;
+    }
+
+    static constexpr size_t size(const packed<T>& field)
+    {
+        if (field.size() > SIZE_MAX / sizeof(T))
+            return SIZE_MAX;
+        return add_size(1 + uleb128_size(field.size()), field.size() * sizeof(T));
+    }
+
+    static uint8_t* write(uint8_t* out, const packed<T>& field)
+    {
+        *out = header(type, field_traits<T>::type);
+        out = write_uleb128(out + 1, field.size());
+        if (field.size())
+            std::memcpy(out, field.bytes(), field.size() * sizeof(T));
+        return out + field.size() * sizeof(T);
+    }
+
+    static int read(const uint8_t* data, size_t size, size_t* position, packed<T>& out)
+    {
+        if (*position >= size)
+            return SCTP_ERR_TRUNCATED;
+        if (data[*position] != header(type, field_traits<T>::type))
+            return SCTP_ERR_TYPE_MISMATCH;
+        int status = SCTP_OK;
+        uint64_t count;
+        const size_t prefix = sctp_schema_read_leb128(data, size, *position + 1, &count, false, &status);
+        if (!prefix)
+            return status;
+        const size_t start = *position + 1 + prefix;
+        if (count > (size - start) / sizeof(T))
+            return SCTP_ERR_TRUNCATED;
+        out = packed<T>(data + start, static_cast<size_t>(count));
+        *position = start + static_cast<size_t>(count) * sizeof(T);
+        return SCTP_OK;
+    }
+};
+
+} // namespace detail
+
+/** @brief A type that can be used as a field. */
+template <class T>
+concept field = requires { detail::field_traits<T>::type; };
+
+// --- Sizes ---
+
+/** @brief The exact encoded size of a field sequence. */
+template <field... Ts>
+constexpr size_t size(const Ts&... values)
+{
+    size_t total = 0;
+    ((total = detail::add_size(total, detail::field_traits<Ts>::size(values))), ...);
+    return total;
+}
+
+/** @brief The encoded size of a sequence of fixed-width fields, as a constant. */
+template <field... Ts>
+    requires(detail::field_traits<Ts>::fixed && ...)
+inline constexpr size_t fixed_size = (size_t{0} + ... + detail::field_traits<Ts>::min_size);
+
+// --- Encoding ---
+
+/**
+ * @brief Appends a field sequence to an encoder with one reservation.
+ *
+ * Vectors are always written in full, even if the encoder has a dictionary.
+ * For a measuring encoder only the size is counted.
+ *
+ * @return `SCTP_OK`, `SCTP_ERR_NO_SPACE`, or `SCTP_ERR_INVALID_ARG` if `enc`
+ *         is NULL or a `short_field` is above 15. Nothing is written on
+ *         failure.
+ */
+template <field... Ts>
+int encode(sctp_encoder_t* enc, const Ts&... values)
+{
+    if (!enc || !(detail::field_traits<Ts>::valid(values) && ...))
+        return SCTP_ERR_INVALID_ARG;
+    void* ptr;
+    int status = sctp_encoder_try_add_raw_to(enc, size(values...), &ptr);
+    if (status != SCTP_OK || !ptr)
+        return status;
+    uint8_t* out = static_cast<uint8_t*>(ptr);
+    ((out = detail::field_traits<Ts>::write(out, values)), ...);
+    return SCTP_OK;
+}
+
+/**
+ * @brief Writes a field sequence into a caller buffer.
+ * @return The number of bytes written, or 0 if the sequence does not fit or
+ *         a `short_field` is above 15.
+ */
+template <field... Ts>
+size_t encode(std::span<uint8_t> out, const Ts&... values)
+{
+    const size_t total = size(values...);
+    if (total > out.size() || !(detail::field_traits<Ts>::valid(values) && ...))
+        return 0;
+    uint8_t* cursor = out.data();
+    ((cursor = detail::field_traits<Ts>::write(cursor, values)), ...);
+    return total;
+}
+
+// --- Decoding ---
+
+namespace detail
+{
+
+/** @brief Minimum encoded size of the fields from each index to the end. */
+template <class... Ts>
+constexpr std::array<size_t, sizeof...(Ts) + 1> min_suffix()
+{
+    constexpr size_t sizes[] = {field_traits<Ts>::min_size..., 0};
+    std::array<size_t, sizeof...(Ts) + 1> rest{};
+    for (size_t i = sizeof...(Ts); i-- > 0;)
+        rest[i] = rest[i + 1] + sizes[i];
+    return rest;
+}
+
+/**
+ * @brief Reads one field of a sequence.
+ * @param rest Minimum size of the fields after this one.
+ * @param checked True while the input is known to hold the minimum size of
+ *        this and every later field.
+ */
+template <class T>
+int read_field(const uint8_t* data, size_t size, size_t* position, T& out, size_t rest, bool& checked)
+{
+    using traits = field_traits<T>;
+    if constexpr (traits::fixed)
+    {
+        if (!checked)
+            return traits::read(data, size, position, out);
+        int status = traits::read_unchecked(data + *position, out);
+        if (status == SCTP_OK)
+            *position += traits::min_size;
+        return status;
+    }
+    else
+    {
+        int status = traits::read(data, size, position, out);
+        checked = status == SCTP_OK && size - *position >= rest;
+        return status;
+    }
+}
+
+template <class... Ts, size_t... I>
+int read_fields(const uint8_t* data, size_t size, size_t* position, std::index_sequence<I...>, Ts&... out)
+{
+    static constexpr auto rest = min_suffix<Ts...>();
+    bool checked = size - *position >= rest[0];
+    int status = SCTP_OK;
+    // Left to right, stopping at the first failure.
+    (void)(((status = read_field(data, size, position, out, rest[I + 1], checked)) == SCTP_OK) && ...);
+    return status;
+}
+
+} // namespace detail
+
+/**
+ * @brief Reads a field sequence at the decoder's position.
+ *
+ * Like a `NAME_decode` function from `sctp_schema.h`: on success the
+ * position is moved past the fields, on failure it is left at the offending
+ * field. The `last_*` members are not used and checksum verification does
+ * not see these fields.
+ *
+ * @return `SCTP_OK`, `SCTP_ERR_TYPE_MISMATCH` if a field has another type,
+ *         `SCTP_ERR_TRUNCATED`, `SCTP_ERR_OVERFLOW`,
+ *         `SCTP_ERR_BAD_REFERENCE`, or `SCTP_ERR_INVALID_ARG` if `dec` is
+ *         NULL.
+ */
+template <field... Ts>
+int decode_into(sctp_decoder_t* dec, Ts&... out)
+{
+    if (!dec)
+        return SCTP_ERR_INVALID_ARG;
+    // Positions are kept relative to `origin`, for back-references.
+    const size_t base = dec->origin ? static_cast<size_t>(dec->data - dec->origin) : 0;
+    size_t position = base + dec->position;
+    int status = detail::read_fields(dec->data - base, base + dec->size, &position, std::index_sequence_for<Ts...>{},
+                                     out...);
+    dec->position = position - base;
+    return status;
+}
+
+/**
+ * @brief Decodes a whole message made of exactly the given fields.
+ *
+ * The fields must be followed by EOF or the end of the buffer.
+ *
+ * @return The fields, or `std::nullopt` if the message does not match.
+ */
+template <field... Ts>
+std::optional<std::tuple<Ts...>> decode(std::span<const uint8_t> message)
+{
+    sctp_decoder_t dec;
+    sctp_decoder_bind(&dec, message.data(), message.size());
+    std::tuple<Ts...> values{};
+    if (std::apply([&dec](Ts&... out) { return decode_into(&dec, out...); }, values) != SCTP_OK)
+        return std::nullopt;
+    if (sctp_decoder_try_next(&dec) != SCTP_OK || dec.last_type != SCTP_TYPE_EOF)
+        return std::nullopt;
+    return values;
+}
+
+} // namespace sctp
+
+#endif // SCTP_HPP
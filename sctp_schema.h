@@ -0,0 +1,350 @@
+#ifndef SCTP_SCHEMA_H
+#define SCTP_SCHEMA_H
+
+#include "sctp.h"
+
+/**
+ * @file sctp_schema.h
+ * @brief Compile-time schemas for messages with a fixed field sequence.
+ *
+ * A schema is an X-macro listing the fields of a message in order, each as
+ * `X(kind, name)`. `SCTP_SCHEMA_DEFINE` expands it into a C struct and
+ * specialized functions that decode straight into the struct, encode from it
+ * and measure it. Decoding is straight-line code: each field costs one header
+ * comparison and one bounds check, with no type dispatch, and fails fast with
+ * `SCTP_ERR_TYPE_MISMATCH` if the input does not match the schema.
+ *
+ * Supported kinds are the fixed-width types (`int8` ... `uint64`, `float32`,
+ * `float64`), `uleb128`, `sleb128`, `short` and `vector`. Vector members are
+ * `sctp_bytes_t` views into the decoded buffer.
+ *
+ * @code
+ * #define TX_FIELDS(X) \
+ *     X(uint64, nonce)  \
+ *     X(uleb128, fee)   \
+ *     X(vector, to)
+ *
+ * SCTP_SCHEMA_DEFINE(tx, TX_FIELDS)
+ *
+ * tx_t tx;
+ * if (tx_decode(dec, &tx) != SCTP_OK) { ... }
+ * @endcode
+ */
+
+/**
+ * @brief A view of a vector's contents inside an encoded buffer.
+ */
+typedef struct sctp_bytes {
+    const uint8_t* data; ///< Start of the vector contents.
+    size_t size;         ///< Size of the vector in bytes.
+} sctp_bytes_t;
+
+// --- Field Readers ---
+//
+// Each reader checks the header and bounds of one field at `*position`, and
+// only advances `*position` on success.
+
+#define SCTP_SCHEMA_HEADER_TYPE(header) ((sctp_type_t)((header) & 0x0F))
+#define SCTP_SCHEMA_HEADER_META(header) ((uint8_t)((header) >> 4))
+
+/**
+ * @brief Reads a LEB128 sequence without aborting.
+ *
+ * The tenth byte only holds bit 63, so it must be 0x00 or 0x01 for ULEB128,
+ * and 0x00 or 0x7F (the sign extension of bit 63) for SLEB128, as in the
+ * core decoder.
+ *
+ * @param is_signed True to check the sequence as SLEB128.
+ * @return The length of the sequence, or 0 if it is truncated or does not
+ *         fit in 64 bits (`*status` says which).
+ */
+static inline size_t sctp_schema_read_leb128(const uint8_t* data, size_t size, size_t position, uint64_t* value,
+                                             bool is_signed, int* status)
+{
+    uint64_t result = 0;
+    for (size_t i = 0; i < 10; i++)
+    {
+        if (position + i >= size)
+        {
+            *status = SCTP_ERR_TRUNCATED;
+            return 0;
+        }
+        const uint8_t byte = data[position + i];
+        if (i == 9 && (is_signed ? byte != 0x00 && byte != 0x7F : byte > 0x01))
+            break;
+        result |= (uint64_t)(byte & 0x7F) << (7 * i);
+        if ((byte & 0x80) == 0)
+        {
+            *value = result;
+            return i + 1;
+        }
+    }
+    *status = SCTP_ERR_OVERFLOW;
+    return 0;
+}
+
+#define SCTP_SCHEMA_DEFINE_FIXED_READER(name, type, sctp_type)                                                  \
+    static inline int sctp_schema_read_##name(const uint8_t* data, size_t size, size_t* position, type* out) \
+    {                                                                                                        \
+        if (*position >= size)                                                                               \
+            return SCTP_ERR_TRUNCATED;                                                                       \
+        if (SCTP_SCHEMA_HEADER_TYPE(data[*position]) != (sctp_type))                                         \
+            return SCTP_ERR_TYPE_MISMATCH;                                                                   \
+        if (size - *position < 1 + sizeof(type))                                                             \
+            return SCTP_ERR_TRUNCATED;                                                                       \
+        memcpy(out, data + *position + 1, sizeof(type));                                                     \
+        *position += 1 + sizeof(type);                                                                       \
+        return SCTP_OK;                                                                                      \
+    }
+
+SCTP_SCHEMA_DEFINE_FIXED_READER(int8, int8_t, SCTP_TYPE_INT8)
+SCTP_SCHEMA_DEFINE_FIXED_READER(uint8, uint8_t, SCTP_TYPE_UINT8)
+SCTP_SCHEMA_DEFINE_FIXED_READER(int16, int16_t, SCTP_TYPE_INT16)
+SCTP_SCHEMA_DEFINE_FIXED_READER(uint16, uint16_t, SCTP_TYPE_UINT16)
+SCTP_SCHEMA_DEFINE_FIXED_READER(int32, int32_t, SCTP_TYPE_INT32)
+SCTP_SCHEMA_DEFINE_FIXED_READER(uint32, uint32_t, SCTP_TYPE_UINT32)
+SCTP_SCHEMA_DEFINE_FIXED_READER(int64, int64_t, SCTP_TYPE_INT64)
+SCTP_SCHEMA_DEFINE_FIXED_READER(uint64, uint64_t, SCTP_TYPE_UINT64)
+SCTP_SCHEMA_DEFINE_FIXED_READER(float32, float, SCTP_TYPE_FLOAT32)
+SCTP_SCHEMA_DEFINE_FIXED_READER(float64, double, SCTP_TYPE_FLOAT64)
+
+static inline int sctp_schema_read_uleb128(const uint8_t* data, size_t size, size_t* position, uint64_t* out)
+{
+    if (*position >= size)
+        return SCTP_ERR_TRUNCATED;
+    if (SCTP_SCHEMA_HEADER_TYPE(data[*position]) != SCTP_TYPE_ULEB128)
+        return SCTP_ERR_TYPE_MISMATCH;
+    int status = SCTP_OK;
+    size_t length = sctp_schema_read_leb128(data, size, *position + 1, out, false, &status);
+    if (!length)
+        return status;
+    *position += 1 + length;
+    return SCTP_OK;
+}
+
+static inline int sctp_schema_read_sleb128(const uint8_t* data, size_t size, size_t* position, int64_t* out)
+{
+    if (*position >= size)
+        return SCTP_ERR_TRUNCATED;
+    if (SCTP_SCHEMA_HEADER_TYPE(data[*position]) != SCTP_TYPE_SLEB128)
+        return SCTP_ERR_TYPE_MISMATCH;
+    int status = SCTP_OK;
+    uint64_t bits;
+    size_t length = sctp_schema_read_leb128(data, size, *position + 1, &bits, true, &status);
+    if (!length)
+        return status;
+    // Sign-extend from the last payload bit.
+    if (length < 10 && (data[*position + length] & 0x40))
+        bits |= ~0ULL << (7 * length);
+    *out = (int64_t)bits;
+    *position += 1 + length;
+    return SCTP_OK;
+}
+
+static inline int sctp_schema_read_short(const uint8_t* data, size_t size, size_t* position, uint8_t* out)
+{
+    if (*position >= size)
+        return SCTP_ERR_TRUNCATED;
+    if (SCTP_SCHEMA_HEADER_TYPE(data[*position]) != SCTP_TYPE_SHORT)
+        return SCTP_ERR_TYPE_MISMATCH;
+    *out = SCTP_SCHEMA_HEADER_META(data[*position]);
+    *position += 1;
+    return SCTP_OK;
+}
+
+static inline int sctp_schema_read_vector(const uint8_t* data, size_t size, size_t* position, sctp_bytes_t* out);
+
+/**
+ * @brief Reads a vector back-reference, resolving it to the earlier vector.
+ *
+ * The target is read as a vector that must end before the back-reference,
+ * so a chain of back-references is rejected.
+ */
+static inline int sctp_schema_read_vector_ref(const uint8_t* data, size_t size, size_t* position, sctp_bytes_t* out)
+{
+    int status = SCTP_OK;
+    uint64_t distance;
+    size_t length = sctp_schema_read_leb128(data, size, *position + 1, &distance, false, &status);
+    if (!length)
+        return status;
+    if (distance == 0 || distance > *position)
+        return SCTP_ERR_BAD_REFERENCE;
+    size_t target = *position - (size_t)distance;
+    if (SCTP_SCHEMA_HEADER_TYPE(data[target]) != SCTP_TYPE_VECTOR ||
+        sctp_schema_read_vector(data, *position, &target, out) != SCTP_OK)
+        return SCTP_ERR_BAD_REFERENCE;
+    *position += 1 + length;
+    return SCTP_OK;
+}
+
+static inline int sctp_schema_read_vector(const uint8_t* data, size_t size, size_t* position, sctp_bytes_t* out)
+{
+    if (*position >= size)
+        return SCTP_ERR_TRUNCATED;
+    const uint8_t header = data[*position];
+    if (SCTP_SCHEMA_HEADER_TYPE(header) == SCTP_TYPE_PACKED && SCTP_SCHEMA_HEADER_META(header) == SCTP_TYPE_VECTOR)
+        return sctp_schema_read_vector_ref(data, size, position, out);
+    if (SCTP_SCHEMA_HEADER_TYPE(header) != SCTP_TYPE_VECTOR)
+        return SCTP_ERR_TYPE_MISMATCH;
+    size_t start = *position + 1;
+    uint64_t length = SCTP_SCHEMA_HEADER_META(header);
+    if (length == 0x0F)
+    {
+        int status = SCTP_OK;
+        size_t prefix = sctp_schema_read_leb128(data, size, start, &length, false, &status);
+        if (!prefix)
+            return status;
+        start += prefix;
+    }
+    if (length > size - start)
+        return SCTP_ERR_TRUNCATED;
+    out->data = data + start;
+    out->size = (size_t)length;
+    *position = start + (size_t)length;
+    return SCTP_OK;
+}
+
+// --- Field Writers and Sizes ---
+
+#define SCTP_SCHEMA_DEFINE_FIXED_WRITER(name, type)                                        \
+    static inline void sctp_schema_write_##name(sctp_encoder_t* enc, const type* value) \
+    {                                                                                   \
+        sctp_encoder_add_##name##_to(enc, *value);                                      \
+    }                                                                                   \
+    static inline size_t sctp_schema_size_##name(const type* value)                     \
+    {                                                                                   \
+        (void)value;                                                                    \
+        return sctp_size_##name();                                                      \
+    }
+
+SCTP_SCHEMA_DEFINE_FIXED_WRITER(int8, int8_t)
+SCTP_SCHEMA_DEFINE_FIXED_WRITER(uint8, uint8_t)
+SCTP_SCHEMA_DEFINE_FIXED_WRITER(int16, int16_t)
+SCTP_SCHEMA_DEFINE_FIXED_WRITER(uint16, uint16_t)
+SCTP_SCHEMA_DEFINE_FIXED_WRITER(int32, int32_t)
+SCTP_SCHEMA_DEFINE_FIXED_WRITER(uint32, uint32_t)
+SCTP_SCHEMA_DEFINE_FIXED_WRITER(int64, int64_t)
+SCTP_SCHEMA_DEFINE_FIXED_WRITER(uint64, uint64_t)
+SCTP_SCHEMA_DEFINE_FIXED_WRITER(float32, float)
+SCTP_SCHEMA_DEFINE_FIXED_WRITER(float64, double)
+
+static inline void sctp_schema_write_uleb128(sctp_encoder_t* enc, const uint64_t* value)
+{
+    sctp_encoder_add_uleb128_to(enc, *value);
+}
+
+static inline size_t sctp_schema_size_uleb128(const uint64_t* value)
+{
+    return sctp_size_uleb128(*value);
+}
+
+static inline void sctp_schema_write_sleb128(sctp_encoder_t* enc, const int64_t* value)
+{
+    sctp_encoder_add_sleb128_to(enc, *value);
+}
+
+static inline size_t sctp_schema_size_sleb128(const int64_t* value)
+{
+    return sctp_size_sleb128(*value);
+}
+
+static inline void sctp_schema_write_short(sctp_encoder_t* enc, const uint8_t* value)
+{
+    sctp_encoder_add_short_to(enc, *value);
+}
+
+static inline size_t sctp_schema_size_short(const uint8_t* value)
+{
+    (void)value;
+    return sctp_size_short();
+}
+
+static inline void sctp_schema_write_vector(sctp_encoder_t* enc, const sctp_bytes_t* value)
+{
+    sctp_encoder_add_vector_data_to(enc, value->data, value->size);
+}
+
+static inline size_t sctp_schema_size_vector(const sctp_bytes_t* value)
+{
+    return sctp_size_vector(value->size);
+}
+
+// --- Member Types ---
+
+#define SCTP_SCHEMA_CTYPE_int8 int8_t
+#define SCTP_SCHEMA_CTYPE_uint8 uint8_t
+#define SCTP_SCHEMA_CTYPE_int16 int16_t
+#define SCTP_SCHEMA_CTYPE_uint16 uint16_t
+#define SCTP_SCHEMA_CTYPE_int32 int32_t
+#define SCTP_SCHEMA_CTYPE_uint32 uint32_t
+#define SCTP_SCHEMA_CTYPE_int64 int64_t
+#define SCTP_SCHEMA_CTYPE_uint64 uint64_t
+#define SCTP_SCHEMA_CTYPE_float32 float
+#define SCTP_SCHEMA_CTYPE_float64 double
+#define SCTP_SCHEMA_CTYPE_uleb128 uint64_t
+#define SCTP_SCHEMA_CTYPE_sleb128 int64_t
+#define SCTP_SCHEMA_CTYPE_short uint8_t
+#define SCTP_SCHEMA_CTYPE_vector sctp_bytes_t
+
+// --- Schema Expansion ---
+
+#define SCTP_SCHEMA_MEMBER(kind, name) SCTP_SCHEMA_CTYPE_##kind name;
+
+#define SCTP_SCHEMA_DECODE_FIELD(kind, name)                                              \
+    if ((status = sctp_schema_read_##kind(data, size, &position, &out->name)) != SCTP_OK) \
+        goto fail;
+
+#define SCTP_SCHEMA_ENCODE_FIELD(kind, name) sctp_schema_write_##kind(enc, &in->name);
+
+#define SCTP_SCHEMA_SIZE_FIELD(kind, name) size += sctp_schema_size_##kind(&in->name);
+
+/**
+ * @def SCTP_SCHEMA_DEFINE
+ * @brief Generates a struct and codec functions from a field list.
+ *
+ * For a schema named `NAME` this defines:
+ * - `NAME_t`, a struct with one member per field.
+ * - `int NAME_decode(sctp_decoder_t* dec, NAME_t* out)`, which reads the
+ *   fields at `dec->position` into `out`. On success the position is moved
+ *   past the message; on failure it is moved to the offending field and a
+ *   negative `sctp_status_t` is returned. The `last_*` members are not used.
+ * - `void NAME_encode_to(sctp_encoder_t* enc, const NAME_t* in)`.
+ * - `size_t NAME_size(const NAME_t* in)`, the exact encoded size.
+ *
+ * @param NAME The schema name, used as a prefix.
+ * @param FIELDS An X-macro that applies its argument to each `(kind, name)`.
+ */
+#define SCTP_SCHEMA_DEFINE(NAME, FIELDS)                                          \
+    typedef struct NAME {                                                         \
+        FIELDS(SCTP_SCHEMA_MEMBER)                                                \
+    } NAME##_t;                                                                   \
+                                                                                  \
+    static inline int NAME##_decode(sctp_decoder_t* dec, NAME##_t* out)           \
+    {                                                                             \
+        /* Positions are kept relative to `origin`, for back-references. */      \
+        const size_t base = dec->origin ? (size_t)(dec->data - dec->origin) : 0;  \
+        const uint8_t* data = dec->data - base;                                   \
+        const size_t size = base + dec->size;                                     \
+        size_t position = base + dec->position;                                   \
+        int status;                                                               \
+        FIELDS(SCTP_SCHEMA_DECODE_FIELD)                                          \
+        dec->position = position - base;                                          \
+        return SCTP_OK;                                                           \
+    fail:                                                                         \
+        dec->position = position - base;                                          \
+        return status;                                                            \
+    }                                                                             \
+                                                                                  \
+    static inline void NAME##_encode_to(sctp_encoder_t* enc, const NAME##_t* in)  \
+    {                                                                             \
+        FIELDS(SCTP_SCHEMA_ENCODE_FIELD)                                          \
+    }                                                                             \
+                                                                                  \
+    static inline size_t NAME##_size(const NAME##_t* in)                          \
+    {                                                                             \
+        size_t size = 0;                                                          \
+        FIELDS(SCTP_SCHEMA_SIZE_FIELD)                                            \
+        return size;                                                              \
+    }
+
+#endif // SCTP_SCHEMA_H
@@ -0,0 +1,29 @@
+#include "sctp.h"
+
+/**
+ * @file stats.c
+ * @brief Storage and accessors for the optional `SCTP_STATS` counters.
+ *
+ * The counters are updated by the hooks in sctp.h as fields are encoded and
+ * decoded. Link this file into every module built with `SCTP_STATS`.
+ */
+
+#ifdef SCTP_STATS
+
+#ifndef SCTP_HEADER_ONLY
+sctp_stats_t g_sctp_stats;
+#endif
+
+SCTP_EXPORT(sctp_stats_get)
+const sctp_stats_t *sctp_stats_get(void)
+{
+    return &g_sctp_stats;
+}
+
+SCTP_EXPORT(sctp_stats_reset)
+void sctp_stats_reset(void)
+{
+    memset(&g_sctp_stats, 0, sizeof(g_sctp_stats));
+}
+
+#endif
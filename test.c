@@ -1,4 +1,5 @@
 #include "sctp.h"
+#include "sctp_schema.h"
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
@@ -26,6 +27,88 @@ static void assert_true(bool condition, const char *message)
     }
 }
 
+#ifndef __wasm__
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Runs `fn` in a child process and checks that it aborts, rather than
+// returning or hanging until the alarm fires. The wasm runtime has no
+// processes, so there the aborting APIs are only covered through their
+// non-aborting counterparts.
+static void assert_aborts(void (*fn)(const void *), const void *arg, const char *message)
+{
+    fflush(NULL);
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        alarm(10);
+        fn(arg);
+        _exit(0);
+    }
+    int status = 0;
+    assert_true(pid > 0 && waitpid(pid, &status, 0) == pid && WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT,
+                message);
+}
+#endif
+
+#ifdef SCTP_CALLBACK_BATCH
+static size_t g_batch_calls = 0;
+static size_t g_batch_fields = 0;
+static bool g_batch_saw_eof = false;
+
+// Batched handler used by test_run_batch. Checks the fields it receives
+// follow the pattern written by the test.
+void __sctp_data_handler_batch(const sctp_field_t *fields, size_t count)
+{
+    g_batch_calls++;
+    for (size_t i = 0; i < count; i++)
+    {
+        assert_true(!g_batch_saw_eof, "Field delivered after EOF");
+        if (fields[i].type == SCTP_TYPE_EOF)
+        {
+            assert_true(i == count - 1, "EOF is not the last field of its batch");
+            g_batch_saw_eof = true;
+            continue;
+        }
+        assert_true(fields[i].type == SCTP_TYPE_UINT16, "Type mismatch in batched callback");
+        assert_true(fields[i].value.as_uint16 == (uint16_t)g_batch_fields, "Value mismatch in batched callback");
+        g_batch_fields++;
+    }
+}
+#endif
+
+#ifdef SCTP_FLUSH_ENABLE
+static uint8_t g_flush_output[4096];
+static size_t g_flush_size = 0;
+static size_t g_flush_calls = 0;
+static size_t g_flush_max = 0;
+
+// Flush handler used by test_streaming_encoder. Reassembles the flushed
+// chunks so the test can compare them with a regular encoder's output.
+void __sctp_flush(const void *data, size_t size)
+{
+    assert_true(g_flush_size + size <= sizeof(g_flush_output), "Flushed more than expected");
+    memcpy(g_flush_output + g_flush_size, data, size);
+    g_flush_size += size;
+    g_flush_calls++;
+    if (size > g_flush_max)
+        g_flush_max = size;
+}
+#endif
+
+// Schema used by test_schema_codec.
+#define TEST_TX_FIELDS(X) \
+    X(uint64, nonce)      \
+    X(uleb128, fee)       \
+    X(sleb128, delta)     \
+    X(short, kind)        \
+    X(vector, to)         \
+    X(float64, rate)      \
+    X(uint8, flags)
+
+SCTP_SCHEMA_DEFINE(test_tx, TEST_TX_FIELDS)
+
 static void test_raw_add()
 {
     printf("\n--- 3. Testing sctp_encoder_add_raw with a valid SCTP snippet ---\n");
@@ -106,6 +189,2013 @@ static void test_raw_add()
     printf("\n[OK] Raw add test passed\n");
 }
 
+static void test_encoder_instances()
+{
+    printf("\n--- 4. Testing independent, reusable encoder instances ---\n");
+
+    sctp_encoder_t *outer = sctp_encoder_create(64);
+    sctp_encoder_t *inner = sctp_encoder_create(64);
+
+    // Interleave adds on two encoders to make sure they do not share state.
+    sctp_encoder_add_uint32_to(outer, 0xDEADBEEF);
+    sctp_encoder_add_uleb128_to(inner, 300);
+    sctp_encoder_add_short_to(inner, 7);
+    sctp_encoder_add_eof_to(inner);
+
+    const size_t inner_size = sctp_encoder_get_size(inner);
+    void *vec_ptr = sctp_encoder_add_vector_to(outer, inner_size);
+    memcpy(vec_ptr, sctp_encoder_get_data(inner), inner_size);
+    sctp_encoder_add_eof_to(outer);
+    printf("   Encoded inner payload (%u bytes) into outer envelope (%u bytes).\n",
+           (unsigned int)inner_size, (unsigned int)sctp_encoder_get_size(outer));
+
+    sctp_decoder_t *dec = sctp_decoder_from_buffer(sctp_encoder_get_data(outer), sctp_encoder_get_size(outer));
+    sctp_decoder_next(dec);
+    assert_true(dec->last_type == SCTP_TYPE_UINT32, "Type mismatch for outer UINT32");
+    assert_true(dec->last_value.as_uint32 == 0xDEADBEEF, "Value mismatch for outer UINT32");
+    sctp_decoder_next(dec);
+    assert_true(dec->last_type == SCTP_TYPE_VECTOR, "Type mismatch for outer VECTOR");
+    assert_true(dec->last_size == inner_size, "Size mismatch for outer VECTOR");
+
+    sctp_decoder_t *inner_dec = sctp_decoder_from_buffer(dec->last_value.as_ptr, dec->last_size);
+    sctp_decoder_next(inner_dec);
+    assert_true(inner_dec->last_type == SCTP_TYPE_ULEB128, "Type mismatch for inner ULEB128");
+    assert_true(inner_dec->last_value.as_uleb128 == 300, "Value mismatch for inner ULEB128");
+    sctp_decoder_next(inner_dec);
+    assert_true(inner_dec->last_type == SCTP_TYPE_SHORT, "Type mismatch for inner SHORT");
+    assert_true(inner_dec->last_value.as_short == 7, "Value mismatch for inner SHORT");
+    sctp_decoder_next(inner_dec);
+    assert_true(inner_dec->last_type == SCTP_TYPE_EOF, "Expected EOF in inner payload");
+    sctp_decoder_next(dec);
+    assert_true(dec->last_type == SCTP_TYPE_EOF, "Expected EOF in outer envelope");
+
+    // Reset must rewind the stream but keep the same buffer.
+    const uint8_t *buffer_before = sctp_encoder_get_data(outer);
+    sctp_encoder_reset(outer);
+    assert_true(sctp_encoder_get_size(outer) == 0, "Reset did not rewind the encoder");
+    sctp_encoder_add_int8_to(outer, -5);
+    assert_true(sctp_encoder_get_data(outer) == buffer_before, "Reset reallocated the buffer");
+    assert_true(sctp_encoder_get_size(outer) == 2, "Size mismatch after reset");
+    printf("   Reset reused the existing buffer.\n");
+
+    sctp_encoder_free(inner);
+    sctp_encoder_free(outer);
+
+    printf("\n[OK] Encoder instance test passed\n");
+}
+
+static void test_encoder_growth()
+{
+    printf("\n--- 5. Testing growable encoder buffers and try_add ---\n");
+
+    // A fixed-capacity encoder reports overflow without writing a partial field.
+    sctp_encoder_t *fixed = sctp_encoder_create(4);
+    assert_true(sctp_encoder_try_add_uint16_to(fixed, 1234) == SCTP_OK, "UINT16 should fit");
+    assert_true(sctp_encoder_try_add_uint32_to(fixed, 1) == SCTP_ERR_NO_SPACE, "UINT32 should not fit");
+    assert_true(sctp_encoder_get_size(fixed) == 3, "Failed add changed the encoder size");
+    assert_true(sctp_encoder_try_add_short_to(fixed, 16) == SCTP_ERR_INVALID_ARG, "SHORT > 15 accepted");
+    assert_true(sctp_encoder_try_add_short_to(fixed, 3) == SCTP_OK, "SHORT should fit");
+    printf("   Fixed encoder rejected overflow atomically.\n");
+    sctp_encoder_free(fixed);
+
+    const sctp_growth_t modes[] = {SCTP_GROWTH_GEOMETRIC, SCTP_GROWTH_CHUNKED};
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+    {
+        sctp_encoder_t *enc = sctp_encoder_create(8);
+        sctp_encoder_set_growth(enc, modes[m], 16);
+
+        for (uint32_t i = 0; i < 100; i++)
+        {
+            sctp_encoder_add_uint32_to(enc, i);
+        }
+        void *vec_ptr;
+        assert_true(sctp_encoder_try_add_vector_to(enc, 300, &vec_ptr) == SCTP_OK, "Vector add failed");
+        memset(vec_ptr, 0xAB, 300);
+        sctp_encoder_add_eof_to(enc);
+
+        sctp_decoder_t *dec = sctp_decoder_from_buffer(sctp_encoder_get_data(enc), sctp_encoder_get_size(enc));
+        for (uint32_t i = 0; i < 100; i++)
+        {
+            sctp_decoder_next(dec);
+            assert_true(dec->last_type == SCTP_TYPE_UINT32, "Type mismatch after growth");
+            assert_true(dec->last_value.as_uint32 == i, "Value mismatch after growth");
+        }
+        sctp_decoder_next(dec);
+        assert_true(dec->last_type == SCTP_TYPE_VECTOR && dec->last_size == 300, "Vector mismatch after growth");
+        assert_true(((const uint8_t *)dec->last_value.as_ptr)[299] == 0xAB, "Vector data mismatch after growth");
+        sctp_decoder_next(dec);
+        assert_true(dec->last_type == SCTP_TYPE_EOF, "Expected EOF after growth");
+        printf("   Growth mode %d encoded %u bytes from an 8 byte start.\n", (int)modes[m],
+               (unsigned int)sctp_encoder_get_size(enc));
+        sctp_encoder_free(enc);
+    }
+
+    printf("\n[OK] Encoder growth test passed\n");
+}
+
+/**
+ * Encodes a fixed message into `enc`. Used by the measuring test so both
+ * passes run exactly the same add calls.
+ */
+static void encode_sized_message(sctp_encoder_t *enc, const uint8_t *blob, size_t blob_size)
+{
+    sctp_encoder_add_uleb128_to(enc, 0);
+    sctp_encoder_add_uleb128_to(enc, UINT64_MAX);
+    sctp_encoder_add_sleb128_to(enc, -64);
+    sctp_encoder_add_sleb128_to(enc, INT64_MIN);
+    sctp_encoder_add_uint64_to(enc, 42);
+    sctp_encoder_add_short_to(enc, 15);
+    void *small = sctp_encoder_add_vector_to(enc, 14);
+    void *large = sctp_encoder_add_vector_to(enc, blob_size);
+    if (small)
+        memcpy(small, blob, 14);
+    if (large)
+        memcpy(large, blob, blob_size);
+    sctp_encoder_add_eof_to(enc);
+}
+
+static void test_size_helpers()
+{
+    printf("\n--- 6. Testing size helpers and the measuring encoder ---\n");
+
+    assert_true(sctp_size_uleb128(0) == 2, "ULEB128 size of 0");
+    assert_true(sctp_size_uleb128(127) == 2, "ULEB128 size of 127");
+    assert_true(sctp_size_uleb128(128) == 3, "ULEB128 size of 128");
+    assert_true(sctp_size_uleb128(UINT64_MAX) == 11, "ULEB128 size of UINT64_MAX");
+    assert_true(sctp_size_sleb128(63) == 2, "SLEB128 size of 63");
+    assert_true(sctp_size_sleb128(64) == 3, "SLEB128 size of 64");
+    assert_true(sctp_size_sleb128(-64) == 2, "SLEB128 size of -64");
+    assert_true(sctp_size_sleb128(-65) == 3, "SLEB128 size of -65");
+    assert_true(sctp_size_sleb128(INT64_MIN) == 11, "SLEB128 size of INT64_MIN");
+    assert_true(sctp_size_vector(14) == 15, "Small vector size");
+    assert_true(sctp_size_vector(15) == 17, "Large vector size");
+    assert_true(sctp_size_vector(128) == 131, "Large vector size with 2-byte length");
+    assert_true(sctp_size_uint32() == 5 && sctp_size_float64() == 9, "Fixed-width sizes");
+
+    uint8_t blob[200];
+    memset(blob, 0x5A, sizeof(blob));
+
+    sctp_encoder_t *measure = sctp_encoder_create_measuring();
+    encode_sized_message(measure, blob, sizeof(blob));
+    const size_t measured = sctp_encoder_get_size(measure);
+    assert_true(sctp_encoder_get_data(measure) == NULL, "Measuring encoder returned a buffer");
+    sctp_encoder_free(measure);
+
+    // The second pass must fit exactly, with growth disabled.
+    sctp_encoder_t *enc = sctp_encoder_create(measured);
+    encode_sized_message(enc, blob, sizeof(blob));
+    assert_true(sctp_encoder_get_size(enc) == measured, "Measured size does not match encoded size");
+    assert_true(sctp_encoder_try_add_eof_to(enc) == SCTP_ERR_NO_SPACE, "Buffer has slack after exact sizing");
+    printf("   Measured and encoded %u bytes with a single allocation.\n", (unsigned int)measured);
+    sctp_encoder_free(enc);
+
+    printf("\n[OK] Size helper test passed\n");
+}
+
+static void test_leb128_kernels()
+{
+    printf("\n--- 7. Testing LEB128 fast paths against the byte loop ---\n");
+
+    // Boundary values around every 7-bit group, positive and negative.
+    uint64_t uvals[3 * 64];
+    int64_t svals[4 * 64];
+    size_t ucount = 0, scount = 0;
+    for (unsigned bit = 0; bit < 64; bit++)
+    {
+        uint64_t p = 1ULL << bit;
+        uvals[ucount++] = p - 1;
+        uvals[ucount++] = p;
+        uvals[ucount++] = p | (p >> 1) | 1;
+        svals[scount++] = (int64_t)(p - 1);
+        svals[scount++] = (int64_t)p;
+        svals[scount++] = (int64_t)(0 - (p - 1));
+        svals[scount++] = (int64_t)(0 - p);
+    }
+
+    // One long stream exercises the word-at-a-time path; the final value of
+    // each single-field stream below exercises the tail loop.
+    sctp_encoder_t *enc = sctp_encoder_create(16);
+    sctp_encoder_set_growth(enc, SCTP_GROWTH_GEOMETRIC, 0);
+    for (size_t i = 0; i < ucount; i++)
+        sctp_encoder_add_uleb128_to(enc, uvals[i]);
+    for (size_t i = 0; i < scount; i++)
+        sctp_encoder_add_sleb128_to(enc, svals[i]);
+    sctp_encoder_add_eof_to(enc);
+
+    sctp_decoder_t *dec = sctp_decoder_from_buffer(sctp_encoder_get_data(enc), sctp_encoder_get_size(enc));
+    for (size_t i = 0; i < ucount; i++)
+    {
+        const size_t start = dec->position;
+        sctp_decoder_next(dec);
+        assert_true(dec->last_type == SCTP_TYPE_ULEB128, "Type mismatch for ULEB128 kernel");
+        assert_true(dec->last_value.as_uleb128 == uvals[i], "Value mismatch for ULEB128 kernel");
+        assert_true(dec->position - start == sctp_size_uleb128(uvals[i]), "Length mismatch for ULEB128 kernel");
+    }
+    for (size_t i = 0; i < scount; i++)
+    {
+        const size_t start = dec->position;
+        sctp_decoder_next(dec);
+        assert_true(dec->last_type == SCTP_TYPE_SLEB128, "Type mismatch for SLEB128 kernel");
+        assert_true(dec->last_value.as_sleb128 == svals[i], "Value mismatch for SLEB128 kernel");
+        assert_true(dec->position - start == sctp_size_sleb128(svals[i]), "Length mismatch for SLEB128 kernel");
+    }
+    sctp_decoder_next(dec);
+    assert_true(dec->last_type == SCTP_TYPE_EOF, "Expected EOF after LEB128 kernels");
+
+    for (size_t i = 0; i < ucount; i++)
+    {
+        sctp_encoder_reset(enc);
+        sctp_encoder_add_uleb128_to(enc, uvals[i]);
+        sctp_decoder_t *tail = sctp_decoder_from_buffer(sctp_encoder_get_data(enc), sctp_encoder_get_size(enc));
+        sctp_decoder_next(tail);
+        assert_true(tail->last_value.as_uleb128 == uvals[i], "Value mismatch for ULEB128 tail");
+    }
+    for (size_t i = 0; i < scount; i++)
+    {
+        sctp_encoder_reset(enc);
+        sctp_encoder_add_sleb128_to(enc, svals[i]);
+        sctp_decoder_t *tail = sctp_decoder_from_buffer(sctp_encoder_get_data(enc), sctp_encoder_get_size(enc));
+        sctp_decoder_next(tail);
+        assert_true(tail->last_value.as_sleb128 == svals[i], "Value mismatch for SLEB128 tail");
+    }
+    printf("   Verified %u ULEB128 and %u SLEB128 boundary values.\n", (unsigned int)ucount, (unsigned int)scount);
+
+    // The byte layout itself must not change.
+    sctp_encoder_reset(enc);
+    sctp_encoder_add_uleb128_to(enc, 624485);
+    sctp_encoder_add_sleb128_to(enc, -123456);
+    const uint8_t expected[] = {0x08, 0xE5, 0x8E, 0x26, 0x09, 0xC0, 0xBB, 0x78};
+    assert_true(sctp_encoder_get_size(enc) == sizeof(expected), "LEB128 encoding size changed");
+    assert_true(memcmp(sctp_encoder_get_data(enc), expected, sizeof(expected)) == 0, "LEB128 encoding bytes changed");
+    sctp_encoder_free(enc);
+
+    printf("\n[OK] LEB128 kernel test passed\n");
+}
+
+static void test_fixed_width_fast_path()
+{
+    printf("\n--- 8. Testing the fixed-width decode fast path ---\n");
+
+    sctp_encoder_t *enc = sctp_encoder_create(64);
+
+    // Neighbouring bytes must not leak into narrow values read via a wide load.
+    sctp_encoder_add_uint8_to(enc, 0x12);
+    sctp_encoder_add_int16_to(enc, -2);
+    sctp_encoder_add_float32_to(enc, 1.5f);
+    sctp_encoder_add_uint64_to(enc, UINT64_MAX);
+    sctp_encoder_add_eof_to(enc);
+    sctp_decoder_t *dec = sctp_decoder_from_buffer(sctp_encoder_get_data(enc), sctp_encoder_get_size(enc));
+    sctp_decoder_next(dec);
+    assert_true(dec->last_value.as_uint64 == 0x12 && dec->last_size == 1, "UINT8 read past its payload");
+    sctp_decoder_next(dec);
+    assert_true(dec->last_value.as_int16 == -2 && dec->last_size == 2, "INT16 value mismatch");
+    assert_true(dec->last_value.as_uint64 == 0xFFFE, "INT16 read past its payload");
+    sctp_decoder_next(dec);
+    assert_true(dec->last_type == SCTP_TYPE_FLOAT32 && dec->last_value.as_float32 == 1.5f, "FLOAT32 value mismatch");
+    sctp_decoder_next(dec);
+    assert_true(dec->last_value.as_uint64 == UINT64_MAX && dec->last_size == 8, "UINT64 value mismatch");
+    sctp_decoder_next(dec);
+    assert_true(dec->last_type == SCTP_TYPE_EOF, "Expected EOF after fixed-width fields");
+
+    // A field that ends exactly at the end of the buffer takes the short path.
+    sctp_encoder_reset(enc);
+    sctp_encoder_add_int8_to(enc, -7);
+    dec = sctp_decoder_from_buffer(sctp_encoder_get_data(enc), sctp_encoder_get_size(enc));
+    sctp_decoder_next(dec);
+    assert_true(dec->last_type == SCTP_TYPE_INT8 && dec->last_value.as_int8 == -7, "INT8 at buffer end");
+    assert_true(sctp_decoder_next(dec) == SCTP_TYPE_EOF, "Expected EOF at buffer end");
+
+    sctp_encoder_reset(enc);
+    sctp_encoder_add_float64_to(enc, -0.25);
+    dec = sctp_decoder_from_buffer(sctp_encoder_get_data(enc), sctp_encoder_get_size(enc));
+    sctp_decoder_next(dec);
+    assert_true(dec->last_type == SCTP_TYPE_FLOAT64 && dec->last_value.as_float64 == -0.25, "FLOAT64 at buffer end");
+
+    sctp_encoder_free(enc);
+    printf("\n[OK] Fixed-width fast path test passed\n");
+}
+
+static void test_batch_decode()
+{
+    printf("\n--- 9. Testing batch decoding into a field array ---\n");
+
+    sctp_encoder_t *enc = sctp_encoder_create(64);
+    sctp_encoder_set_growth(enc, SCTP_GROWTH_GEOMETRIC, 0);
+    for (uint32_t i = 0; i < 200; i++)
+    {
+        if (i % 2)
+            sctp_encoder_add_uleb128_to(enc, i * 1000);
+        else
+            sctp_encoder_add_uint32_to(enc, i);
+    }
+    sctp_encoder_add_eof_to(enc);
+
+    sctp_decoder_t *dec = sctp_decoder_from_buffer(sctp_encoder_get_data(enc), sctp_encoder_get_size(enc));
+    sctp_field_t fields[64];
+    size_t total = 0;
+    size_t calls = 0;
+    size_t count;
+    do
+    {
+        count = sctp_decoder_next_batch(dec, fields, 64);
+        calls++;
+        for (size_t i = 0; i < count; i++, total++)
+        {
+            if (fields[i].type == SCTP_TYPE_EOF)
+            {
+                assert_true(total == 200, "EOF reported at the wrong position");
+                break;
+            }
+            if (total % 2)
+                assert_true(fields[i].type == SCTP_TYPE_ULEB128 && fields[i].value.as_uleb128 == total * 1000,
+                            "ULEB128 mismatch in batch");
+            else
+                assert_true(fields[i].type == SCTP_TYPE_UINT32 && fields[i].value.as_uint32 == total &&
+                                fields[i].size == 4,
+                            "UINT32 mismatch in batch");
+        }
+    } while (count == 64 && fields[63].type != SCTP_TYPE_EOF);
+    assert_true(calls == 4, "Unexpected number of batch calls");
+    assert_true(dec->last_type == SCTP_TYPE_EOF, "Decoder state not updated by batch");
+    printf("   Decoded 201 fields in %u batch calls.\n", (unsigned int)calls);
+
+    sctp_encoder_free(enc);
+    printf("\n[OK] Batch decode test passed\n");
+}
+
+#ifdef SCTP_CALLBACK_BATCH
+static void test_run_batch()
+{
+    printf("\n--- 10. Testing batched callback delivery ---\n");
+
+    sctp_encoder_t *enc = sctp_encoder_create(1024);
+    for (uint16_t i = 0; i < 150; i++)
+        sctp_encoder_add_uint16_to(enc, i);
+    sctp_encoder_add_eof_to(enc);
+
+    sctp_decoder_t *dec = sctp_decoder_from_buffer(sctp_encoder_get_data(enc), sctp_encoder_get_size(enc));
+    assert_true(sctp_decoder_run_batch(dec) == 0, "sctp_decoder_run_batch failed");
+    assert_true(g_batch_saw_eof, "Batched run did not deliver EOF");
+    assert_true(g_batch_fields == 150, "Batched run lost fields");
+    assert_true(g_batch_calls == (151 + SCTP_CALLBACK_BATCH_SIZE - 1) / SCTP_CALLBACK_BATCH_SIZE,
+                "Unexpected number of batch callbacks");
+    printf("   Delivered 151 fields in %u callbacks.\n", (unsigned int)g_batch_calls);
+
+    sctp_encoder_free(enc);
+    printf("\n[OK] Batched callback test passed\n");
+}
+#endif
+
+static void test_array_encoders()
+{
+    printf("\n--- 11. Testing bulk array encoders ---\n");
+
+    uint64_t balances[1000];
+    int32_t deltas[1000];
+    int64_t signed_values[1000];
+    for (size_t i = 0; i < 1000; i++)
+    {
+        balances[i] = (uint64_t)i * 0x9E3779B97F4A7C15ULL;
+        deltas[i] = (int32_t)(i * 7919) - 4000000;
+        signed_values[i] = (int64_t)(balances[i] >> (i % 64)) * ((i % 2) ? -1 : 1);
+    }
+
+    // The bulk encoders must produce exactly the same bytes as scalar adds.
+    sctp_encoder_t *bulk = sctp_encoder_create(64);
+    sctp_encoder_t *scalar = sctp_encoder_create(64);
+    sctp_encoder_set_growth(bulk, SCTP_GROWTH_GEOMETRIC, 0);
+    sctp_encoder_set_growth(scalar, SCTP_GROWTH_GEOMETRIC, 0);
+
+    sctp_encoder_add_uint64_array_to(bulk, balances, 1000);
+    sctp_encoder_add_int32_array_to(bulk, deltas, 1000);
+    sctp_encoder_add_uleb128_array_to(bulk, balances, 1000);
+    sctp_encoder_add_sleb128_array_to(bulk, signed_values, 1000);
+    sctp_encoder_add_uint8_array_to(bulk, NULL, 0);
+    for (size_t i = 0; i < 1000; i++)
+        sctp_encoder_add_uint64_to(scalar, balances[i]);
+    for (size_t i = 0; i < 1000; i++)
+        sctp_encoder_add_int32_to(scalar, deltas[i]);
+    for (size_t i = 0; i < 1000; i++)
+        sctp_encoder_add_uleb128_to(scalar, balances[i]);
+    for (size_t i = 0; i < 1000; i++)
+        sctp_encoder_add_sleb128_to(scalar, signed_values[i]);
+
+    assert_true(sctp_encoder_get_size(bulk) == sctp_encoder_get_size(scalar), "Bulk encoding size mismatch");
+    assert_true(memcmp(sctp_encoder_get_data(bulk), sctp_encoder_get_data(scalar), sctp_encoder_get_size(bulk)) == 0,
+                "Bulk encoding bytes mismatch");
+    printf("   Bulk encoders matched %u bytes of scalar output.\n", (unsigned int)sctp_encoder_get_size(bulk));
+
+    // A failed bulk add writes nothing.
+    sctp_encoder_t *fixed = sctp_encoder_create(50);
+    assert_true(sctp_encoder_try_add_uint32_array_to(fixed, (const uint32_t *)deltas, 11) == SCTP_ERR_NO_SPACE,
+                "Oversized bulk add succeeded");
+    assert_true(sctp_encoder_get_size(fixed) == 0, "Failed bulk add wrote data");
+    assert_true(sctp_encoder_try_add_uint32_array_to(fixed, (const uint32_t *)deltas, 10) == SCTP_OK,
+                "Exact-fit bulk add failed");
+
+    sctp_encoder_free(fixed);
+    sctp_encoder_free(scalar);
+    sctp_encoder_free(bulk);
+    printf("\n[OK] Array encoder test passed\n");
+}
+
+static void test_packed_arrays()
+{
+    printf("\n--- 12. Testing packed homogeneous arrays ---\n");
+
+    uint32_t values[100];
+    double prices[3] = {1.5, -2.25, 1e300};
+    for (uint32_t i = 0; i < 100; i++)
+        values[i] = i * 0x01010101u;
+
+    sctp_encoder_t *enc = sctp_encoder_create(1024);
+    sctp_encoder_add_packed_uint32_to(enc, values, 100);
+    sctp_encoder_add_packed_float64_to(enc, prices, 3);
+    sctp_encoder_add_packed_int8_to(enc, NULL, 0);
+    int16_t *manual = sctp_encoder_add_packed_to(enc, SCTP_TYPE_INT16, 2);
+    const int16_t manual_values[2] = {-1, 300};
+    memcpy(manual, manual_values, sizeof(manual_values));
+    sctp_encoder_add_eof_to(enc);
+
+    // One header and a 1-byte count instead of 100 headers.
+    const size_t expected_size = sctp_size_packed(SCTP_TYPE_UINT32, 100) + sctp_size_packed(SCTP_TYPE_FLOAT64, 3) +
+                                 sctp_size_packed(SCTP_TYPE_INT8, 0) + sctp_size_packed(SCTP_TYPE_INT16, 2) + 1;
+    assert_true(sctp_size_packed(SCTP_TYPE_UINT32, 100) == 402, "Packed size mismatch");
+    assert_true(sctp_size_packed(SCTP_TYPE_ULEB128, 1) == 0, "LEB128 accepted as packed element type");
+    assert_true(sctp_encoder_get_size(enc) == expected_size, "Packed stream size mismatch");
+    void *unused;
+    assert_true(sctp_encoder_try_add_packed_to(enc, SCTP_TYPE_VECTOR, 1, &unused) == SCTP_ERR_INVALID_ARG,
+                "VECTOR accepted as packed element type");
+
+    sctp_decoder_t *dec = sctp_decoder_from_buffer(sctp_encoder_get_data(enc), sctp_encoder_get_size(enc));
+    sctp_decoder_next(dec);
+    assert_true(dec->last_type == SCTP_TYPE_PACKED, "Type mismatch for packed UINT32");
+    assert_true(dec->last_elem_type == SCTP_TYPE_UINT32, "Element type mismatch for packed UINT32");
+    assert_true(dec->last_size / sctp_type_width(dec->last_elem_type) == 100, "Count mismatch for packed UINT32");
+    assert_true(memcmp(dec->last_value.as_ptr, values, sizeof(values)) == 0, "Data mismatch for packed UINT32");
+    assert_true((const uint8_t *)dec->last_value.as_ptr > sctp_encoder_get_data(enc) &&
+                    (const uint8_t *)dec->last_value.as_ptr < sctp_encoder_get_data(enc) + sctp_encoder_get_size(enc),
+                "Packed data is not zero-copy");
+
+    sctp_field_t fields[4];
+    assert_true(sctp_decoder_next_batch(dec, fields, 4) == 4, "Batch count mismatch for packed fields");
+    assert_true(fields[0].type == SCTP_TYPE_PACKED && fields[0].elem_type == SCTP_TYPE_FLOAT64 &&
+                    fields[0].size == sizeof(prices),
+                "Batch mismatch for packed FLOAT64");
+    double decoded_price;
+    memcpy(&decoded_price, (const uint8_t *)fields[0].value.as_ptr + 16, sizeof(decoded_price));
+    assert_true(decoded_price == 1e300, "Data mismatch for packed FLOAT64");
+    assert_true(fields[1].elem_type == SCTP_TYPE_INT8 && fields[1].size == 0, "Mismatch for empty packed array");
+    assert_true(fields[2].elem_type == SCTP_TYPE_INT16 && memcmp(fields[2].value.as_ptr, manual_values, 4) == 0,
+                "Mismatch for manually filled packed array");
+    assert_true(fields[3].type == SCTP_TYPE_EOF, "Expected EOF after packed arrays");
+    printf("   Packed 100 UINT32 values into %u bytes.\n", (unsigned int)sctp_size_packed(SCTP_TYPE_UINT32, 100));
+
+    sctp_encoder_free(enc);
+    printf("\n[OK] Packed array test passed\n");
+}
+
+// A large vector whose ULEB128 length, 2^64 - 11, wraps `position + length`.
+static const uint8_t g_wrapping_vector[] = {0xFD, 0xF5, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0x0F};
+
+#ifndef __wasm__
+static void skip_wrapping_vector(const void *arg)
+{
+    (void)arg;
+    sctp_decoder_t *dec = sctp_decoder_from_buffer(g_wrapping_vector, sizeof(g_wrapping_vector));
+    sctp_decoder_skip(dec, 5);
+}
+
+static void next_wrapping_vector(const void *arg)
+{
+    (void)arg;
+    sctp_decoder_t *dec = sctp_decoder_from_buffer(g_wrapping_vector, sizeof(g_wrapping_vector));
+    sctp_decoder_next(dec);
+}
+
+static void index_wrapping_vector(const void *arg)
+{
+    (void)arg;
+    sctp_index_build(g_wrapping_vector, sizeof(g_wrapping_vector), 1);
+}
+#endif
+
+static void test_skip_seek()
+{
+    printf("\n--- 13. Testing skip, seek and save/restore ---\n");
+
+    uint8_t blob[40];
+    const uint16_t packed[3] = {1, 2, 3};
+    memset(blob, 0xAB, sizeof(blob));
+
+    sctp_encoder_t *enc = sctp_encoder_create(256);
+    sctp_encoder_add_uint32_to(enc, 7);
+    sctp_encoder_add_uleb128_to(enc, UINT64_MAX); // 10 bytes, past the word scan
+    sctp_encoder_add_vector_to(enc, 3);
+    memcpy(sctp_encoder_add_vector_to(enc, sizeof(blob)), blob, sizeof(blob));
+    sctp_encoder_add_packed_uint16_to(enc, packed, 3);
+    sctp_encoder_add_short_to(enc, 9);
+    sctp_encoder_add_float64_to(enc, 2.5);
+    sctp_encoder_add_uint64_to(enc, 123456789); // field 7, the one we want
+    sctp_encoder_add_sleb128_to(enc, -300);     // near the end, takes the byte loop
+    sctp_encoder_add_eof_to(enc);
+
+    // Record where each field starts with a full decode.
+    sctp_decoder_t *dec = sctp_decoder_from_buffer(sctp_encoder_get_data(enc), sctp_encoder_get_size(enc));
+    size_t starts[10];
+    size_t fields = 0;
+    do
+        starts[fields++] = dec->position;
+    while (sctp_decoder_next(dec) != SCTP_TYPE_EOF);
+    assert_true(fields == 10, "Field count mismatch");
+
+    for (size_t k = 0; k < fields; k++)
+    {
+        assert_true(sctp_decoder_seek(dec, 0) == SCTP_OK, "Seek to start failed");
+        assert_true(sctp_decoder_skip(dec, k) == k, "Skip count mismatch");
+        assert_true(dec->position == starts[k], "Skip position mismatch");
+    }
+
+    // Skipping stops in front of the EOF field.
+    sctp_decoder_seek(dec, 0);
+    assert_true(sctp_decoder_skip(dec, 100) == 9, "Skip did not stop at EOF");
+    assert_true(sctp_decoder_next(dec) == SCTP_TYPE_EOF, "Expected EOF after skip");
+    assert_true(sctp_decoder_skip(dec, 1) == 0, "Skip past end of buffer");
+
+    // Read field 7 directly, then look ahead and come back.
+    sctp_decoder_seek(dec, 0);
+    sctp_decoder_skip(dec, 7);
+    sctp_decoder_next(dec);
+    assert_true(dec->last_type == SCTP_TYPE_UINT64 && dec->last_value.as_uint64 == 123456789,
+                "Value mismatch after skip");
+
+    sctp_decoder_state_t state;
+    sctp_decoder_save(dec, &state);
+    sctp_decoder_next(dec);
+    assert_true(dec->last_value.as_sleb128 == -300, "Value mismatch for look-ahead");
+    sctp_decoder_restore(dec, &state);
+    assert_true(dec->position == starts[8] && dec->last_value.as_uint64 == 123456789, "Restore mismatch");
+    assert_true(sctp_decoder_next(dec) == SCTP_TYPE_SLEB128, "Type mismatch after restore");
+
+    assert_true(sctp_decoder_seek(dec, sctp_encoder_get_size(enc)) == SCTP_OK, "Seek to end failed");
+    assert_true(sctp_decoder_seek(dec, sctp_encoder_get_size(enc) + 1) == SCTP_ERR_INVALID_ARG,
+                "Seek past end accepted");
+    assert_true(sctp_decoder_next(dec) == SCTP_TYPE_EOF, "Expected EOF at end of buffer");
+
+    // A vector length near 2^64 must not wrap the position back into the buffer.
+    size_t error_position = 1;
+    assert_true(sctp_validate(g_wrapping_vector, sizeof(g_wrapping_vector), &error_position) != SCTP_OK &&
+                    error_position == 0,
+                "Wrapping vector length accepted");
+    dec = sctp_decoder_from_buffer(g_wrapping_vector, sizeof(g_wrapping_vector));
+    assert_true(sctp_decoder_try_next(dec) != SCTP_OK && dec->position == 0, "Wrapping vector decoded by try_next");
+    sctp_decoder_free(dec);
+#ifndef __wasm__
+    assert_aborts(skip_wrapping_vector, NULL, "Wrapping vector skipped");
+    assert_aborts(next_wrapping_vector, NULL, "Wrapping vector decoded");
+#endif
+
+    sctp_encoder_free(enc);
+    printf("\n[OK] Skip/seek test passed\n");
+}
+
+static void test_field_index()
+{
+    printf("\n--- 14. Testing field offset index ---\n");
+
+    // A "block" of 300 transactions of varying length, ended by EOF.
+    sctp_encoder_t *enc = sctp_encoder_create(64);
+    sctp_encoder_set_growth(enc, SCTP_GROWTH_GEOMETRIC, 0);
+    for (uint32_t i = 0; i < 300; i++)
+    {
+        memset(sctp_encoder_add_vector_to(enc, i % 40), (int)i, i % 40);
+        sctp_encoder_add_uleb128_to(enc, (uint64_t)i << (i % 57));
+    }
+    sctp_encoder_add_eof_to(enc);
+    const uint8_t *data = sctp_encoder_get_data(enc);
+    const size_t size = sctp_encoder_get_size(enc);
+
+    sctp_index_t *every = sctp_index_build(data, size, 1);
+    sctp_index_t *sparse = sctp_index_build(data, size, 16);
+    assert_true(every->fields == 600 && sparse->fields == 600, "Indexed field count mismatch");
+    assert_true(every->count == 601 && sparse->count == 38, "Index entry count mismatch");
+    assert_true(sctp_index_size(sparse) == sizeof(sctp_index_t) + 38 * sizeof(uint32_t), "Index size mismatch");
+
+    sctp_decoder_t *dec = sctp_decoder_from_buffer(data, size);
+    for (uint32_t k = 0; k < 600; k++)
+    {
+        assert_true(every->offsets[k] == dec->position, "Index offset mismatch");
+        sctp_decoder_next(dec);
+    }
+
+    // Transaction k is field 2k; check both indexes land on the same value.
+    for (uint32_t k = 0; k < 300; k += 7)
+    {
+        sctp_decoder_t *a = sctp_decoder_from_index(data, size, every, 2 * k + 1);
+        sctp_decoder_t *b = sctp_decoder_from_index(data, size, sparse, 2 * k + 1);
+        assert_true(a->position == b->position, "Sparse index position mismatch");
+        assert_true(sctp_decoder_next(b) == SCTP_TYPE_ULEB128 && b->last_value.as_uleb128 == (uint64_t)k << (k % 57),
+                    "Value mismatch through index");
+    }
+
+    // A persisted copy of the index works the same.
+    sctp_index_t *loaded = malloc(sctp_index_size(sparse));
+    memcpy(loaded, sparse, sctp_index_size(sparse));
+    sctp_decoder_t *end = sctp_decoder_from_index(data, size, loaded, 600);
+    assert_true(sctp_decoder_next(end) == SCTP_TYPE_EOF, "Expected EOF at last indexed field");
+    printf("   Indexed 600 fields in %u bytes (stride 16).\n", (unsigned int)sctp_index_size(sparse));
+
+#ifndef __wasm__
+    // A wrapping vector length must not stall the walk and grow the index without bound.
+    assert_aborts(index_wrapping_vector, NULL, "Index built over a wrapping vector");
+#endif
+
+    sctp_encoder_free(enc);
+    printf("\n[OK] Field index test passed\n");
+}
+
+static void test_stream_decoder()
+{
+    printf("\n--- 15. Testing streaming decoder ---\n");
+
+    uint8_t blob[100];
+    const int64_t packed[2] = {-5, INT64_MAX};
+    for (size_t i = 0; i < sizeof(blob); i++)
+        blob[i] = (uint8_t)(i * 7);
+
+    sctp_encoder_t *enc = sctp_encoder_create(512);
+    sctp_encoder_add_uint16_to(enc, 4242);
+    sctp_encoder_add_uleb128_to(enc, UINT64_MAX);
+    memcpy(sctp_encoder_add_vector_to(enc, sizeof(blob)), blob, sizeof(blob));
+    sctp_encoder_add_sleb128_to(enc, -1234567);
+    sctp_encoder_add_packed_int64_to(enc, packed, 2);
+    sctp_encoder_add_short_to(enc, 3);
+    memcpy(sctp_encoder_add_vector_to(enc, 5), "chunk", 5);
+    sctp_encoder_add_float64_to(enc, -0.5);
+    sctp_encoder_add_eof_to(enc);
+    const uint8_t *data = sctp_encoder_get_data(enc);
+    const size_t size = sctp_encoder_get_size(enc);
+
+    sctp_field_t expected[16];
+    sctp_decoder_t *dec = sctp_decoder_from_buffer(data, size);
+    const size_t fields = sctp_decoder_next_batch(dec, expected, 16);
+    assert_true(fields == 9, "Reference field count mismatch");
+
+    // Every chunk size from 1 byte up to the whole message.
+    for (size_t chunk = 1; chunk <= size; chunk++)
+    {
+        sctp_stream_decoder_t *sdec = sctp_stream_decoder_create();
+        size_t offset = 0;
+        size_t decoded = 0;
+        sctp_field_t field;
+        while (decoded < fields)
+        {
+            int status = sctp_stream_decoder_next(sdec, &field);
+            if (status == SCTP_NEED_MORE)
+            {
+                assert_true(offset < size, "Decoder asked for more past the end");
+                size_t n = size - offset < chunk ? size - offset : chunk;
+                assert_true(sctp_stream_decoder_feed(sdec, data + offset, n) == SCTP_OK, "Feed failed");
+                offset += n;
+                continue;
+            }
+            assert_true(status == SCTP_OK, "Streaming decode failed");
+            const sctp_field_t *want = &expected[decoded++];
+            assert_true(field.type == want->type && field.size == want->size, "Streamed field mismatch");
+            if (field.type == SCTP_TYPE_PACKED)
+                assert_true(field.elem_type == want->elem_type, "Streamed element type mismatch");
+            if (field.type == SCTP_TYPE_VECTOR || field.type == SCTP_TYPE_PACKED)
+                assert_true(memcmp(field.value.as_ptr, want->value.as_ptr, field.size) == 0, "Streamed data mismatch");
+            else if (field.type == SCTP_TYPE_SHORT)
+                assert_true(field.value.as_short == want->value.as_short, "Streamed value mismatch");
+            else if (field.type != SCTP_TYPE_EOF)
+                assert_true(field.value.as_uint64 == want->value.as_uint64, "Streamed value mismatch");
+        }
+        assert_true(sctp_stream_decoder_buffered(sdec) == 0, "Bytes left in carry buffer");
+        assert_true(sctp_stream_decoder_next(sdec, &field) == SCTP_OK && field.type == SCTP_TYPE_EOF,
+                    "Expected EOF after stream end");
+        sctp_stream_decoder_free(sdec);
+    }
+
+    // Truncated and malformed input.
+    sctp_field_t field;
+    sctp_stream_decoder_t *sdec = sctp_stream_decoder_create();
+    sctp_stream_decoder_feed(sdec, data, 10);
+    assert_true(sctp_stream_decoder_next(sdec, &field) == SCTP_OK, "Expected first field");
+    assert_true(sctp_stream_decoder_feed(sdec, data + 10, 1) == SCTP_ERR_INVALID_ARG, "Fed over unread input");
+    assert_true(sctp_stream_decoder_next(sdec, &field) == SCTP_NEED_MORE, "Expected NEED_MORE");
+    assert_true(sctp_stream_decoder_buffered(sdec) == 7, "Partial field size mismatch");
+
+    sctp_stream_decoder_free(sdec);
+
+    const uint8_t bad[] = {0xFE, 0x01, 0x00}; // packed array of ULEB128 elements
+    sdec = sctp_stream_decoder_create();
+    sctp_stream_decoder_feed(sdec, bad, sizeof(bad));
+    assert_true(sctp_stream_decoder_next(sdec, &field) == SCTP_ERR_RESERVED_TYPE, "Malformed field accepted");
+    sctp_stream_decoder_free(sdec);
+
+    sctp_encoder_free(enc);
+    printf("\n[OK] Streaming decoder test passed\n");
+}
+
+#ifdef SCTP_FLUSH_ENABLE
+static void encode_streaming_message(sctp_encoder_t *enc, const uint8_t *blob, size_t blob_size,
+                                     const uint32_t *packed, size_t packed_count)
+{
+    for (uint64_t i = 0; i < 40; i++)
+    {
+        sctp_encoder_add_uint64_to(enc, i * 0x0102030405060708ULL);
+        sctp_encoder_add_uleb128_to(enc, i << 50);
+    }
+    sctp_encoder_add_vector_data_to(enc, blob, blob_size);
+    sctp_encoder_add_vector_data_to(enc, "small", 5);
+    sctp_encoder_add_packed_uint32_to(enc, packed, packed_count);
+    memcpy(sctp_encoder_add_vector_to(enc, 20), blob, 20);
+
+    // Arrays of fields larger than the window.
+    uint64_t ulebs[16];
+    int64_t slebs[16];
+    for (int i = 0; i < 16; i++)
+    {
+        ulebs[i] = UINT64_MAX >> (i * 4);
+        slebs[i] = -(INT64_MAX >> (i * 4));
+    }
+    sctp_encoder_add_uint32_array_to(enc, packed, 20);
+    sctp_encoder_add_uleb128_array_to(enc, ulebs, 16);
+    sctp_encoder_add_sleb128_array_to(enc, slebs, 16);
+    sctp_encoder_add_eof_to(enc);
+}
+
+static void test_streaming_encoder()
+{
+    printf("\n--- 16. Testing streaming encoder ---\n");
+
+    uint8_t blob[1000];
+    uint32_t packed[300];
+    for (size_t i = 0; i < sizeof(blob); i++)
+        blob[i] = (uint8_t)(i ^ (i >> 3));
+    for (uint32_t i = 0; i < 300; i++)
+        packed[i] = i * 2654435761u;
+
+    sctp_encoder_t *reference = sctp_encoder_create(4096);
+    encode_streaming_message(reference, blob, sizeof(blob), packed, 300);
+
+    sctp_encoder_t *enc = sctp_encoder_create_streaming(64);
+    encode_streaming_message(enc, blob, sizeof(blob), packed, 300);
+    sctp_encoder_flush_to(enc);
+    assert_true(sctp_encoder_get_size(enc) == 0, "Window not empty after flush");
+    assert_true(g_flush_size == sctp_encoder_get_size(reference), "Streamed size mismatch");
+    assert_true(memcmp(g_flush_output, sctp_encoder_get_data(reference), g_flush_size) == 0,
+                "Streamed output mismatch");
+    assert_true(g_flush_max <= 64, "Flushed chunk larger than the window");
+
+    // Zero-copy fields that do not fit in the window are rejected cleanly.
+    void *ptr;
+    assert_true(sctp_encoder_try_add_vector_to(enc, 100, &ptr) == SCTP_ERR_NO_SPACE,
+                "Oversized zero-copy vector accepted");
+    assert_true(sctp_encoder_get_size(enc) == 0, "Failed add left bytes in the window");
+    printf("   Streamed %u bytes through a 64-byte window in %u flushes.\n", (unsigned int)g_flush_size,
+           (unsigned int)g_flush_calls);
+
+    sctp_encoder_free(reference);
+    sctp_encoder_free(enc);
+    printf("\n[OK] Streaming encoder test passed\n");
+}
+#endif
+
+static void test_validation()
+{
+    printf("\n--- 17. Testing validation and error codes ---\n");
+
+    sctp_encoder_t *enc = sctp_encoder_create(256);
+    sctp_encoder_add_uint32_to(enc, 1);
+    sctp_encoder_add_uleb128_to(enc, UINT64_MAX);
+    memcpy(sctp_encoder_add_vector_to(enc, 20), "01234567890123456789", 20);
+    const uint16_t packed[2] = {1, 2};
+    sctp_encoder_add_packed_uint16_to(enc, packed, 2);
+    sctp_encoder_add_eof_to(enc);
+    const uint8_t *data = sctp_encoder_get_data(enc);
+    const size_t size = sctp_encoder_get_size(enc);
+    const size_t starts[] = {0, 5, 16, 38, 44};
+
+    size_t error_position = 0;
+    assert_true(sctp_validate(data, size, &error_position) == SCTP_OK, "Valid buffer rejected");
+    assert_true(sctp_validate(data, size - 1, NULL) == SCTP_OK, "Buffer without EOF rejected");
+    assert_true(sctp_validate(NULL, 0, NULL) == SCTP_OK, "Empty buffer rejected");
+
+    // Every cut inside a field is reported as truncated at that field.
+    size_t field = 0;
+    for (size_t cut = 1; cut < size; cut++)
+    {
+        while (field + 1 < sizeof(starts) / sizeof(starts[0]) && starts[field + 1] <= cut)
+            field++;
+        int status = sctp_validate(data, cut, &error_position);
+        if (cut == starts[field])
+            assert_true(status == SCTP_OK, "Cut at field boundary rejected");
+        else
+            assert_true(status == SCTP_ERR_TRUNCATED && error_position == starts[field], "Truncation not reported");
+    }
+
+    const uint8_t overlong[] = {0x01, 0x00, 0x08, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01};
+    assert_true(sctp_validate(overlong, sizeof(overlong), &error_position) == SCTP_ERR_OVERFLOW && error_position == 2,
+                "Overlong LEB128 not reported");
+    const uint8_t reserved[] = {0x0C, 0x8E, 0x01, 0x00}; // packed array of ULEB128 elements
+    assert_true(sctp_validate(reserved, sizeof(reserved), &error_position) == SCTP_ERR_RESERVED_TYPE &&
+                    error_position == 1,
+                "Reserved element type not reported");
+    const uint8_t trailing[] = {0x1C, 0x0F, 0x2C};
+    assert_true(sctp_validate(trailing, sizeof(trailing), &error_position) == SCTP_ERR_TRAILING_DATA &&
+                    error_position == 2,
+                "Trailing data not reported");
+
+    // The decoder reports errors in place and stays usable.
+    sctp_decoder_t *dec = sctp_decoder_from_buffer(data, 30);
+    assert_true(sctp_decoder_try_next(dec) == SCTP_OK && dec->last_value.as_uint32 == 1, "try_next failed");
+    assert_true(sctp_decoder_try_next(dec) == SCTP_OK && dec->last_value.as_uleb128 == UINT64_MAX,
+                "try_next failed on ULEB128");
+    assert_true(sctp_decoder_try_next(dec) == SCTP_ERR_TRUNCATED && dec->position == 16,
+                "Truncated vector not reported");
+    assert_true(sctp_decoder_try_next(dec) == SCTP_ERR_TRUNCATED, "Error not repeatable");
+
+    dec = sctp_decoder_from_buffer(trailing, sizeof(trailing));
+    assert_true(sctp_decoder_try_next(dec) == SCTP_OK && dec->last_type == SCTP_TYPE_SHORT, "try_next failed on SHORT");
+    assert_true(sctp_decoder_try_next(dec) == SCTP_ERR_TRAILING_DATA && dec->position == 2,
+                "Trailing data not reported by try_next");
+
+    // The tenth byte of a LEB128 value only holds bit 63: 0 or 1 for ULEB128,
+    // the sign extension of bit 63 for SLEB128.
+    const uint8_t wide_uleb[] = {0x08, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F};
+    const uint8_t wide_sleb[] = {0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01};
+    const uint8_t *const wide[] = {wide_uleb, wide_sleb};
+    for (int i = 0; i < 2; i++)
+    {
+        assert_true(sctp_validate(wide[i], sizeof(wide_uleb), &error_position) == SCTP_ERR_OVERFLOW &&
+                        error_position == 0,
+                    "Overflowing tenth LEB128 byte not reported");
+        dec = sctp_decoder_from_buffer(wide[i], sizeof(wide_uleb));
+        assert_true(sctp_decoder_try_next(dec) == SCTP_ERR_OVERFLOW && dec->position == 0,
+                    "Overflowing tenth LEB128 byte not reported by try_next");
+    }
+    const uint8_t widest[] = {0x08, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01,
+                              0x09, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x7F};
+    assert_true(sctp_validate(widest, sizeof(widest), NULL) == SCTP_OK, "Ten-byte LEB128 limits rejected");
+    dec = sctp_decoder_from_buffer(widest, sizeof(widest));
+    assert_true(sctp_decoder_try_next(dec) == SCTP_OK && dec->last_value.as_uleb128 == UINT64_MAX,
+                "Ten-byte ULEB128 limit misread");
+    assert_true(sctp_decoder_try_next(dec) == SCTP_OK && dec->last_value.as_sleb128 == INT64_MIN,
+                "Ten-byte SLEB128 limit misread");
+
+    dec = sctp_decoder_from_buffer(data, size);
+    while (sctp_decoder_try_next(dec) == SCTP_OK && dec->last_type != SCTP_TYPE_EOF)
+        ;
+    assert_true(dec->position == size, "try_next did not reach the end");
+    assert_true(sctp_decoder_try_next(dec) == SCTP_OK && dec->last_type == SCTP_TYPE_EOF, "Expected EOF");
+
+    sctp_encoder_free(enc);
+    printf("\n[OK] Validation test passed\n");
+}
+
+static void test_schema_codec()
+{
+    printf("\n--- 18. Testing schema-generated codecs ---\n");
+
+    const char recipient[] = "lea1qxyzrecipientaddress";
+    test_tx_t tx = {
+        .nonce = 77,
+        .fee = 300000,
+        .delta = -42,
+        .kind = 5,
+        .to = {(const uint8_t *)recipient, sizeof(recipient) - 1},
+        .rate = 0.125,
+        .flags = 0x81,
+    };
+
+    sctp_encoder_t *enc = sctp_encoder_create(256);
+    test_tx_encode_to(enc, &tx);
+    assert_true(sctp_encoder_get_size(enc) == test_tx_size(&tx), "Schema size mismatch");
+    test_tx_encode_to(enc, &tx);
+    const uint8_t *data = sctp_encoder_get_data(enc);
+    const size_t size = sctp_encoder_get_size(enc);
+
+    // The generated encoder writes the same bytes as the generic API.
+    sctp_encoder_t *manual = sctp_encoder_create(256);
+    sctp_encoder_add_uint64_to(manual, 77);
+    sctp_encoder_add_uleb128_to(manual, 300000);
+    sctp_encoder_add_sleb128_to(manual, -42);
+    sctp_encoder_add_short_to(manual, 5);
+    sctp_encoder_add_vector_data_to(manual, recipient, sizeof(recipient) - 1);
+    sctp_encoder_add_float64_to(manual, 0.125);
+    sctp_encoder_add_uint8_to(manual, 0x81);
+    assert_true(memcmp(sctp_encoder_get_data(manual), data, sctp_encoder_get_size(manual)) == 0,
+                "Schema encoding differs from generic encoding");
+
+    // Two messages back to back.
+    sctp_decoder_t *dec = sctp_decoder_from_buffer(data, size);
+    for (int i = 0; i < 2; i++)
+    {
+        test_tx_t out;
+        memset(&out, 0, sizeof(out));
+        assert_true(test_tx_decode(dec, &out) == SCTP_OK, "Schema decode failed");
+        assert_true(out.nonce == 77 && out.fee == 300000 && out.delta == -42 && out.kind == 5 && out.rate == 0.125 &&
+                        out.flags == 0x81,
+                    "Schema value mismatch");
+        assert_true(out.to.size == tx.to.size && memcmp(out.to.data, recipient, out.to.size) == 0,
+                    "Schema vector mismatch");
+    }
+    assert_true(dec->position == size, "Schema decode did not consume both messages");
+
+    // A field of the wrong type fails fast at that field.
+    test_tx_t out;
+    sctp_encoder_t *wrong = sctp_encoder_create(64);
+    sctp_encoder_add_uint64_to(wrong, 1);
+    sctp_encoder_add_uint64_to(wrong, 2);
+    dec = sctp_decoder_from_buffer(sctp_encoder_get_data(wrong), sctp_encoder_get_size(wrong));
+    assert_true(test_tx_decode(dec, &out) == SCTP_ERR_TYPE_MISMATCH && dec->position == 9, "Type mismatch not reported");
+
+    // Truncated input is reported, never aborts.
+    for (size_t cut = 0; cut < test_tx_size(&tx); cut++)
+    {
+        dec = sctp_decoder_from_buffer(data, cut);
+        assert_true(test_tx_decode(dec, &out) == SCTP_ERR_TRUNCATED, "Truncation not reported by schema decode");
+    }
+
+    // The schema readers reject a tenth LEB128 byte that overflows, like sctp_validate.
+    const uint8_t wide_uleb[] = {0x08, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F};
+    const uint8_t wide_sleb[] = {0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01};
+    size_t position = 0;
+    uint64_t uleb = 0;
+    int64_t sleb = 0;
+    assert_true(sctp_schema_read_uleb128(wide_uleb, sizeof(wide_uleb), &position, &uleb) == SCTP_ERR_OVERFLOW &&
+                    position == 0,
+                "Overflowing ULEB128 accepted by schema reader");
+    assert_true(sctp_schema_read_sleb128(wide_sleb, sizeof(wide_sleb), &position, &sleb) == SCTP_ERR_OVERFLOW &&
+                    position == 0,
+                "Overflowing SLEB128 accepted by schema reader");
+    const uint8_t widest_uleb[] = {0x08, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01};
+    const uint8_t widest_sleb[] = {0x09, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x7F};
+    assert_true(sctp_schema_read_uleb128(widest_uleb, sizeof(widest_uleb), &position, &uleb) == SCTP_OK &&
+                    uleb == UINT64_MAX && position == sizeof(widest_uleb),
+                "Ten-byte ULEB128 limit misread by schema reader");
+    position = 0;
+    assert_true(sctp_schema_read_sleb128(widest_sleb, sizeof(widest_sleb), &position, &sleb) == SCTP_OK &&
+                    sleb == INT64_MIN && position == sizeof(widest_sleb),
+                "Ten-byte SLEB128 limit misread by schema reader");
+
+    sctp_encoder_free(enc);
+    sctp_encoder_free(manual);
+    sctp_encoder_free(wrong);
+    printf("\n[OK] Schema codec test passed\n");
+}
+
+static void test_scatter_gather()
+{
+    printf("\n--- 20. Testing scatter/gather vectors ---\n");
+
+    uint8_t large[1000];
+    for (size_t i = 0; i < sizeof(large); i++)
+        large[i] = (uint8_t)(i * 13);
+    const char small[] = "abc";
+    const void *slices[2] = {large, small};
+
+    sctp_encoder_t *enc = sctp_encoder_create(32);
+    sctp_encoder_add_uint32_to(enc, 42);
+    sctp_encoder_add_vector_external_to(enc, sizeof(large), 0);
+    sctp_encoder_add_uleb128_to(enc, 300);
+    sctp_encoder_add_vector_external_to(enc, 3, 1);
+    sctp_encoder_add_vector_external_to(enc, 0, 1);
+    sctp_encoder_add_eof_to(enc);
+
+    // Only headers and prefixes are in the buffer.
+    assert_true(sctp_encoder_get_size(enc) == 5 + 3 + 3 + 1 + 1 + 1, "External payload was written to the buffer");
+    assert_true(sctp_encoder_get_segment_count(enc) == 3, "Segment count mismatch");
+    const sctp_segment_t *segments = sctp_encoder_get_segments(enc);
+    assert_true(segments[0].offset == 8 && segments[0].length == sizeof(large) && segments[0].tag == 0,
+                "First segment mismatch");
+    assert_true(segments[1].offset == 12 && segments[1].length == 3 && segments[1].tag == 1, "Second segment mismatch");
+
+    // The gathered stream is identical to copying the payloads in.
+    sctp_encoder_t *copied = sctp_encoder_create(2048);
+    sctp_encoder_add_uint32_to(copied, 42);
+    sctp_encoder_add_vector_data_to(copied, large, sizeof(large));
+    sctp_encoder_add_uleb128_to(copied, 300);
+    sctp_encoder_add_vector_data_to(copied, small, 3);
+    sctp_encoder_add_vector_data_to(copied, small, 0);
+    sctp_encoder_add_eof_to(copied);
+
+    const size_t size = sctp_encoder_get_gathered_size(enc);
+    assert_true(size == sctp_encoder_get_size(copied), "Gathered size mismatch");
+    uint8_t gathered[2048];
+    sctp_encoder_gather(enc, slices, gathered);
+    assert_true(memcmp(gathered, sctp_encoder_get_data(copied), size) == 0, "Gathered stream mismatch");
+
+    sctp_decoder_t *dec = sctp_decoder_from_buffer(gathered, size);
+    sctp_decoder_next(dec);
+    assert_true(sctp_decoder_next(dec) == SCTP_TYPE_VECTOR && dec->last_size == sizeof(large) &&
+                    memcmp(dec->last_value.as_ptr, large, sizeof(large)) == 0,
+                "Gathered vector does not decode");
+
+    // A measuring encoder counts external vectors in full.
+    sctp_encoder_t *measure = sctp_encoder_create_measuring();
+    sctp_encoder_add_uint32_to(measure, 42);
+    sctp_encoder_add_vector_external_to(measure, sizeof(large), 0);
+    assert_true(sctp_encoder_get_size(measure) == 5 + 3 + sizeof(large) && !sctp_encoder_get_segment_count(measure),
+                "Measuring encoder mismatch");
+
+#ifdef SCTP_FLUSH_ENABLE
+    sctp_encoder_t *stream = sctp_encoder_create_streaming(64);
+    assert_true(sctp_encoder_try_add_vector_external_to(stream, 10, 0) == SCTP_ERR_INVALID_ARG,
+                "Streaming encoder accepted an external vector");
+    sctp_encoder_free(stream);
+#endif
+
+    sctp_encoder_reset(enc);
+    assert_true(sctp_encoder_get_segment_count(enc) == 0 && sctp_encoder_get_segments(enc) == NULL,
+                "Reset did not clear segments");
+
+    sctp_encoder_free(enc);
+    sctp_encoder_free(copied);
+    sctp_encoder_free(measure);
+    printf("\n[OK] Scatter/gather test passed\n");
+}
+
+static void test_arena()
+{
+    printf("\n--- 21. Testing arenas and caller-owned decoders ---\n");
+
+    sctp_arena_t *arena = sctp_arena_create(4096);
+    assert_true(sctp_arena_used(arena) == 0, "New arena is not empty");
+
+    // Encode and decode a message per round in the same arena; memory use
+    // is the same every round because the arena is reset in between.
+    size_t used = 0;
+    for (int round = 0; round < 3; round++)
+    {
+        sctp_encoder_t *enc = sctp_encoder_create_in(arena, 16);
+        sctp_encoder_set_growth(enc, SCTP_GROWTH_GEOMETRIC, 0);
+        for (int i = 0; i < 10; i++)
+            sctp_encoder_add_uint32_to(enc, (uint32_t)(round * 100 + i));
+        sctp_encoder_add_eof_to(enc);
+
+        sctp_decoder_t *dec =
+            sctp_decoder_from_buffer_in(arena, sctp_encoder_get_data(enc), sctp_encoder_get_size(enc));
+        for (int i = 0; i < 10; i++)
+        {
+            assert_true(sctp_decoder_next(dec) == SCTP_TYPE_UINT32, "Arena decoder type mismatch");
+            assert_true(dec->last_value.as_uint32 == (uint32_t)(round * 100 + i), "Arena decoder value mismatch");
+        }
+        assert_true(sctp_decoder_next(dec) == SCTP_TYPE_EOF, "Arena decoder missed EOF");
+
+        if (round == 0)
+            used = sctp_arena_used(arena);
+        assert_true(sctp_arena_used(arena) == used, "Arena use is not steady across rounds");
+        sctp_encoder_free(enc); // no-op for arena encoders
+        sctp_arena_reset(arena);
+        assert_true(sctp_arena_used(arena) == 0, "Reset did not empty the arena");
+    }
+
+    // Allocation fails cleanly once the arena is full.
+    assert_true(sctp_arena_alloc(arena, 5000) == NULL, "Oversized allocation succeeded");
+    sctp_encoder_t *small = sctp_encoder_create_in(arena, 8);
+    sctp_encoder_set_growth(small, SCTP_GROWTH_CHUNKED, 8192);
+    assert_true(sctp_encoder_try_add_vector_data_to(small, "0123456789abcdef", 16) == SCTP_ERR_NO_SPACE,
+                "Growth beyond the arena did not fail");
+    sctp_arena_free(arena);
+
+    // An arena in caller memory, and a decoder on the stack.
+    uint8_t memory[512];
+    sctp_arena_t *local = sctp_arena_from_buffer(memory, sizeof(memory));
+    assert_true(local != NULL && sctp_arena_from_buffer(memory, 8) == NULL, "Arena placement mismatch");
+    void *a = sctp_arena_alloc(local, 1);
+    void *b = sctp_arena_alloc(local, 1);
+    assert_true(((uintptr_t)a & 15) == 0 && ((uintptr_t)b & 15) == 0 && a != b, "Arena allocations not aligned");
+
+    const uint8_t message[] = {SCTP_TYPE_SHORT | (7 << 4), SCTP_TYPE_EOF};
+    sctp_decoder_t stack_dec;
+    sctp_decoder_bind(&stack_dec, message, sizeof(message));
+    assert_true(sctp_decoder_next(&stack_dec) == SCTP_TYPE_SHORT && stack_dec.last_value.as_short == 7,
+                "Bound decoder mismatch");
+    sctp_decoder_bind(&stack_dec, message + 1, 1);
+    assert_true(stack_dec.position == 0 && sctp_decoder_next(&stack_dec) == SCTP_TYPE_EOF, "Rebinding failed");
+    sctp_arena_free(local); // no-op for caller memory
+
+    // Heap decoders are released with sctp_decoder_free.
+    sctp_decoder_free(sctp_decoder_from_buffer(message, sizeof(message)));
+    sctp_decoder_free(NULL);
+
+    printf("\n[OK] Arena test passed\n");
+}
+
+#ifdef SCTP_PARALLEL
+#define TEST_PARALLEL_TXS 1000
+#define TEST_PARALLEL_STRIDE 16
+
+typedef struct
+{
+    uint64_t sums[TEST_PARALLEL_TXS];    ///< Per-block sum of ULEB128 values and vector bytes.
+    size_t fields[TEST_PARALLEL_TXS];    ///< Per-block field count.
+    size_t order[TEST_PARALLEL_TXS];     ///< Blocks in the order they were merged.
+    size_t merged;
+    size_t fail_block;                   ///< Block whose handler fails, or SIZE_MAX.
+} test_parallel_ctx_t;
+
+static int test_parallel_block(sctp_decoder_t *dec, size_t block, void *context)
+{
+    test_parallel_ctx_t *ctx = context;
+    if (block == ctx->fail_block)
+        return SCTP_ERR_TYPE_MISMATCH;
+    uint64_t sum = 0;
+    size_t fields = 0;
+    int status;
+    while ((status = sctp_decoder_try_next(dec)) == SCTP_OK && dec->last_type != SCTP_TYPE_EOF)
+    {
+        if (dec->last_type == SCTP_TYPE_ULEB128)
+            sum += dec->last_value.as_uleb128;
+        else
+            for (size_t i = 0; i < dec->last_size; i++)
+                sum += ((const uint8_t *)dec->last_value.as_ptr)[i];
+        fields++;
+    }
+    ctx->sums[block] = sum;
+    ctx->fields[block] = fields;
+    return status;
+}
+
+static void test_parallel_merge(size_t block, void *context)
+{
+    test_parallel_ctx_t *ctx = context;
+    ctx->order[ctx->merged++] = block;
+}
+
+static void test_parallel_decode()
+{
+    printf("\n--- 22. Testing parallel block decode ---\n");
+
+    static uint8_t blob[4096];
+    for (size_t i = 0; i < sizeof(blob); i++)
+        blob[i] = (uint8_t)(i * 7 + 3);
+
+    // Transactions of a ULEB128 and a vector whose size varies a lot.
+    sctp_encoder_t *enc = sctp_encoder_create(1024);
+    sctp_encoder_set_growth(enc, SCTP_GROWTH_GEOMETRIC, 0);
+    uint64_t expected = 0;
+    for (size_t tx = 0; tx < TEST_PARALLEL_TXS; tx++)
+    {
+        const size_t length = (tx % 97 == 0) ? sizeof(blob) : tx % 40;
+        sctp_encoder_add_uleb128_to(enc, tx * 1000);
+        sctp_encoder_add_vector_data_to(enc, blob, length);
+        expected += tx * 1000;
+        for (size_t i = 0; i < length; i++)
+            expected += blob[i];
+    }
+    sctp_encoder_add_eof_to(enc);
+    const uint8_t *data = sctp_encoder_get_data(enc);
+    const size_t size = sctp_encoder_get_size(enc);
+    sctp_index_t *index = sctp_index_build(data, size, TEST_PARALLEL_STRIDE);
+
+    static test_parallel_ctx_t ctx;
+    // The last count is clamped to the number of blocks.
+    const size_t thread_counts[] = {1, 4, SIZE_MAX};
+    for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++)
+    {
+        memset(&ctx, 0, sizeof(ctx));
+        ctx.fail_block = SIZE_MAX;
+        int status = sctp_index_decode_parallel(data, size, index, thread_counts[t], test_parallel_block,
+                                                test_parallel_merge, &ctx);
+        assert_true(status == SCTP_OK, "Parallel decode failed");
+        assert_true(ctx.merged == index->count, "Not every block was merged");
+        uint64_t sum = 0;
+        size_t fields = 0;
+        for (size_t block = 0; block < index->count; block++)
+        {
+            assert_true(ctx.order[block] == block, "Blocks merged out of order");
+            sum += ctx.sums[block];
+            fields += ctx.fields[block];
+        }
+        assert_true(sum == expected && fields == index->fields, "Parallel decode results differ");
+    }
+
+    // A failing block stops the run; only the blocks before it are merged.
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.fail_block = 5;
+    assert_true(sctp_index_decode_parallel(data, size, index, 4, test_parallel_block, test_parallel_merge, &ctx) ==
+                    SCTP_ERR_TYPE_MISMATCH,
+                "Block failure not reported");
+    assert_true(ctx.merged == 5, "Blocks after the failure were merged");
+
+    assert_true(sctp_index_decode_parallel(data, size, index, 0, test_parallel_block, NULL, &ctx) ==
+                    SCTP_ERR_INVALID_ARG,
+                "Zero threads accepted");
+    assert_true(sctp_index_decode_parallel(data, index->offsets[index->count - 1] - 1, index, 2, test_parallel_block,
+                                           NULL, &ctx) == SCTP_ERR_INVALID_ARG,
+                "Index larger than the buffer accepted");
+
+    free(index);
+    sctp_encoder_free(enc);
+    printf("\n[OK] Parallel decode test passed\n");
+}
+#endif
+
+static void test_auto_width()
+{
+    printf("\n--- 23. Testing auto-width integers ---\n");
+
+    static const struct
+    {
+        uint64_t value;
+        sctp_type_t type;
+        size_t size;
+    } unsigned_cases[] = {
+        {0, SCTP_TYPE_SHORT, 1},
+        {15, SCTP_TYPE_SHORT, 1},
+        {16, SCTP_TYPE_UINT8, 2},
+        {255, SCTP_TYPE_UINT8, 2},
+        {256, SCTP_TYPE_UINT16, 3},
+        {65535, SCTP_TYPE_UINT16, 3},
+        {65536, SCTP_TYPE_ULEB128, 4},
+        {(1u << 21) - 1, SCTP_TYPE_ULEB128, 4},
+        {1u << 21, SCTP_TYPE_UINT32, 5},
+        {UINT32_MAX, SCTP_TYPE_UINT32, 5},
+        {(uint64_t)UINT32_MAX + 1, SCTP_TYPE_ULEB128, 6},
+        {(1ULL << 49) - 1, SCTP_TYPE_ULEB128, 8},
+        {1ULL << 49, SCTP_TYPE_UINT64, 9},
+        {UINT64_MAX, SCTP_TYPE_UINT64, 9},
+    };
+    static const struct
+    {
+        int64_t value;
+        sctp_type_t type;
+        size_t size;
+    } signed_cases[] = {
+        {7, SCTP_TYPE_SHORT, 1},
+        {-1, SCTP_TYPE_INT8, 2},
+        {-128, SCTP_TYPE_INT8, 2},
+        {-129, SCTP_TYPE_INT16, 3},
+        {-32768, SCTP_TYPE_INT16, 3},
+        {-32769, SCTP_TYPE_SLEB128, 4},
+        {-(1 << 20), SCTP_TYPE_SLEB128, 4},
+        {-(1 << 20) - 1, SCTP_TYPE_INT32, 5},
+        {INT32_MIN, SCTP_TYPE_INT32, 5},
+        {(int64_t)INT32_MIN - 1, SCTP_TYPE_SLEB128, 6},
+        {-(1LL << 48), SCTP_TYPE_SLEB128, 8},
+        {-(1LL << 48) - 1, SCTP_TYPE_INT64, 9},
+        {INT64_MIN, SCTP_TYPE_INT64, 9},
+        {INT64_MAX, SCTP_TYPE_UINT64, 9},
+    };
+    const size_t unsigned_count = sizeof(unsigned_cases) / sizeof(unsigned_cases[0]);
+    const size_t signed_count = sizeof(signed_cases) / sizeof(signed_cases[0]);
+
+    sctp_encoder_t *enc = sctp_encoder_create(16);
+    sctp_encoder_set_growth(enc, SCTP_GROWTH_GEOMETRIC, 0);
+    size_t expected = 0;
+    for (size_t i = 0; i < unsigned_count; i++)
+    {
+        assert_true(sctp_size_uint_auto(unsigned_cases[i].value) == unsigned_cases[i].size,
+                    "Unsigned auto size mismatch");
+        sctp_encoder_add_uint_auto_to(enc, unsigned_cases[i].value);
+        expected += unsigned_cases[i].size;
+        assert_true(sctp_encoder_get_size(enc) == expected, "Unsigned auto field has the wrong length");
+    }
+    for (size_t i = 0; i < signed_count; i++)
+    {
+        assert_true(sctp_size_int_auto(signed_cases[i].value) == signed_cases[i].size, "Signed auto size mismatch");
+        assert_true(sctp_encoder_try_add_int_auto_to(enc, signed_cases[i].value) == SCTP_OK,
+                    "Signed auto add failed");
+        expected += signed_cases[i].size;
+        assert_true(sctp_encoder_get_size(enc) == expected, "Signed auto field has the wrong length");
+    }
+    sctp_encoder_add_float64_to(enc, 1.5);
+    sctp_encoder_add_eof_to(enc);
+
+    // Every field reads back through the integer accessors, whatever its type.
+    sctp_decoder_t *dec = sctp_decoder_from_buffer(sctp_encoder_get_data(enc), sctp_encoder_get_size(enc));
+    uint64_t u;
+    int64_t s;
+    for (size_t i = 0; i < unsigned_count; i++)
+    {
+        assert_true(sctp_decoder_next(dec) == unsigned_cases[i].type, "Unsigned auto type mismatch");
+        assert_true(sctp_decoder_as_uint(dec, &u) == SCTP_OK && u == unsigned_cases[i].value,
+                    "Unsigned auto value mismatch");
+        int status = sctp_decoder_as_int(dec, &s);
+        if (unsigned_cases[i].value > INT64_MAX)
+            assert_true(status == SCTP_ERR_OVERFLOW, "Large unsigned value read as signed");
+        else
+            assert_true(status == SCTP_OK && (uint64_t)s == unsigned_cases[i].value, "Unsigned value read as signed");
+    }
+    for (size_t i = 0; i < signed_count; i++)
+    {
+        assert_true(sctp_decoder_next(dec) == signed_cases[i].type, "Signed auto type mismatch");
+        assert_true(sctp_decoder_as_int(dec, &s) == SCTP_OK && s == signed_cases[i].value,
+                    "Signed auto value mismatch");
+        int status = sctp_decoder_as_uint(dec, &u);
+        if (signed_cases[i].value < 0)
+            assert_true(status == SCTP_ERR_OVERFLOW, "Negative value read as unsigned");
+        else
+            assert_true(status == SCTP_OK && u == (uint64_t)signed_cases[i].value, "Signed value read as unsigned");
+    }
+    assert_true(sctp_decoder_next(dec) == SCTP_TYPE_FLOAT64, "Missing float field");
+    assert_true(sctp_decoder_as_uint(dec, &u) == SCTP_ERR_TYPE_MISMATCH, "Float read as integer");
+    assert_true(sctp_decoder_next(dec) == SCTP_TYPE_EOF, "Missing EOF");
+    assert_true(sctp_decoder_as_int(dec, &s) == SCTP_ERR_TYPE_MISMATCH, "EOF read as integer");
+    assert_true(sctp_decoder_as_int(NULL, &s) == SCTP_ERR_INVALID_ARG, "NULL decoder accepted");
+
+    // The field variants read batch-decoded fields the same way.
+    sctp_field_t fields[4];
+    sctp_decoder_seek(dec, 0);
+    assert_true(sctp_decoder_next_batch(dec, fields, 4) == 4, "Batch decode failed");
+    for (size_t i = 0; i < 4; i++)
+        assert_true(sctp_field_as_uint(&fields[i], &u) == SCTP_OK && u == unsigned_cases[i].value,
+                    "Field accessor value mismatch");
+    sctp_decoder_free(dec);
+
+    // A measuring encoder agrees with the size helpers.
+    sctp_encoder_t *measure = sctp_encoder_create_measuring();
+    sctp_encoder_add_uint_auto_to(measure, 1000000);
+    sctp_encoder_add_int_auto_to(measure, -1000000);
+    assert_true(sctp_encoder_get_size(measure) == sctp_size_uint_auto(1000000) + sctp_size_int_auto(-1000000),
+                "Measured auto size mismatch");
+    sctp_encoder_free(measure);
+    sctp_encoder_free(enc);
+
+    printf("\n[OK] Auto-width integer test passed\n");
+}
+
+static void test_dictionary()
+{
+    printf("\n--- 24. Testing vector back-references ---\n");
+
+    uint8_t address_a[32], address_b[32];
+    for (int i = 0; i < 32; i++)
+    {
+        address_a[i] = (uint8_t)(i * 7 + 1);
+        address_b[i] = (uint8_t)(i * 13 + 2);
+    }
+
+    sctp_encoder_t *plain = sctp_encoder_create(64);
+    sctp_encoder_t *enc = sctp_encoder_create(64);
+    sctp_encoder_set_growth(plain, SCTP_GROWTH_GEOMETRIC, 0);
+    sctp_encoder_set_growth(enc, SCTP_GROWTH_GEOMETRIC, 0);
+    assert_true(sctp_encoder_set_dictionary(enc, 50) == SCTP_OK, "Enabling the dictionary failed");
+    for (uint32_t i = 0; i < 50; i++)
+    {
+        sctp_encoder_t *targets[2] = {plain, enc};
+        for (int t = 0; t < 2; t++)
+        {
+            sctp_encoder_add_vector_data_to(targets[t], address_a, sizeof(address_a));
+            sctp_encoder_add_uint32_to(targets[t], i);
+            assert_true(sctp_encoder_try_add_vector_data_to(targets[t], address_b, sizeof(address_b)) == SCTP_OK,
+                        "Adding a vector failed");
+            sctp_encoder_add_vector_data_to(targets[t], "abc", 3); // too short to be deduplicated
+        }
+    }
+    sctp_encoder_add_eof_to(plain);
+    sctp_encoder_add_eof_to(enc);
+    const uint8_t *data = sctp_encoder_get_data(enc);
+    const size_t size = sctp_encoder_get_size(enc);
+    assert_true(size * 3 < sctp_encoder_get_size(plain), "Back-references did not shrink the stream");
+    assert_true(sctp_validate(data, size, NULL) == SCTP_OK, "Deduplicated stream failed validation");
+
+    // Repeats decode as vectors that point at the first copy.
+    sctp_decoder_t *dec = sctp_decoder_from_buffer(data, size);
+    const void *first_a = NULL, *first_b = NULL;
+    for (uint32_t i = 0; i < 50; i++)
+    {
+        assert_true(sctp_decoder_try_next(dec) == SCTP_OK && dec->last_type == SCTP_TYPE_VECTOR &&
+                        dec->last_size == 32 && memcmp(dec->last_value.as_ptr, address_a, 32) == 0,
+                    "Address A mismatch");
+        if (i == 0)
+            first_a = dec->last_value.as_ptr;
+        assert_true(dec->last_value.as_ptr == first_a, "Back-reference is not zero-copy");
+        assert_true(sctp_decoder_next(dec) == SCTP_TYPE_UINT32 && dec->last_value.as_uint32 == i, "Counter mismatch");
+        assert_true(sctp_decoder_next(dec) == SCTP_TYPE_VECTOR && memcmp(dec->last_value.as_ptr, address_b, 32) == 0,
+                    "Address B mismatch");
+        if (i == 0)
+            first_b = dec->last_value.as_ptr;
+        assert_true(dec->last_value.as_ptr == first_b, "Back-reference to B is not zero-copy");
+        assert_true(sctp_decoder_next(dec) == SCTP_TYPE_VECTOR && dec->last_size == 3, "Short vector mismatch");
+    }
+    assert_true(sctp_decoder_next(dec) == SCTP_TYPE_EOF, "Missing EOF");
+
+    // Skipping steps over back-references without resolving them.
+    sctp_decoder_seek(dec, 0);
+    assert_true(sctp_decoder_skip(dec, 200) == 200 && sctp_decoder_next(dec) == SCTP_TYPE_EOF,
+                "Skipping back-references failed");
+    sctp_decoder_free(dec);
+
+    // A decoder bound to a later slice resolves them through `origin`, as
+    // the parallel block decoder does.
+    sctp_decoder_t slice;
+    const size_t round = 2 * sctp_size_vector(32) + sctp_size_uint32() + sctp_size_vector(3);
+    sctp_decoder_bind(&slice, data + round, size - round);
+    slice.origin = data;
+    assert_true(sctp_decoder_next(&slice) == SCTP_TYPE_VECTOR && slice.last_value.as_ptr == first_a,
+                "Back-reference from a slice mismatch");
+
+    // A streaming decoder cannot reach earlier input and rejects them.
+    sctp_stream_decoder_t *sdec = sctp_stream_decoder_create();
+    sctp_field_t field;
+    int status;
+    sctp_stream_decoder_feed(sdec, data, size);
+    while ((status = sctp_stream_decoder_next(sdec, &field)) == SCTP_OK)
+        ;
+    assert_true(status == SCTP_ERR_RESERVED_TYPE, "Streaming decoder accepted a back-reference");
+    sctp_stream_decoder_free(sdec);
+
+    // Resetting empties the dictionary.
+    sctp_encoder_reset(enc);
+    sctp_encoder_add_vector_data_to(enc, address_a, sizeof(address_a));
+    assert_true(sctp_encoder_get_size(enc) == sctp_size_vector(32), "Dictionary survived a reset");
+
+    // Schema codecs write and resolve back-references too.
+    const char recipient[] = "lea1qxyzrecipientaddress";
+    test_tx_t tx = {.nonce = 1, .fee = 2, .delta = -3, .kind = 4,
+                    .to = {(const uint8_t *)recipient, sizeof(recipient) - 1}, .rate = 0.5, .flags = 6};
+    sctp_encoder_reset(enc);
+    test_tx_encode_to(enc, &tx);
+    test_tx_encode_to(enc, &tx);
+    assert_true(sctp_encoder_get_size(enc) < 2 * test_tx_size(&tx), "Schema encoder did not deduplicate");
+    dec = sctp_decoder_from_buffer(sctp_encoder_get_data(enc), sctp_encoder_get_size(enc));
+    test_tx_t out[2];
+    assert_true(test_tx_decode(dec, &out[0]) == SCTP_OK && test_tx_decode(dec, &out[1]) == SCTP_OK,
+                "Schema decode of back-reference failed");
+    assert_true(out[1].to.data == out[0].to.data && out[1].to.size == tx.to.size, "Schema back-reference mismatch");
+    sctp_decoder_free(dec);
+
+    // Distances count external payloads, so they hold in the gathered stream.
+    uint8_t payload[100];
+    memset(payload, 0x5A, sizeof(payload));
+    const void *slices[1] = {payload};
+    sctp_encoder_reset(enc);
+    sctp_encoder_add_vector_data_to(enc, address_a, sizeof(address_a));
+    sctp_encoder_add_vector_external_to(enc, sizeof(payload), 0);
+    sctp_encoder_add_vector_data_to(enc, address_a, sizeof(address_a));
+    uint8_t gathered[256];
+    sctp_encoder_gather(enc, slices, gathered);
+    dec = sctp_decoder_from_buffer(gathered, sctp_encoder_get_gathered_size(enc));
+    sctp_decoder_next(dec);
+    first_a = dec->last_value.as_ptr;
+    assert_true(sctp_decoder_next(dec) == SCTP_TYPE_VECTOR && dec->last_size == sizeof(payload), "Missing payload");
+    assert_true(sctp_decoder_next(dec) == SCTP_TYPE_VECTOR && dec->last_value.as_ptr == first_a,
+                "Back-reference across an external payload mismatch");
+    sctp_decoder_free(dec);
+
+    // Malformed back-references are reported, never followed.
+    static const struct
+    {
+        uint8_t bytes[8];
+        size_t size;
+        size_t position;
+    } bad[] = {
+        {{0xDE, 0x00}, 2, 0},                          // zero distance
+        {{0xDE, 0x05}, 2, 0},                          // before the start
+        {{0x01, 0x07, 0xDE, 0x02}, 4, 2},              // points at a UINT8
+        {{0x3D, 'x', 'y', 'z', 0xDE, 0x02}, 6, 4},     // points into a vector
+        {{0x1D, 'x', 0xDE, 0x02, 0xDE, 0x02}, 6, 4},   // points at a back-reference
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++)
+    {
+        size_t where = SIZE_MAX;
+        assert_true(sctp_validate(bad[i].bytes, bad[i].size, &where) == SCTP_ERR_BAD_REFERENCE &&
+                        where == bad[i].position,
+                    "Bad back-reference not reported by validate");
+        dec = sctp_decoder_from_buffer(bad[i].bytes, bad[i].size);
+        while ((status = sctp_decoder_try_next(dec)) == SCTP_OK && dec->last_type != SCTP_TYPE_EOF)
+            ;
+        assert_true(status == SCTP_ERR_BAD_REFERENCE && dec->position == bad[i].position,
+                    "Bad back-reference not reported by try_next");
+        sctp_decoder_free(dec);
+    }
+
+    sctp_encoder_t *measure = sctp_encoder_create_measuring();
+    assert_true(sctp_encoder_set_dictionary(measure, 16) == SCTP_ERR_INVALID_ARG, "Measuring dictionary accepted");
+    assert_true(sctp_encoder_set_dictionary(enc, 1 << 20) == SCTP_ERR_INVALID_ARG, "Oversized dictionary accepted");
+    assert_true(sctp_encoder_set_dictionary(enc, 0) == SCTP_OK, "Disabling the dictionary failed");
+    sctp_encoder_free(measure);
+    sctp_encoder_free(plain);
+    sctp_encoder_free(enc);
+
+    printf("\n[OK] Vector back-reference test passed\n");
+}
+
+static void test_batch_container()
+{
+    printf("\n--- 25. Testing batch containers ---\n");
+
+    sctp_encoder_t *message = sctp_encoder_create(64);
+    for (int with_table = 0; with_table < 2; with_table++)
+    {
+        sctp_batch_encoder_t *batch = sctp_batch_encoder_create(16, with_table);
+        size_t expected = 0;
+        for (uint32_t i = 0; i < 200; i++)
+        {
+            sctp_encoder_reset(message);
+            if (i != 5) // message 5 is empty
+            {
+                sctp_encoder_add_uint32_to(message, i);
+                sctp_encoder_add_vector_data_to(message, "payload", i % 8);
+                sctp_encoder_add_eof_to(message);
+            }
+            const size_t size = sctp_encoder_get_size(message);
+            sctp_batch_encoder_append(batch, sctp_encoder_get_data(message), size);
+            expected += sctp_size_uleb128(size) - 1 + size;
+        }
+        assert_true(sctp_batch_encoder_count(batch) == 200, "Batch count mismatch");
+        expected += sctp_size_uleb128(2 * 200 + with_table) - 1 + (with_table ? 4 * 200 : 0);
+
+        size_t size;
+        const uint8_t *data = sctp_batch_encoder_finish(batch, &size);
+        assert_true(size == expected, "Batch container size mismatch");
+        size_t again;
+        assert_true(sctp_batch_encoder_finish(batch, &again) == data && again == size, "Finish is not repeatable");
+        assert_true(sctp_batch_encoder_try_append(batch, "x", 1) == SCTP_ERR_INVALID_ARG, "Append after finish accepted");
+
+        // One stack decoder is rebound to every message in turn.
+        sctp_batch_reader_t reader;
+        sctp_decoder_t dec;
+        assert_true(sctp_batch_open(&reader, data, size) == SCTP_OK && reader.count == 200, "Batch open failed");
+        assert_true((reader.table != NULL) == with_table, "Offset table not detected");
+        uint32_t i = 0;
+        while (sctp_batch_next(&reader, &dec))
+        {
+            if (i == 5)
+            {
+                assert_true(sctp_decoder_next(&dec) == SCTP_TYPE_EOF && dec.size == 0, "Empty message mismatch");
+            }
+            else
+            {
+                assert_true(sctp_decoder_next(&dec) == SCTP_TYPE_UINT32 && dec.last_value.as_uint32 == i,
+                            "Batch message value mismatch");
+                assert_true(sctp_decoder_next(&dec) == SCTP_TYPE_VECTOR && dec.last_size == i % 8,
+                            "Batch message vector mismatch");
+                assert_true(sctp_decoder_next(&dec) == SCTP_TYPE_EOF && dec.position == dec.size,
+                            "Batch message is not bounded");
+            }
+            i++;
+        }
+        assert_true(i == 200, "Batch iteration count mismatch");
+
+        // Random access, with or without the table.
+        const uint32_t picks[] = {199, 0, 77, 6};
+        for (size_t k = 0; k < sizeof(picks) / sizeof(picks[0]); k++)
+        {
+            assert_true(sctp_batch_message(&reader, picks[k], &dec) == SCTP_OK, "Batch message lookup failed");
+            assert_true(sctp_decoder_next(&dec) == SCTP_TYPE_UINT32 && dec.last_value.as_uint32 == picks[k],
+                        "Batch random access mismatch");
+        }
+        assert_true(sctp_batch_message(&reader, 200, &dec) == SCTP_ERR_INVALID_ARG, "Out-of-range message accepted");
+
+        // Damaged containers are rejected when opened.
+        for (size_t cut = 0; cut < size; cut++)
+            assert_true(sctp_batch_open(&reader, data, cut) != SCTP_OK, "Truncated container accepted");
+        uint8_t *copy = malloc(size + 1);
+        memcpy(copy, data, size);
+        copy[size] = 0;
+        assert_true(sctp_batch_open(&reader, copy, size + 1) ==
+                        (with_table ? SCTP_ERR_BAD_FRAME : SCTP_ERR_TRAILING_DATA),
+                    "Trailing byte not reported");
+        if (with_table)
+        {
+            copy[size - 4]++;
+            assert_true(sctp_batch_open(&reader, copy, size) == SCTP_ERR_BAD_FRAME, "Bad offset table accepted");
+        }
+        free(copy);
+
+        // A reset batch is empty and can be reused.
+        sctp_batch_encoder_reset(batch);
+        data = sctp_batch_encoder_finish(batch, &size);
+        assert_true(size == 1 && data[0] == with_table, "Empty batch mismatch");
+        assert_true(sctp_batch_open(&reader, data, size) == SCTP_OK && !sctp_batch_next(&reader, &dec),
+                    "Empty batch has messages");
+        sctp_batch_encoder_free(batch);
+    }
+    sctp_encoder_free(message);
+
+    printf("\n[OK] Batch container test passed\n");
+}
+
+static void test_checksum()
+{
+    printf("\n--- 26. Testing checksum trailers ---\n");
+
+    // Standard CRC32C check value, and the same CRC computed in pieces.
+    assert_true(sctp_crc32c(0, "123456789", 9) == 0xE3069283, "CRC32C check value mismatch");
+    assert_true(sctp_crc32c(sctp_crc32c(0, "1234", 4), "56789", 5) == 0xE3069283, "Incremental CRC32C mismatch");
+    assert_true(sctp_crc32c(0, NULL, 0) == 0, "Empty CRC32C mismatch");
+
+    uint8_t blob[600];
+    for (size_t i = 0; i < sizeof(blob); i++)
+        blob[i] = (uint8_t)(i * 13 + 1);
+    const uint16_t words[4] = {1, 2, 3, 4};
+
+    sctp_encoder_t *enc = sctp_encoder_create(16);
+    sctp_encoder_set_growth(enc, SCTP_GROWTH_GEOMETRIC, 0);
+    assert_true(sctp_encoder_try_add_checksum_to(enc) == SCTP_ERR_INVALID_ARG, "Trailer without checksum accepted");
+    sctp_encoder_set_checksum(enc, true);
+    assert_true(sctp_encoder_try_add_vector_external_to(enc, 8, 0) == SCTP_ERR_INVALID_ARG,
+                "External vector accepted while checksumming");
+    for (int i = 0; i < 50; i++)
+    {
+        sctp_encoder_add_uint32_to(enc, (uint32_t)i * 0x01010101u);
+        sctp_encoder_add_sleb128_to(enc, -i * 1000);
+        // Filled in after the call returns, before the next field starts.
+        uint8_t *payload = sctp_encoder_add_vector_to(enc, (size_t)i * 7);
+        memcpy(payload, blob, (size_t)i * 7);
+        sctp_encoder_add_packed_uint16_to(enc, words, 4);
+    }
+    sctp_encoder_add_checksum_to(enc);
+    sctp_encoder_add_eof_to(enc);
+
+    const uint8_t *data = sctp_encoder_get_data(enc);
+    const size_t size = sctp_encoder_get_size(enc);
+    const size_t trailer = size - 6;
+    uint32_t stored;
+    memcpy(&stored, data + trailer + 1, sizeof(stored));
+    assert_true(data[trailer] == SCTP_TYPE_UINT32 && stored == sctp_crc32c(0, data, trailer),
+                "Trailer does not hold the CRC of the preceding bytes");
+
+    // Verified while decoding, with next, try_next and skip.
+    sctp_decoder_t dec;
+    sctp_decoder_bind(&dec, data, size);
+    sctp_decoder_set_checksum(&dec, true);
+    size_t fields = 0;
+    while (sctp_decoder_next(&dec) != SCTP_TYPE_EOF)
+        fields++;
+    assert_true(fields == 201 && !dec.verify_checksum, "Checksum not verified by next");
+
+    sctp_decoder_bind(&dec, data, size);
+    sctp_decoder_set_checksum(&dec, true);
+    int status;
+    do
+        status = sctp_decoder_try_next(&dec);
+    while (status == SCTP_OK && dec.last_type != SCTP_TYPE_EOF);
+    assert_true(status == SCTP_OK && !dec.verify_checksum, "Checksum not verified by try_next");
+
+    sctp_decoder_bind(&dec, data, size);
+    sctp_decoder_set_checksum(&dec, true);
+    sctp_decoder_next(&dec);
+    assert_true(sctp_decoder_skip(&dec, 1000) == 200, "Skip count mismatch");
+    assert_true(sctp_decoder_try_next(&dec) == SCTP_OK && dec.last_type == SCTP_TYPE_EOF, "Checksum lost by skip");
+
+    // A damaged payload byte is reported at EOF, which is not consumed.
+    uint8_t *copy = malloc(size);
+    memcpy(copy, data, size);
+    copy[3] ^= 0x40;
+    sctp_decoder_bind(&dec, copy, size);
+    sctp_decoder_set_checksum(&dec, true);
+    do
+        status = sctp_decoder_try_next(&dec);
+    while (status == SCTP_OK);
+    assert_true(status == SCTP_ERR_CHECKSUM && dec.position == size - 1, "Damaged stream accepted");
+    assert_true(sctp_decoder_try_next(&dec) == SCTP_ERR_CHECKSUM, "Checksum error is not repeatable");
+
+    // A stream without a trailer fails verification, also without an EOF field.
+    sctp_decoder_bind(&dec, data, trailer);
+    sctp_decoder_set_checksum(&dec, true);
+    do
+        status = sctp_decoder_try_next(&dec);
+    while (status == SCTP_OK);
+    assert_true(status == SCTP_ERR_CHECKSUM, "Missing trailer accepted");
+    sctp_decoder_bind(&dec, data, 0);
+    sctp_decoder_set_checksum(&dec, true);
+    assert_true(sctp_decoder_try_next(&dec) == SCTP_ERR_CHECKSUM, "Empty stream accepted");
+    free(copy);
+
+    // Reset restarts the checksum; the trailer also covers an empty message.
+    sctp_encoder_reset(enc);
+    sctp_encoder_add_checksum_to(enc);
+    sctp_encoder_add_eof_to(enc);
+    data = sctp_encoder_get_data(enc);
+    assert_true(sctp_encoder_get_size(enc) == 6 && data[1] == 0 && data[4] == 0, "Empty trailer mismatch");
+    sctp_decoder_bind(&dec, data, 6);
+    sctp_decoder_set_checksum(&dec, true);
+    assert_true(sctp_decoder_try_next(&dec) == SCTP_OK && sctp_decoder_try_next(&dec) == SCTP_OK &&
+                    dec.last_type == SCTP_TYPE_EOF,
+                "Empty checksummed message rejected");
+    sctp_encoder_free(enc);
+
+    // A payload may be filled in after later fields, as long as the buffer stays put.
+    enc = sctp_encoder_create(1024);
+    sctp_encoder_set_checksum(enc, true);
+    uint8_t *late = sctp_encoder_add_vector_to(enc, 32);
+    sctp_encoder_add_uint32_to(enc, 0xCAFEF00Du);
+    sctp_encoder_add_vector_data_to(enc, blob, 300);
+    sctp_encoder_add_uint32_to(enc, 0xCAFEF00Du);
+    memcpy(late, blob + 100, 32);
+    sctp_encoder_add_checksum_to(enc);
+    sctp_encoder_add_eof_to(enc);
+    data = sctp_encoder_get_data(enc);
+    const size_t late_size = sctp_encoder_get_size(enc);
+    memcpy(&stored, data + late_size - 5, sizeof(stored));
+    assert_true(stored == sctp_crc32c(0, data, late_size - 6), "Late-filled payload missing from the CRC");
+    sctp_decoder_bind(&dec, data, late_size);
+    sctp_decoder_set_checksum(&dec, true);
+    fields = 0;
+    while (sctp_decoder_next(&dec) != SCTP_TYPE_EOF)
+        fields++;
+    assert_true(fields == 5 && !dec.verify_checksum, "Late-filled payload fails verification");
+    sctp_encoder_free(enc);
+
+    // A streaming encoder checksums every window before flushing it.
+    g_flush_size = 0;
+    sctp_encoder_t *stream = sctp_encoder_create_streaming(32);
+    sctp_encoder_set_checksum(stream, true);
+    for (int i = 0; i < 40; i++)
+        sctp_encoder_add_uint64_to(stream, (uint64_t)i << 40);
+    sctp_encoder_add_vector_data_to(stream, blob, 100);
+    const uint32_t expected = sctp_encoder_get_checksum(stream);
+    sctp_encoder_add_checksum_to(stream);
+    sctp_encoder_add_eof_to(stream);
+    sctp_encoder_flush_to(stream);
+    assert_true(expected == sctp_crc32c(0, g_flush_output, g_flush_size - 6), "Streaming checksum mismatch");
+    sctp_decoder_bind(&dec, g_flush_output, g_flush_size);
+    sctp_decoder_set_checksum(&dec, true);
+    while (sctp_decoder_next(&dec) != SCTP_TYPE_EOF)
+        ;
+    assert_true(!dec.verify_checksum, "Streamed checksum not verified");
+    sctp_encoder_free(stream);
+
+    printf("\n[OK] Checksum trailer test passed\n");
+}
+
+static void test_canonical()
+{
+    printf("\n--- 27. Testing canonical form and hash ---\n");
+
+    uint8_t blob[20];
+    for (size_t i = 0; i < sizeof(blob); i++)
+        blob[i] = (uint8_t)(i + 1);
+    const uint16_t words[3] = {1, 2, 3};
+
+    sctp_encoder_t *enc = sctp_encoder_create(256);
+    sctp_encoder_add_uleb128_to(enc, 300);
+    sctp_encoder_add_sleb128_to(enc, -5);
+    sctp_encoder_add_vector_data_to(enc, "abc", 3);
+    sctp_encoder_add_vector_data_to(enc, blob, sizeof(blob));
+    sctp_encoder_add_packed_uint16_to(enc, words, 3);
+    sctp_encoder_add_short_to(enc, 7);
+    sctp_encoder_add_uint32_to(enc, 0x11223344);
+    sctp_encoder_add_eof_to(enc);
+    const uint8_t *canonical = sctp_encoder_get_data(enc);
+    const size_t canonical_size = sctp_encoder_get_size(enc);
+
+    // The same fields with redundant LEB128 bytes, a large-form short vector,
+    // metadata bits on a fixed-width header and no EOF field.
+    uint8_t loose[64];
+    size_t n = 0;
+    const uint8_t head[] = {0x08, 0xAC, 0x82, 0x80, 0x00, 0x09, 0xFB, 0x7F, 0xFD, 0x83, 0x00, 'a', 'b', 'c', 0xFD, 0x94, 0x00};
+    memcpy(loose + n, head, sizeof(head));
+    n += sizeof(head);
+    memcpy(loose + n, blob, sizeof(blob));
+    n += sizeof(blob);
+    const uint8_t tail[] = {0x3E, 0x83, 0x80, 0x00, 1, 0, 2, 0, 3, 0, 0x7C, 0x35, 0x44, 0x33, 0x22, 0x11};
+    memcpy(loose + n, tail, sizeof(tail));
+    n += sizeof(tail);
+
+    uint8_t out[128];
+    size_t out_size;
+    assert_true(sctp_canonicalize(loose, n, out, sizeof(out), &out_size) == SCTP_OK, "Canonicalize failed");
+    assert_true(out_size == canonical_size && memcmp(out, canonical, out_size) == 0, "Canonical form mismatch");
+    assert_true(sctp_canonicalize(canonical, canonical_size, out, sizeof(out), &out_size) == SCTP_OK &&
+                    out_size == canonical_size && memcmp(out, canonical, out_size) == 0,
+                "Canonical input was changed");
+
+    uint64_t loose_hash, canonical_hash;
+    assert_true(sctp_canonical_hash(loose, n, &loose_hash) == SCTP_OK &&
+                    sctp_canonical_hash(canonical, canonical_size, &canonical_hash) == SCTP_OK,
+                "Canonical hash failed");
+    assert_true(loose_hash == canonical_hash, "Equal messages hash differently");
+    loose[n - 1] ^= 1;
+    assert_true(sctp_canonical_hash(loose, n, &loose_hash) == SCTP_OK && loose_hash != canonical_hash,
+                "Different messages hash equally");
+    uint64_t empty_hash;
+    assert_true(sctp_canonical_hash(NULL, 0, &empty_hash) == SCTP_OK && empty_hash == 0xAF63C24C8601C05EULL,
+                "Hash of the canonical empty message mismatch");
+
+    // Sizing, a short output buffer and malformed input.
+    assert_true(sctp_canonicalize(loose, n, NULL, 0, &out_size) == SCTP_OK && out_size == canonical_size,
+                "Canonical size mismatch");
+    assert_true(sctp_canonicalize(loose, n, out, 10, &out_size) == SCTP_ERR_NO_SPACE && out_size == canonical_size,
+                "Short output buffer accepted");
+    assert_true(sctp_canonicalize(loose, 3, out, sizeof(out), &out_size) == SCTP_ERR_TRUNCATED,
+                "Truncated input accepted");
+    uint8_t padded[64];
+    memcpy(padded, canonical, canonical_size);
+    padded[canonical_size] = 0;
+    assert_true(sctp_canonicalize(padded, canonical_size + 1, out, sizeof(out), &out_size) == SCTP_ERR_TRAILING_DATA,
+                "Trailing data accepted");
+
+    // Back-references are expanded, so the dictionary does not change the canonical form.
+    sctp_encoder_t *plain = sctp_encoder_create(256);
+    sctp_encoder_t *dict = sctp_encoder_create(256);
+    sctp_encoder_set_dictionary(dict, 16);
+    for (int i = 0; i < 3; i++)
+    {
+        sctp_encoder_add_vector_data_to(plain, blob, sizeof(blob));
+        sctp_encoder_add_vector_data_to(dict, blob, sizeof(blob));
+    }
+    sctp_encoder_add_eof_to(plain);
+    sctp_encoder_add_eof_to(dict);
+    assert_true(sctp_encoder_get_size(dict) < sctp_encoder_get_size(plain), "Dictionary did not deduplicate");
+    assert_true(sctp_canonicalize(sctp_encoder_get_data(dict), sctp_encoder_get_size(dict), out, sizeof(out),
+                                  &out_size) == SCTP_OK,
+                "Canonicalize with back-references failed");
+    assert_true(out_size == sctp_encoder_get_size(plain) &&
+                    memcmp(out, sctp_encoder_get_data(plain), out_size) == 0,
+                "Back-references not expanded");
+    sctp_encoder_free(dict);
+    sctp_encoder_free(plain);
+    sctp_encoder_free(enc);
+
+    printf("\n[OK] Canonical form test passed\n");
+}
+
+static void test_mark_rollback()
+{
+    printf("\n--- 28. Testing encoder marks and rollback ---\n");
+
+    uint8_t blob[24];
+    for (size_t i = 0; i < sizeof(blob); i++)
+        blob[i] = (uint8_t)(i * 3);
+
+    // A block builder adds candidates speculatively and undoes the one that does not fit.
+    sctp_encoder_t *block = sctp_encoder_create(64);
+    sctp_encoder_t *expected = sctp_encoder_create(64);
+    sctp_encoder_mark_t mark;
+    size_t accepted = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        sctp_encoder_mark(block, &mark);
+        if (sctp_encoder_try_add_uint64_to(block, (uint64_t)i) != SCTP_OK ||
+            sctp_encoder_try_add_vector_data_to(block, blob, 8) != SCTP_OK || sctp_encoder_get_remaining(block) < 1)
+        {
+            sctp_encoder_rollback(block, &mark);
+            break;
+        }
+        sctp_encoder_add_uint64_to(expected, (uint64_t)i);
+        sctp_encoder_add_vector_data_to(expected, blob, 8);
+        accepted++;
+    }
+    assert_true(accepted == 3 && sctp_encoder_get_remaining(block) == 64 - 3 * 18, "Unexpected block fill");
+    sctp_encoder_add_eof_to(block);
+    sctp_encoder_add_eof_to(expected);
+    assert_true(sctp_encoder_get_size(block) == sctp_encoder_get_size(expected) &&
+                    memcmp(sctp_encoder_get_data(block), sctp_encoder_get_data(expected),
+                           sctp_encoder_get_size(block)) == 0,
+                "Rollback left bytes behind");
+
+    // A growing encoder only reports the space before its next reallocation, a measuring one the count left.
+    sctp_encoder_t *grow = sctp_encoder_create(16);
+    sctp_encoder_set_growth(grow, SCTP_GROWTH_GEOMETRIC, 0);
+    sctp_encoder_add_vector_data_to(grow, blob, 24);
+    assert_true(sctp_encoder_get_size(grow) == 26 && sctp_encoder_get_remaining(grow) < 16,
+                "Growing encoder remaining mismatch");
+    sctp_encoder_free(grow);
+    sctp_encoder_t *measure = sctp_encoder_create_measuring();
+    sctp_encoder_add_vector_data_to(measure, blob, 24);
+    assert_true(sctp_encoder_get_remaining(measure) == SIZE_MAX - 26, "Measuring encoder remaining mismatch");
+    sctp_encoder_free(measure);
+
+    // Vectors written after the mark are dropped from the dictionary.
+    sctp_encoder_t *dict = sctp_encoder_create(256);
+    sctp_encoder_set_dictionary(dict, 16);
+    sctp_encoder_add_vector_data_to(dict, blob, 8);
+    sctp_encoder_mark(dict, &mark);
+    sctp_encoder_add_vector_data_to(dict, blob + 8, 16);
+    sctp_encoder_add_vector_data_to(dict, blob, 8);
+    sctp_encoder_rollback(dict, &mark);
+    assert_true(sctp_encoder_get_size(dict) == 9, "Dictionary rollback size mismatch");
+    sctp_encoder_add_uint8_to(dict, 1);
+    sctp_encoder_add_vector_data_to(dict, blob + 8, 16);
+    sctp_encoder_add_vector_data_to(dict, blob, 8);
+    sctp_encoder_add_eof_to(dict);
+    sctp_decoder_t dec;
+    sctp_decoder_bind(&dec, sctp_encoder_get_data(dict), sctp_encoder_get_size(dict));
+    sctp_decoder_next(&dec);
+    sctp_decoder_next(&dec);
+    assert_true(sctp_decoder_next(&dec) == SCTP_TYPE_VECTOR && dec.last_size == 16 &&
+                    memcmp(dec.last_value.as_ptr, blob + 8, 16) == 0,
+                "Vector after rollback mismatch");
+    assert_true(sctp_decoder_next(&dec) == SCTP_TYPE_VECTOR && dec.last_size == 8 &&
+                    memcmp(dec.last_value.as_ptr, blob, 8) == 0,
+                "Back-reference after rollback mismatch");
+
+    // The running checksum and the segment list return to the mark as well.
+    sctp_encoder_t *sum = sctp_encoder_create(1024);
+    sctp_encoder_set_checksum(sum, true);
+    sctp_encoder_add_vector_data_to(sum, blob, sizeof(blob));
+    sctp_encoder_mark(sum, &mark);
+    for (int i = 0; i < 30; i++)
+        sctp_encoder_add_vector_data_to(sum, blob, sizeof(blob));
+    sctp_encoder_rollback(sum, &mark);
+    sctp_encoder_add_uint16_to(sum, 7);
+    sctp_encoder_add_checksum_to(sum);
+    sctp_encoder_add_eof_to(sum);
+    sctp_decoder_bind(&dec, sctp_encoder_get_data(sum), sctp_encoder_get_size(sum));
+    sctp_decoder_set_checksum(&dec, true);
+    while (sctp_decoder_next(&dec) != SCTP_TYPE_EOF)
+        ;
+    assert_true(dec.verify_checksum == false, "Checksum after rollback not verified");
+
+    sctp_encoder_t *gather = sctp_encoder_create(64);
+    sctp_encoder_add_vector_external_to(gather, 100, 0);
+    sctp_encoder_mark(gather, &mark);
+    sctp_encoder_add_vector_external_to(gather, 200, 1);
+    sctp_encoder_rollback(gather, &mark);
+    assert_true(sctp_encoder_get_segment_count(gather) == 1 && sctp_encoder_get_gathered_size(gather) == 102,
+                "Segments after rollback mismatch");
+
+    sctp_encoder_free(gather);
+    sctp_encoder_free(sum);
+    sctp_encoder_free(dict);
+    sctp_encoder_free(expected);
+    sctp_encoder_free(block);
+
+    printf("\n[OK] Encoder mark test passed\n");
+}
+
+#ifdef SCTP_STATS
+static void test_stats()
+{
+    printf("\n--- 19. Testing statistics counters ---\n");
+
+    uint8_t blob[300];
+    memset(blob, 0x5A, sizeof(blob));
+    const uint32_t words[3] = {1, 2, 3};
+
+    sctp_stats_reset();
+    sctp_encoder_t *enc = sctp_encoder_create(16);
+    sctp_encoder_set_growth(enc, SCTP_GROWTH_GEOMETRIC, 0);
+    sctp_encoder_add_uint32_to(enc, 7);
+    sctp_encoder_add_uint32_array_to(enc, words, 3);
+    sctp_encoder_add_uleb128_to(enc, 100);   // 1 byte
+    sctp_encoder_add_uleb128_to(enc, 300);   // 2 bytes
+    sctp_encoder_add_sleb128_to(enc, -70);   // 2 bytes
+    sctp_encoder_add_vector_data_to(enc, blob, 4);
+    sctp_encoder_add_vector_data_to(enc, blob, sizeof(blob));
+    sctp_encoder_add_short_to(enc, 3);
+    sctp_encoder_add_eof_to(enc);
+
+    // Measuring encoders write nothing and are not counted.
+    sctp_encoder_t *measure = sctp_encoder_create_measuring();
+    sctp_encoder_add_uint64_to(measure, 1);
+    sctp_encoder_free(measure);
+
+    const sctp_stats_t *stats = sctp_stats_get();
+    const sctp_stats_counters_t *e = &stats->encoded;
+    assert_true(e->fields[SCTP_TYPE_UINT32] == 4 && e->bytes[SCTP_TYPE_UINT32] == 20, "UINT32 counters wrong");
+    assert_true(e->fields[SCTP_TYPE_UINT64] == 0, "Measuring encoder was counted");
+    assert_true(e->fields[SCTP_TYPE_ULEB128] == 2 && e->bytes[SCTP_TYPE_ULEB128] == 5, "ULEB128 counters wrong");
+    assert_true(e->leb128_lengths[0] == 1 && e->leb128_lengths[1] == 2, "LEB128 histogram wrong");
+    assert_true(e->fields[SCTP_TYPE_VECTOR] == 2 && e->bytes[SCTP_TYPE_VECTOR] == 5 + 3 + sizeof(blob),
+                "VECTOR counters wrong");
+    assert_true(e->vector_sizes[3] == 1 && e->vector_sizes[9] == 1, "Vector histogram wrong");
+    assert_true(e->vector_long_prefix == 1, "Long vector prefix not counted");
+    assert_true(e->fields[SCTP_TYPE_SHORT] == 1 && e->fields[SCTP_TYPE_EOF] == 1, "SHORT/EOF counters wrong");
+
+    size_t total = 0;
+    for (int type = 0; type < 16; type++)
+        total += e->bytes[type];
+    assert_true(total == sctp_encoder_get_size(enc), "Byte counters do not add up to the encoded size");
+    assert_true(stats->capacity_high_water >= sctp_encoder_get_size(enc), "Capacity high-water mark too low");
+
+    // Decoding the same stream produces the same per-type counts.
+    sctp_decoder_t *dec = sctp_decoder_from_buffer(sctp_encoder_get_data(enc), sctp_encoder_get_size(enc));
+    while (sctp_decoder_next(dec) != SCTP_TYPE_EOF)
+        ;
+    assert_true(memcmp(&stats->decoded, &stats->encoded, sizeof(sctp_stats_counters_t)) == 0,
+                "Decoded counters differ from encoded counters");
+
+    // The streaming decoder counts each field once, including fields that cross chunk boundaries.
+    const sctp_stats_counters_t expected = stats->decoded;
+    sctp_stats_reset();
+    sctp_stream_decoder_t *sdec = sctp_stream_decoder_create();
+    const uint8_t *data = sctp_encoder_get_data(enc);
+    const size_t size = sctp_encoder_get_size(enc);
+    size_t offset = 0;
+    sctp_field_t field;
+    int status;
+    while ((status = sctp_stream_decoder_next(sdec, &field)) == SCTP_NEED_MORE ||
+           (status == SCTP_OK && field.type != SCTP_TYPE_EOF))
+    {
+        if (status == SCTP_NEED_MORE)
+        {
+            const size_t n = size - offset < 7 ? size - offset : 7;
+            sctp_stream_decoder_feed(sdec, data + offset, n);
+            offset += n;
+        }
+    }
+    sctp_stream_decoder_free(sdec);
+    assert_true(status == SCTP_OK && memcmp(&stats->decoded, &expected, sizeof(expected)) == 0,
+                "Streamed counters differ from decoded counters");
+
+    sctp_stats_reset();
+    assert_true(stats->encoded.fields[SCTP_TYPE_UINT32] == 0 && stats->capacity_high_water == 0,
+                "Reset did not clear counters");
+
+    sctp_encoder_free(enc);
+    printf("\n[OK] Statistics test passed\n");
+}
+#endif
+
 LEA_EXPORT(run_test) int run_test(void)
 {
     printf(">> Starting SCTP integration test...\n");
@@ -222,6 +2312,39 @@ LEA_EXPORT(run_test) int run_test(void)
     printf("\n[OK] TEST PASSED\n");
 
     test_raw_add();
+    test_encoder_instances();
+    test_encoder_growth();
+    test_size_helpers();
+    test_leb128_kernels();
+    test_fixed_width_fast_path();
+    test_batch_decode();
+#ifdef SCTP_CALLBACK_BATCH
+    test_run_batch();
+#endif
+    test_array_encoders();
+    test_packed_arrays();
+    test_skip_seek();
+    test_field_index();
+    test_stream_decoder();
+#ifdef SCTP_FLUSH_ENABLE
+    test_streaming_encoder();
+#endif
+    test_validation();
+    test_schema_codec();
+#ifdef SCTP_STATS
+    test_stats();
+#endif
+    test_scatter_gather();
+    test_arena();
+#ifdef SCTP_PARALLEL
+    test_parallel_decode();
+#endif
+    test_auto_width();
+    test_dictionary();
+    test_batch_container();
+    test_checksum();
+    test_canonical();
+    test_mark_rollback();
 
     printf("\n[OK] ALL TESTS PASSED\n");
     return 0;
@@ -0,0 +1,149 @@
+#include "sctp.hpp"
+#include <cstdio>
+#include <vector>
+
+/**
+ * @file test.cpp
+ * @brief Tests for the C++ layer in sctp.hpp, built natively by `make test-cpp-native`.
+ */
+
+static void assert_true(bool condition, const char* message)
+{
+    if (!condition)
+    {
+        std::printf("[FAIL] TEST FAILED: %s\n", message);
+        LEA_ABORT();
+    }
+}
+
+static void test_encode_matches_c()
+{
+    std::printf("\n--- 1. Testing typed encode against the C encoder ---\n");
+
+    std::vector<uint8_t> blob(300);
+    for (size_t i = 0; i < blob.size(); i++)
+        blob[i] = static_cast<uint8_t>(i * 7);
+    const uint32_t words[3] = {1, 0x10000, 0xFFFFFFFF};
+
+    sctp_encoder_t* expected = sctp_encoder_create(1024);
+    sctp_encoder_add_uint8_to(expected, 0xAB);
+    sctp_encoder_add_int64_to(expected, -1234567890123LL);
+    sctp_encoder_add_float64_to(expected, 2.5);
+    sctp_encoder_add_uleb128_to(expected, 300);
+    sctp_encoder_add_sleb128_to(expected, -65);
+    sctp_encoder_add_short_to(expected, 9);
+    sctp_encoder_add_vector_data_to(expected, blob.data(), 3);
+    sctp_encoder_add_vector_data_to(expected, blob.data(), blob.size());
+    sctp_encoder_add_packed_uint32_to(expected, words, 3);
+
+    sctp_encoder_t* enc = sctp_encoder_create(1024);
+    const int status = sctp::encode(enc, uint8_t{0xAB}, int64_t{-1234567890123LL}, 2.5, sctp::uleb128{300},
+                                    sctp::sleb128{-65}, sctp::short_field{9}, sctp::vec(blob.data(), 3),
+                                    sctp::vec(blob), sctp::packed<uint32_t>(words));
+    assert_true(status == SCTP_OK, "Typed encode failed");
+    assert_true(sctp_encoder_get_size(enc) == sctp_encoder_get_size(expected) &&
+                    std::memcmp(sctp_encoder_get_data(enc), sctp_encoder_get_data(expected),
+                                sctp_encoder_get_size(enc)) == 0,
+                "Typed encode differs from the C encoder");
+
+    // Sizes, including the compile-time constant for fixed-width sequences.
+    static_assert(sctp::fixed_size<uint32_t, double, int8_t> == 5 + 9 + 2);
+    static_assert(sctp::size(sctp::uleb128{127}, sctp::uleb128{128}, sctp::sleb128{-64}, sctp::sleb128{64}) ==
+                  2 + 3 + 2 + 3);
+    assert_true(sctp::size(sctp::vec(blob)) == sctp_size_vector(blob.size()), "Vector size mismatch");
+
+    // Errors leave the encoder untouched.
+    const size_t before = sctp_encoder_get_size(enc);
+    assert_true(sctp::encode(enc, uint32_t{1}, sctp::short_field{16}) == SCTP_ERR_INVALID_ARG, "Bad short accepted");
+    sctp_encoder_t* small = sctp_encoder_create(8);
+    assert_true(sctp::encode(small, uint32_t{1}, uint32_t{2}) == SCTP_ERR_NO_SPACE, "Overflow not reported");
+    assert_true(sctp_encoder_get_size(small) == 0 && sctp_encoder_get_size(enc) == before, "Partial write on error");
+
+    // Measuring encoders count, and caller buffers are filled directly.
+    sctp_encoder_t* measuring = sctp_encoder_create_measuring();
+    assert_true(sctp::encode(measuring, sctp::vec(blob), uint16_t{3}) == SCTP_OK &&
+                    sctp_encoder_get_size(measuring) == sctp_size_vector(blob.size()) + 3,
+                "Measuring encode mismatch");
+    uint8_t out[8];
+    assert_true(sctp::encode(std::span<uint8_t>(out), uint16_t{0x0102}, sctp::short_field{1}) == 4 &&
+                    out[0] == SCTP_TYPE_UINT16 && out[1] == 0x02 && out[3] == 0x1C,
+                "Buffer encode mismatch");
+    assert_true(sctp::encode(std::span<uint8_t>(out), uint64_t{1}) == 0, "Buffer overflow not reported");
+
+    sctp_encoder_free(measuring);
+    sctp_encoder_free(small);
+    sctp_encoder_free(enc);
+    sctp_encoder_free(expected);
+
+    std::printf("\n[OK] Typed encode test passed\n");
+}
+
+static void test_decode()
+{
+    std::printf("\n--- 2. Testing typed decode ---\n");
+
+    const uint8_t payload[20] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20};
+    const uint16_t words[4] = {10, 20, 30, 40};
+    sctp_encoder_t* enc = sctp_encoder_create(256);
+    sctp::encode(enc, uint64_t{42}, sctp::uleb128{1u << 20}, sctp::vec(payload), sctp::packed<uint16_t>(words),
+                 float{1.5f}, sctp::sleb128{-3}, sctp::short_field{15});
+    sctp_encoder_add_eof_to(enc);
+    const std::span<const uint8_t> message(sctp_encoder_get_data(enc), sctp_encoder_get_size(enc));
+
+    auto decoded =
+        sctp::decode<uint64_t, sctp::uleb128, sctp::vec, sctp::packed<uint16_t>, float, sctp::sleb128, sctp::short_field>(
+            message);
+    assert_true(decoded.has_value(), "Typed decode failed");
+    auto [nonce, fee, to, amounts, ratio, delta, flags] = *decoded;
+    assert_true(nonce == 42 && fee.value == 1u << 20 && ratio == 1.5f && delta.value == -3 && flags.value == 15,
+                "Decoded values mismatch");
+    assert_true(to.size() == 20 && to.data() == message.data() + 15 && to[19] == 20, "Vector is not a view");
+    assert_true(amounts.size() == 4 && amounts[0] == 10 && amounts[3] == 40, "Packed array mismatch");
+
+    // Wrong types, missing and extra fields are rejected.
+    assert_true(!sctp::decode<uint32_t, sctp::uleb128>(message), "Type mismatch accepted");
+    assert_true(!sctp::decode<uint64_t, sctp::uleb128>(message), "Trailing fields accepted");
+    assert_true(!sctp::decode<uint64_t>(message.first(5)), "Truncated field accepted");
+
+    // decode_into leaves the decoder after the fields, or at the offending one.
+    sctp_decoder_t dec;
+    sctp_decoder_bind(&dec, message.data(), message.size());
+    uint64_t first;
+    sctp::uleb128 second;
+    assert_true(sctp::decode_into(&dec, first, second) == SCTP_OK && dec.position == 9 + 4, "Prefix decode failed");
+    sctp::vec third;
+    float wrong;
+    assert_true(sctp::decode_into(&dec, third, wrong) == SCTP_ERR_TYPE_MISMATCH && dec.position == 15 + 20,
+                "Mismatch not reported at the offending field");
+    assert_true(sctp_decoder_next(&dec) == SCTP_TYPE_PACKED, "Decoder not usable after decode_into");
+
+    // A fixed-width run near the end of the input takes the checked path.
+    const auto tail = message.subspan(0, 8);
+    sctp_decoder_bind(&dec, tail.data(), tail.size());
+    assert_true(sctp::decode_into(&dec, first) == SCTP_ERR_TRUNCATED && dec.position == 0, "Short input accepted");
+
+    // Back-references from a dictionary encoder resolve to the earlier vector.
+    sctp_encoder_t* dict = sctp_encoder_create(256);
+    sctp_encoder_set_dictionary(dict, 16);
+    sctp_encoder_add_vector_data_to(dict, payload, sizeof(payload));
+    sctp::encode(dict, uint8_t{1});
+    sctp_encoder_add_vector_data_to(dict, payload, sizeof(payload));
+    const std::span<const uint8_t> deduplicated(sctp_encoder_get_data(dict), sctp_encoder_get_size(dict));
+    auto refs = sctp::decode<sctp::vec, uint8_t, sctp::vec>(deduplicated);
+    assert_true(deduplicated[24] == 0xDE, "Dictionary did not write a back-reference");
+    assert_true(refs && std::get<2>(*refs).data() == std::get<0>(*refs).data(), "Back-reference not resolved");
+
+    sctp_encoder_free(dict);
+    sctp_encoder_free(enc);
+
+    std::printf("\n[OK] Typed decode test passed\n");
+}
+
+int main()
+{
+    std::printf(">> Starting SCTP C++ test...\n");
+    test_encode_matches_c();
+    test_decode();
+    std::printf("\n[OK] ALL TESTS PASSED\n");
+    return 0;
+}